@@ -0,0 +1,484 @@
+#include "anytimehull.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include "predicates.h"
+
+using namespace std;
+
+namespace
+{
+    //points visited between looks at the clock
+    const size_t CheckEvery = 1024;
+
+    //relative to the extent of the points, far above what the rounding of a distance can reach
+    const double RoundingMargin = 1e-9;
+
+    const double Pi = 3.14159265358979323846;
+
+    bool Less(const Point2D& a, const Point2D& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+
+    //exact sign of d . (p - q): > 0 if p lies farther in direction d
+    double Further(const Point2D& d, const Point2D& p, const Point2D& q)
+    {
+        return Predicates::DifferenceProducts(d.x, 0, p.x, q.x, 0, d.y, p.y, q.y);
+    }
+
+    double SegmentDistance(const Point2D& p, const Point2D& a, const Point2D& b)
+    {
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double length2 = dx * dx + dy * dy;
+        double t = length2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length2 : 0;
+        t = min(1.0, max(0.0, t));
+        return hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+    }
+
+    //distance of a point outside a convex polygon (or on it) from the polygon
+    double PolygonDistance(const Point2D& p, const vector<Point2D>& polygon)
+    {
+        if (polygon.size() == 1)
+        {
+            return hypot(p.x - polygon[0].x, p.y - polygon[0].y);
+        }
+        double distance = numeric_limits<double>::infinity();
+        for (size_t i = 0; i < polygon.size(); i++)
+        {
+            distance = min(distance, SegmentDistance(p, polygon[i], polygon[(i + 1) % polygon.size()]));
+        }
+        return distance;
+    }
+}
+
+AnytimeHull::AnytimeHull(unsigned k) : phase(Phase::Done), cursor(0), work(0), reach(0), cornerBound(0),
+    filter(0), splitting(false), split(), m1(0), m2(0), hullValid(false)
+{
+    k = (min(max(k, 4u), 64u) + 3) / 4 * 4;
+    //counter-clockwise from -x, so the extremes come in hull order from the left most point;
+    //the axes are exact, the rest only need to be some fixed direction
+    for (unsigned j = 0; j < k; j++)
+    {
+        const unsigned quarter = k / 4;
+        const Point2D axes[4] = { { -1, 0 }, { 0, -1 }, { 1, 0 }, { 0, 1 } };
+        if (j % quarter == 0)
+        {
+            directions.push_back(axes[j / quarter]);
+        }
+        else
+        {
+            const double angle = Pi + 2 * Pi * j / k;
+            directions.push_back(Point2D{ cos(angle), sin(angle) });
+        }
+    }
+}
+
+void AnytimeHull::Reset(const Point2D* input, size_t count)
+{
+    points.assign(input, input + count);
+    phase = count ? Phase::Scan : Phase::Done;
+    cursor = 0;
+    work = 0;
+    reach = 0;
+    extremes.assign(directions.size(), None);
+    extremeDot.assign(directions.size(), 0);
+    cornerBound = 0;
+    vertices.clear();
+    buckets.clear();
+    bucketFar.clear();
+    index.clear();
+    tasks = priority_queue<Task>();
+    splitting = false;
+    hull.clear();
+    hullValid = false;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   AnytimeHull::Refine
+
+  Summary:  Goes on from where the last call stopped, a point at a
+            time, looking at the clock every CheckEvery points. Every
+            call does some work, however short the budget.
+
+  Args:     Clock::time_point deadline
+              when to stop
+            size_t maxWork
+              most points to visit in this call
+
+  Modifies: [everything but directions and points].
+
+  Returns:  bool
+              true once the hull is exact
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool AnytimeHull::Refine(Clock::time_point deadline, size_t maxWork)
+{
+    HULL_SCOPE("AnytimeHull::Refine");
+    const size_t workEnd = maxWork > SIZE_MAX - work ? SIZE_MAX : work + maxWork;
+    bool first = true;
+    while (phase != Phase::Done)
+    {
+        if (!first && (work >= workEnd || Clock::now() >= deadline))
+        {
+            break;
+        }
+        first = false;
+        Step(max<size_t>(1, min(workEnd - work, CheckEvery)));
+    }
+    return Done();
+}
+
+void AnytimeHull::Step(size_t allowance)
+{
+    hullValid = false;
+    switch (phase)
+    {
+    case Phase::Scan:
+        Scan(allowance);
+        break;
+    case Phase::Partition:
+        Partition(allowance);
+        break;
+    case Phase::Split:
+        Split(allowance);
+        break;
+    case Phase::Done:
+        break;
+    }
+}
+
+//ties go to the lexicographically lower point on the lower half of the turn and the higher one
+//on the upper half, an end of the tied run either way, so the left most point is QuickHull's
+void AnytimeHull::Scan(size_t allowance)
+{
+    const Point2D& origin = points[0];
+    const size_t end = min(points.size(), cursor + allowance);
+    const size_t half = directions.size() / 2;
+    work += end - cursor;
+    for (; cursor < end; cursor++)
+    {
+        const Point2D& p = points[cursor];
+        reach = max(reach, max(fabs(p.x - origin.x), fabs(p.y - origin.y)));
+        //both rounded dot products are within 6 eps reach of the exact ones
+        const double margin = 16 * DBL_EPSILON * reach;
+        for (size_t j = 0; j < directions.size(); j++)
+        {
+            const Point2D& d = directions[j];
+            const double dot = d.x * (p.x - origin.x) + d.y * (p.y - origin.y);
+            if (extremes[j] != None)
+            {
+                if (dot < extremeDot[j] - margin)
+                {
+                    continue;
+                }
+                const Point2D& q = points[extremes[j]];
+                const double further = Further(d, p, q);
+                if (further < 0 || (further == 0 && (j < half ? !Less(p, q) : !Less(q, p))))
+                {
+                    continue;
+                }
+            }
+            extremes[j] = (uint32_t)cursor;
+            extremeDot[j] = dot;
+        }
+    }
+    if (cursor == points.size())
+    {
+        StartPartition();
+    }
+}
+
+//the hull of the extremes, counter-clockwise from the left most, without collinear vertices
+void AnytimeHull::ExtremeHull(vector<Point2D>& out) const
+{
+    vector<Point2D> sorted;
+    for (uint32_t e : extremes)
+    {
+        if (e != None)
+        {
+            sorted.push_back(points[e]);
+        }
+    }
+    sort(sorted.begin(), sorted.end(), Less);
+    sorted.erase(unique(sorted.begin(), sorted.end(),
+        [](const Point2D& a, const Point2D& b) { return a.x == b.x && a.y == b.y; }), sorted.end());
+    out.clear();
+    if (sorted.size() < 3)
+    {
+        out = sorted;
+        return;
+    }
+    //monotone chain: lower hull left to right, then upper hull back
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const size_t start = out.size();
+        for (size_t i = 0; i < sorted.size(); i++)
+        {
+            const Point2D& p = pass == 0 ? sorted[i] : sorted[sorted.size() - 1 - i];
+            while (out.size() >= start + 2 && Orientation(out[out.size() - 2], out.back(), p) <= 0)
+            {
+                out.pop_back();
+            }
+            out.push_back(p);
+        }
+        out.pop_back();
+    }
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   AnytimeHull::StartPartition
+
+  Summary:  Turns the extremes into the first hull vertices and bounds
+            the error of their polygon. Every point lies inside the k
+            support lines, so within the polygon they enclose, and the
+            distance from the k-gon is largest at one of its corners.
+
+  Modifies: [vertices, buckets, bucketFar, cornerBound, cursor, phase].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void AnytimeHull::StartPartition()
+{
+    vector<Point2D> polygon;
+    ExtremeHull(polygon);
+    //map the polygon back to point indices through the extremes
+    for (const Point2D& v : polygon)
+    {
+        for (uint32_t e : extremes)
+        {
+            if (points[e].x == v.x && points[e].y == v.y)
+            {
+                vertices.push_back(Vertex{ e, (uint32_t)(vertices.size() + 1) });
+                break;
+            }
+        }
+    }
+    vertices.back().next = 0;
+
+    const Point2D& origin = points[0];
+    const size_t k = directions.size();
+    cornerBound = 0;
+    for (size_t j = 0; j < k; j++)
+    {
+        const Point2D& d = directions[j];
+        const Point2D& e = directions[(j + 1) % k];
+        const double h = d.x * (points[extremes[j]].x - origin.x) + d.y * (points[extremes[j]].y - origin.y);
+        const double g = e.x * (points[extremes[(j + 1) % k]].x - origin.x) + e.y * (points[extremes[(j + 1) % k]].y - origin.y);
+        const double det = d.x * e.y - d.y * e.x;
+        const Point2D corner = { origin.x + (h * e.y - g * d.y) / det, origin.y + (d.x * g - e.x * h) / det };
+        cornerBound = max(cornerBound, PolygonDistance(corner, polygon));
+    }
+
+    //the bounding box is at most twice reach on a side
+    filter = OrientFilter(2 * reach);
+    const size_t edges = vertices.size() < 2 ? 0 : vertices.size();
+    buckets.assign(edges, vector<uint32_t>());
+    bucketFar.assign(edges, Farthest());
+    cursor = 0;
+    phase = Phase::Partition;
+}
+
+void AnytimeHull::Partition(size_t allowance)
+{
+    const size_t end = min(points.size(), cursor + allowance);
+    work += end - cursor;
+    for (; cursor < end; cursor++)
+    {
+        const Point2D& p = points[cursor];
+        for (size_t v = 0; v < buckets.size(); v++)
+        {
+            const Point2D& a = points[vertices[v].point];
+            const Point2D& b = points[vertices[vertices[v].next].point];
+            if (filter.Orient2D(a.x, a.y, b.x, b.y, p.x, p.y) < 0)
+            {
+                buckets[v].push_back((uint32_t)cursor);
+                Consider(bucketFar[v], a, b, (uint32_t)cursor);
+                break;
+            }
+        }
+    }
+    if (cursor == points.size())
+    {
+        StartSplits();
+    }
+}
+
+//lays the buckets out in one index array, QuickHull's, and queues them as tasks
+void AnytimeHull::StartSplits()
+{
+    for (size_t v = 0; v < buckets.size(); v++)
+    {
+        if (!buckets[v].empty())
+        {
+            const size_t lo = index.size();
+            index.insert(index.end(), buckets[v].begin(), buckets[v].end());
+            tasks.push(Task{ (uint32_t)v, lo, index.size(), bucketFar[v].point, bucketFar[v].error });
+        }
+    }
+    buckets.clear();
+    bucketFar.clear();
+    phase = tasks.empty() ? Phase::Done : Phase::Split;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   AnytimeHull::Split
+
+  Summary:  QuickHull's step on the task with the largest error: its
+            farthest point becomes a vertex between a and b, and its
+            points are partitioned in place, in one pass that can stop
+            anywhere, into those outside a->far, those outside far->b,
+            and the rest, which are inside and dropped. The vertex is
+            only linked in once the pass is over.
+
+  Modifies: [tasks, index, vertices, split state, phase].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void AnytimeHull::Split(size_t allowance)
+{
+    if (!splitting)
+    {
+        split = tasks.top();
+        tasks.pop();
+        m1 = m2 = cursor = split.lo;
+        farA = Farthest();
+        farB = Farthest();
+        splitting = true;
+    }
+    const Point2D& a = points[vertices[split.vertex].point];
+    const Point2D& b = points[vertices[vertices[split.vertex].next].point];
+    const Point2D& c = points[split.far];
+
+    const size_t end = min(split.hi, cursor + allowance);
+    work += end - cursor;
+    for (; cursor < end; cursor++)
+    {
+        const uint32_t i = index[cursor];
+        const Point2D& p = points[i];
+        if (i == split.far)
+        {
+            continue;
+        }
+        if (filter.Orient2D(a.x, a.y, c.x, c.y, p.x, p.y) < 0)
+        {
+            //rotate into [lo, m1), moving the first of each later group up
+            index[cursor] = index[m2];
+            index[m2++] = index[m1];
+            index[m1++] = i;
+            Consider(farA, a, c, i);
+        }
+        else if (filter.Orient2D(c.x, c.y, b.x, b.y, p.x, p.y) < 0)
+        {
+            swap(index[cursor], index[m2++]);
+            Consider(farB, c, b, i);
+        }
+    }
+    if (cursor < split.hi)
+    {
+        return;
+    }
+
+    const uint32_t vc = (uint32_t)vertices.size();
+    vertices.push_back(Vertex{ split.far, vertices[split.vertex].next });
+    vertices[split.vertex].next = vc;
+    if (m1 > split.lo)
+    {
+        tasks.push(Task{ split.vertex, split.lo, m1, farA.point, farA.error });
+    }
+    if (m2 > m1)
+    {
+        tasks.push(Task{ vc, m1, m2, farB.point, farB.error });
+    }
+    splitting = false;
+    if (tasks.empty())
+    {
+        phase = Phase::Done;
+    }
+}
+
+//as QuickHull: the farthest from the line a->b, on ties the one nearest a along it
+void AnytimeHull::Consider(Farthest& farthest, const Point2D& a, const Point2D& b, uint32_t i) const
+{
+    const Point2D& p = points[i];
+    farthest.error = max(farthest.error, SegmentDistance(p, a, b));
+    if (farthest.point == None)
+    {
+        farthest.point = i;
+        return;
+    }
+    const Point2D& q = points[farthest.point];
+    //the points are right of a->b, so the farther one has the more negative cross product
+    const double compare = filter.CrossDifference(a.x, a.y, b.x, b.y, p.x, p.y, q.x, q.y);
+    if (compare > 0)
+    {
+        return;
+    }
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    if (compare < 0 || (p.x - a.x) * dx + (p.y - a.y) * dy < (q.x - a.x) * dx + (q.y - a.y) * dy)
+    {
+        farthest.point = i;
+    }
+}
+
+const vector<Point2D>& AnytimeHull::Hull()
+{
+    if (hullValid)
+    {
+        return hull;
+    }
+    hull.clear();
+    if (phase == Phase::Scan)
+    {
+        ExtremeHull(hull);
+    }
+    else if (!vertices.empty())
+    {
+        uint32_t v = 0;
+        do
+        {
+            hull.push_back(points[vertices[v].point]);
+            v = vertices[v].next;
+        } while (v != 0);
+    }
+    hullValid = true;
+    return hull;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   AnytimeHull::ErrorBound
+
+  Summary:  Largest distance from Hull() of a point of the true hull:
+            infinite until the scan is over, the corner bound of the
+            k-gon while partitioning, then the larger of the task
+            errors left, never more than the corner bound. A margin
+            covers the rounding of the distances.
+
+  Returns:  double
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+double AnytimeHull::ErrorBound() const
+{
+    switch (phase)
+    {
+    case Phase::Scan:
+        return numeric_limits<double>::infinity();
+    case Phase::Partition:
+        return cornerBound + RoundingMargin * reach;
+    case Phase::Split:
+    {
+        double error = splitting ? split.error : 0;
+        if (!tasks.empty())
+        {
+            error = max(error, tasks.top().error);
+        }
+        return min(error, cornerBound) + RoundingMargin * reach;
+    }
+    case Phase::Done:
+        break;
+    }
+    return 0;
+}
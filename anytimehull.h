@@ -0,0 +1,147 @@
+#ifndef _ANYTIMEHULL_H
+#define _ANYTIMEHULL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "geometry.h"
+#include "predicates.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    AnytimeHull
+
+  Summary:  Convex hull computed in slices of a time or work budget,
+            for callers that would rather have a slightly small hull
+            now than the exact one late. Between slices Hull() is an
+            inner approximation, the hull of some of the points (some
+            of the true hull's vertices, once the first pass is over),
+            and ErrorBound() bounds its Hausdorff distance from the
+            true hull. Refine picks up where the last slice
+            stopped, so a frame loop can keep improving it.
+
+            The work is QuickHull's, reordered:
+              - Scan: the pass that finds QuickHull's left and right
+                most points finds the extreme points in k directions
+                instead (exact comparisons, so each is a hull vertex).
+                Until it completes the hull is that of the extremes so
+                far and the bound is infinite; once it does, every point
+                lies inside the k support lines, whose corners bound the
+                error of the k-gon.
+              - Partition: every point outside the k-gon is given to
+                the first edge it lies outside of, as QuickHull splits
+                on left->right.
+              - Split: QuickHull's tasks, but the edge whose points lie
+                farthest from it goes first, rather than the one on top
+                of a stack. A task's error is the largest distance of
+                one of its points from its edge, so the largest among
+                the tasks left is the Hausdorff distance, up to a margin
+                for rounding.
+            Each phase goes a point at a time, so a slice can end in
+            the middle of any of them, a split included. Once done, the
+            hull is exactly QuickHull's.
+
+  Methods:  Reset
+              Copies the points and starts over.
+            Refine
+              Works until done, the deadline, or maxWork points visited.
+            Hull
+              Vertices found so far, counter-clockwise from the left
+              most point.
+            ErrorBound
+              Largest distance of a true hull point from Hull().
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class AnytimeHull
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    //directions is rounded up to a multiple of 4, between 4 and 64
+    explicit AnytimeHull(unsigned directions = 8);
+
+    void Reset(const Point2D* points, size_t count);
+    void Reset(const std::vector<Point2D>& points) { Reset(points.data(), points.size()); }
+
+    bool Refine(Clock::time_point deadline, size_t maxWork = SIZE_MAX);
+    bool RefineFor(Clock::duration budget) { return Refine(Clock::now() + budget); }
+
+    const std::vector<Point2D>& Hull();
+    double ErrorBound() const;
+
+    bool   Done() const { return phase == Phase::Done; }
+    size_t Work() const { return work; }
+    size_t Size() const { return points.size(); }
+
+private:
+    enum class Phase { Scan, Partition, Split, Done };
+
+    enum : uint32_t { None = 0xFFFFFFFFu };
+
+    //hull vertices found so far, a circular list in hull order
+    struct Vertex
+    {
+        uint32_t point;
+        uint32_t next;
+    };
+
+    //points outside an edge: the farthest from its line, and the largest distance from the edge
+    struct Farthest
+    {
+        uint32_t point = None;
+        double   error = 0;
+    };
+
+    //index[lo, hi) lie outside the edge from vertex to its next; far splits it
+    struct Task
+    {
+        uint32_t vertex;
+        size_t   lo;
+        size_t   hi;
+        uint32_t far;
+        double   error;
+
+        bool operator<(const Task& other) const { return error < other.error; }
+    };
+
+    void Step(size_t allowance);
+    void Scan(size_t allowance);
+    void StartPartition();
+    void Partition(size_t allowance);
+    void StartSplits();
+    void Split(size_t allowance);
+    void Consider(Farthest& farthest, const Point2D& a, const Point2D& b, uint32_t i) const;
+    void ExtremeHull(std::vector<Point2D>& hull) const;
+
+    std::vector<Point2D>        directions;
+    std::vector<Point2D>        points;
+    Phase                       phase;
+    size_t                      cursor;     // next point of Scan or Partition
+    size_t                      work;
+    double                      reach;      // largest coordinate distance from points[0], for the rounding margin
+
+    std::vector<uint32_t>       extremes;   // per direction
+    std::vector<double>         extremeDot; // their rounded offsets along it, to skip the exact test
+    double                      cornerBound;
+    OrientFilter                filter;     // for the points, once their extent is known
+
+    std::vector<Vertex>         vertices;
+    std::vector<std::vector<uint32_t>> buckets;    // per k-gon edge, while partitioning
+    std::vector<Farthest>       bucketFar;
+    std::vector<uint32_t>       index;
+    std::priority_queue<Task>   tasks;
+
+    //the split in progress: index[lo, m1) outside a->far, [m1, m2) outside far->b
+    bool                        splitting;
+    Task                        split;
+    size_t                      m1;
+    size_t                      m2;
+    Farthest                    farA;
+    Farthest                    farB;
+
+    std::vector<Point2D>        hull;
+    bool                        hullValid;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "arena.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   Arena::AllocateSlow
+
+  Summary:  The current block is full. Moves on to the next block kept
+            from an earlier round that has room, and only when none
+            does takes a new one from the heap, at least twice the
+            size of the last so a growing computation needs few of
+            them.
+
+  Args:     size_t size
+              bytes wanted
+            size_t alignment
+              power of two alignment of the allocation
+
+  Modifies: [blocks, current, offset].
+
+  Returns:  void*
+              the allocation
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M*/
+void* Arena::AllocateSlow(size_t size, size_t alignment)
+{
+    for (size_t next = blocks.empty() ? 0 : current + 1; next < blocks.size(); next++)
+    {
+        current = next;
+        offset = 0;
+        if (void* p = Bump(size, alignment))
+        {
+            return p;
+        }
+    }
+
+    HULL_COUNT(ArenaBlocks, 1);
+    const size_t grown = blocks.empty() ? blockSize : blocks.back().size * 2;
+    Block block;
+    block.size = max(grown, size + alignment);
+    block.data.reset(new uint8_t[block.size]);
+    blocks.push_back(move(block));
+    current = blocks.size() - 1;
+    offset = 0;
+    return Bump(size, alignment);
+}
+
+size_t Arena::BytesInUse() const
+{
+    size_t bytes = offset;
+    for (size_t i = 0; i < current && i < blocks.size(); i++)
+    {
+        bytes += blocks[i].size;
+    }
+    return bytes;
+}
+
+size_t Arena::Capacity() const
+{
+    size_t bytes = 0;
+    for (const Block& block : blocks)
+    {
+        bytes += block.size;
+    }
+    return bytes;
+}
@@ -0,0 +1,165 @@
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "instrument.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    Arena
+
+  Summary:  Bump allocator for temporaries that all die together, such
+            as the scratch of one hull computation or everything one
+            frame builds. Allocating is an aligned pointer bump;
+            nothing is freed on its own. Reset() (or Rewind() to a
+            Mark()) releases everything allocated since, in O(1).
+            Blocks taken from the heap are kept and reused, so once an
+            arena has grown to a computation's peak the computation
+            makes no heap allocations at all.
+
+            Objects placed in an arena are not destroyed by it; keep
+            to trivially destructible data, or destroy them before the
+            arena is rewound.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class Arena
+{
+public:
+    struct Marker
+    {
+        size_t block;
+        size_t offset;
+    };
+
+    static const size_t DefaultBlockSize = 64 * 1024;
+
+    //no memory is taken until the first allocation
+    explicit Arena(size_t blockSize = DefaultBlockSize) : current(0), offset(0), blockSize(blockSize) { }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        HULL_COUNT(ArenaAllocations, 1);
+        HULL_COUNT(ArenaBytes, size);
+        void* p = Bump(size, alignment);
+        return p ? p : AllocateSlow(size, alignment);
+    }
+
+    //uninitialized room for count values of T
+    template <class T>
+    T* Allocate(size_t count)
+    {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    //gives back the tail of the last allocation; a no-op for any other allocation
+    void Shrink(void* p, size_t size, size_t newSize)
+    {
+        if (current < blocks.size() && (uint8_t*)p + size == blocks[current].data.get() + offset)
+        {
+            offset -= size - newSize;
+        }
+    }
+
+    Marker Mark() const { return Marker{ current, offset }; }
+    void   Rewind(const Marker& marker) { current = marker.block; offset = marker.offset; }
+    void   Reset() { current = 0; offset = 0; }
+
+    size_t BytesInUse() const;
+    size_t Capacity() const;
+    size_t BlockCount() const { return blocks.size(); }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t                     size;
+    };
+
+    //the allocation from the current block, null if it does not fit
+    void* Bump(size_t size, size_t alignment)
+    {
+        if (current < blocks.size())
+        {
+            const uintptr_t base = (uintptr_t)blocks[current].data.get();
+            const size_t aligned = (size_t)(((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+            if (aligned + size <= blocks[current].size)
+            {
+                offset = aligned + size;
+                return (void*)(base + aligned);
+            }
+        }
+        return nullptr;
+    }
+
+    void* AllocateSlow(size_t size, size_t alignment);
+
+    std::vector<Block> blocks;
+    size_t             current;
+    size_t             offset;
+    size_t             blockSize;
+};
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    ArenaScope
+
+  Summary:  Rewinds an arena to where it was when the scope was entered,
+            so a routine's scratch is released when it returns however
+            deeply scopes are nested.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class ArenaScope
+{
+public:
+    explicit ArenaScope(Arena& arena) : arena(arena), marker(arena.Mark()) { }
+    ~ArenaScope() { arena.Rewind(marker); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena&        arena;
+    Arena::Marker marker;
+};
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    ArenaAllocator
+
+  Summary:  Standard allocator over an Arena, for containers and
+            allocate_shared. Deallocation only gives memory back when
+            it was the last allocation (a vector growing by itself);
+            the rest waits for the arena to be rewound.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+template <class T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(Arena& arena) : arena(&arena) { }
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) { }
+
+    T*   allocate(size_t count) { return arena->Allocate<T>(count); }
+    void deallocate(T* p, size_t count) { arena->Shrink(p, count * sizeof(T), 0); }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <class U> friend class ArenaAllocator;
+
+    Arena* arena;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,330 @@
+#include "batchhull.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "arena.h"
+
+using namespace std;
+
+namespace
+{
+    //sets up to this size take the sorting network, larger ones QuickHull
+    const size_t SmallSet = 64;
+
+    /*----------------------------------------------------------------
+        Sort keys are doubles (every T converts exactly): x with the
+        point's position in the set in the low six bits of the
+        mantissa. Their order is that of x except between x values
+        that agree in all but those bits, so the network can sort
+        plain doubles with min and max, and one insertion pass over
+        the exact coordinates afterwards, nearly always free, puts the
+        rare near ties in (x, y) order. Coordinates must be finite.
+    ----------------------------------------------------------------*/
+    inline double KeyOf(double x, size_t position)
+    {
+        uint64_t bits;
+        memcpy(&bits, &x, sizeof bits);
+        bits = (bits & ~(uint64_t)(SmallSet - 1)) | position;
+        memcpy(&x, &bits, sizeof bits);
+        return x;
+    }
+
+    inline size_t PositionOf(double key)
+    {
+        uint64_t bits;
+        memcpy(&bits, &key, sizeof bits);
+        return (size_t)(bits & (SmallSet - 1));
+    }
+
+    /*----------------------------------------------------------------
+        Bitonic sorting network over exactly N keys. The sequence of
+        compare-exchanges does not depend on the data, so there is
+        nothing to mispredict: every exchange is a min and a max, and
+        the runs of exchanges j apart are independent, so the compiler
+        is free to unroll and vectorize them.
+    ----------------------------------------------------------------*/
+    template <size_t N>
+    void SortingNetwork(double* keys)
+    {
+        for (size_t k = 2; k <= N; k *= 2)
+        {
+            for (size_t j = k / 2; j > 0; j /= 2)
+            {
+                for (size_t block = 0; block < N; block += 2 * j)
+                {
+                    //ascending in the first half of every run of 2k keys, descending in the second
+                    const bool up = (block & k) == 0;
+                    for (size_t i = block; i < block + j; i++)
+                    {
+                        const double a = keys[i];
+                        const double b = keys[i + j];
+                        keys[i] = up ? min(a, b) : max(a, b);
+                        keys[i + j] = up ? max(a, b) : min(a, b);
+                    }
+                }
+            }
+        }
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: SmallHull
+
+        Summary:  Hull of one set of at most SmallSet points, all on the
+                  stack. Points certainly inside the quadrilateral of
+                  the set's lowest, right most, highest and left most
+                  points are dropped first, often half the set, so the
+                  network that sorts the rest is narrower. Andrew's
+                  monotone chain then sweeps the sorted points: the
+                  lower hull left to right over the points below the
+                  line from the left most to the right most point, the
+                  upper hull back over those above it, popping every
+                  vertex that does not turn left so collinear and
+                  repeated points drop out. Turns go through the
+                  semi-static filter of the set and are exact.
+
+        Args:     const Point2<T>* points
+                    the packed points
+                  uint32_t first, size_t count
+                    the set, points[first, first + count), count > 0
+                  uint32_t* hull
+                    receives the hull, room for count indices
+
+        Returns:  size_t
+                    number of hull vertices
+    -----------------------------------------------------------------F-F*/
+    template <class T>
+    size_t SmallHull(const Point2<T>* points, uint32_t first, size_t count, uint32_t* hull)
+    {
+        const Point2<T>* set = points + first;
+        size_t west = 0;
+        size_t east = 0;
+        size_t south = 0;
+        size_t north = 0;
+        for (size_t i = 1; i < count; i++)
+        {
+            west = set[i].x < set[west].x ? i : west;
+            east = set[i].x > set[east].x ? i : east;
+            south = set[i].y < set[south].y ? i : south;
+            north = set[i].y > set[north].y ? i : north;
+        }
+        //every turn below is of points in this box, so one filter serves them all
+        const OrientFilter filter(max((double)set[east].x - set[west].x, (double)set[north].y - set[south].y));
+        auto turn = [&](const Point2<T>& a, const Point2<T>& b, const Point2<T>& c)
+        {
+            const double d = (double)Cross(a, b, c);
+            return filter.Certain(d) ? (d > 0) - (d < 0) : Orientation(a, b, c);
+        };
+
+        //branch free: a dropped point's key is overwritten by the next one
+        const Point2<T> s = set[south];
+        const Point2<T> e = set[east];
+        const Point2<T> n = set[north];
+        const Point2<T> w = set[west];
+        auto inside = [&](double d) { return (d > 0) & filter.Certain(d); };
+        double keys[SmallSet];
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const Point2<T> p = set[i];
+            const bool drop = inside((double)Cross(s, e, p)) & inside((double)Cross(e, n, p))
+                & inside((double)Cross(n, w, p)) & inside((double)Cross(w, s, p));
+            keys[kept] = KeyOf((double)p.x, i);
+            kept += !drop;
+        }
+        //never taken, the four extremes lie on the quadrilateral and stay
+        if (kept == 0)
+        {
+            return 0;
+        }
+        count = kept;
+
+        size_t width = 8;
+        while (width < count)
+        {
+            width *= 2;
+        }
+        fill(keys + count, keys + width, KeyOf(numeric_limits<double>::max(), SmallSet - 1));
+        switch (width)
+        {
+        case 8: SortingNetwork<8>(keys); break;
+        case 16: SortingNetwork<16>(keys); break;
+        case 32: SortingNetwork<32>(keys); break;
+        default: SortingNetwork<64>(keys); break;
+        }
+
+        Point2<T> sorted[SmallSet];
+        uint32_t index[SmallSet];
+        for (size_t i = 0; i < count; i++)
+        {
+            const size_t p = PositionOf(keys[i]);
+            sorted[i] = set[p];
+            index[i] = (uint32_t)(first + p);
+        }
+        for (size_t i = 1; i < count; i++)
+        {
+            for (size_t m = i; m > 0 && (sorted[m].x < sorted[m - 1].x
+                || (sorted[m].x == sorted[m - 1].x && sorted[m].y < sorted[m - 1].y)); m--)
+            {
+                swap(sorted[m], sorted[m - 1]);
+                swap(index[m], index[m - 1]);
+            }
+        }
+        const Point2<T> left = sorted[0];
+        const Point2<T> right = sorted[count - 1];
+        if (left.x == right.x && left.y == right.y)
+        {
+            hull[0] = index[0];
+            return 1;
+        }
+
+        //positions in sorted: the lower chain ends on right, the upper one on left
+        uint8_t below[SmallSet];
+        uint8_t above[SmallSet];
+        size_t belowCount = 0;
+        size_t aboveCount = 1;
+        above[0] = 0;
+        for (size_t i = 1; i + 1 < count; i++)
+        {
+            const int side = turn(left, right, sorted[i]);
+            below[belowCount] = (uint8_t)i;
+            belowCount += side < 0;
+            above[aboveCount] = (uint8_t)i;
+            aboveCount += side > 0;
+        }
+        below[belowCount++] = (uint8_t)(count - 1);
+
+        //the chain closes on its first point, one past the hull
+        uint8_t chain[SmallSet + 1];
+        size_t size = 1;
+        chain[0] = 0;
+        for (size_t k = 0; k < belowCount; k++)
+        {
+            while (size >= 2 && turn(sorted[chain[size - 2]], sorted[chain[size - 1]], sorted[below[k]]) <= 0)
+            {
+                size--;
+            }
+            chain[size++] = below[k];
+        }
+        const size_t lower = size + 1;
+        for (size_t k = aboveCount; k-- > 0;)
+        {
+            while (size >= lower && turn(sorted[chain[size - 2]], sorted[chain[size - 1]], sorted[above[k]]) <= 0)
+            {
+                size--;
+            }
+            chain[size++] = above[k];
+        }
+        size--;
+        for (size_t i = 0; i < size; i++)
+        {
+            hull[i] = index[chain[i]];
+        }
+        return size;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: BatchHulls
+
+    Summary:  Hulls every set of a CSR batch. Each thread takes a
+              contiguous run of sets holding about the same number of
+              points and writes each hull over the set's own slots in
+              hulls.indices (a hull is never longer than its set), with
+              its length in hulls.offsets; one serial pass then packs
+              the hulls together and turns the lengths into offsets.
+              Reusing hulls across frames makes no allocation once it
+              has grown.
+
+    Args:     const Point2<T>* points
+                the packed points of every set
+              const uint32_t* offsets
+                setCount + 1 non decreasing offsets into points
+              size_t setCount
+                number of sets
+              HullBatch& hulls
+                receives the hulls
+              unsigned threads
+                worker count, 0 = hardware concurrency
+
+    Modifies: [hulls].
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+template <class T>
+void BatchHulls(const Point2<T>* points, const uint32_t* offsets, size_t setCount, HullBatch& hulls, unsigned threads)
+{
+    HULL_SCOPE("BatchHulls");
+    hulls.offsets.assign(setCount + 1, 0);
+    hulls.indices.resize(setCount ? offsets[setCount] : 0);
+    if (setCount == 0)
+    {
+        return;
+    }
+
+    //ranges smaller than this are not worth a thread
+    const size_t minRange = 1 << 16;
+    const size_t total = offsets[setCount] - offsets[0];
+    unsigned threadCount = threads ? threads : thread::hardware_concurrency();
+    threadCount = (unsigned)max<size_t>(1, min<size_t>(max(threadCount, 1u), total / minRange));
+
+    auto worker = [&](unsigned id)
+    {
+        const uint32_t* end = offsets + setCount;
+        const size_t begin = lower_bound(offsets, end, offsets[0] + total * id / threadCount) - offsets;
+        const size_t last = lower_bound(offsets, end, offsets[0] + total * (id + 1) / threadCount) - offsets;
+        Arena scratch;
+        vector<uint32_t> large;
+        for (size_t s = begin; s < (id + 1 == threadCount ? setCount : last); s++)
+        {
+            const uint32_t first = offsets[s];
+            const size_t count = offsets[s + 1] - first;
+            uint32_t* hull = hulls.indices.data() + first;
+            if (count == 0)
+            {
+                continue;
+            }
+            if (count <= SmallSet)
+            {
+                hulls.offsets[s + 1] = (uint32_t)SmallHull(points, first, count, hull);
+                continue;
+            }
+            QuickHull(points + first, count, large, scratch);
+            for (size_t i = 0; i < large.size(); i++)
+            {
+                hull[i] = large[i] + first;
+            }
+            hulls.offsets[s + 1] = (uint32_t)large.size();
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& t : pool)
+    {
+        t.join();
+    }
+
+    //packing only ever moves a hull towards the front, so copy is safe
+    uint32_t packed = 0;
+    for (size_t s = 0; s < setCount; s++)
+    {
+        const uint32_t length = hulls.offsets[s + 1];
+        const uint32_t* hull = hulls.indices.data() + offsets[s];
+        copy(hull, hull + length, hulls.indices.data() + packed);
+        hulls.offsets[s] = packed;
+        packed += length;
+    }
+    hulls.offsets[setCount] = packed;
+    hulls.indices.resize(packed);
+}
+
+template void BatchHulls<float>(const Point2F*, const uint32_t*, size_t, HullBatch&, unsigned);
+template void BatchHulls<double>(const Point2D*, const uint32_t*, size_t, HullBatch&, unsigned);
+template void BatchHulls<int32_t>(const Point2I*, const uint32_t*, size_t, HullBatch&, unsigned);
@@ -0,0 +1,37 @@
+#ifndef _BATCHHULL_H
+#define _BATCHHULL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Hulls of many small point sets at once, such as one per object in
+    a frame. Sets are passed CSR style: their points packed back to
+    back in one array, and setCount + 1 offsets, so set i is
+    points[offsets[i], offsets[i + 1]). The hulls come back the same
+    way, as indices into the packed points, each one counter-clockwise
+    from its left most point without collinear vertices, like
+    QuickHull's.
+
+    Sets of up to 64 points are sorted with a fixed size sorting
+    network and hulled with Andrew's monotone chain on the stack, so
+    they cost no allocation and no recursion; larger sets go through
+    QuickHull. The sets are split across threads by point count.
+--------------------------------------------------------------------*/
+
+struct HullBatch
+{
+    std::vector<uint32_t> offsets;      // hull i is indices[offsets[i], offsets[i + 1])
+    std::vector<uint32_t> indices;      // indices into the packed points
+
+    size_t Size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+};
+
+//instantiated for float, double and int32_t, like the kernel in geometry.h
+template <class T>
+void BatchHulls(const Point2<T>* points, const uint32_t* offsets, size_t setCount, HullBatch& hulls, unsigned threads = 0);
+
+#endif
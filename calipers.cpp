@@ -0,0 +1,371 @@
+#include "calipers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include "predicates.h"
+
+using namespace std;
+
+namespace
+{
+    //the calipers run at most a few times round, so this beats a division
+    inline size_t Wrap(size_t i, size_t count)
+    {
+        while (i >= count)
+        {
+            i -= count;
+        }
+        return i;
+    }
+
+    template <class T>
+    inline Point2D Promote(const Point2<T>& p)
+    {
+        return Point2D{ (double)p.x, (double)p.y };
+    }
+
+    //hull vertex i (any i, taken around the hull) of a Point2<T> array or a PointSpan, as a Point2D
+    template <class Points>
+    inline Point2D Vertex(const Points& points, const uint32_t* hull, size_t count, size_t i)
+    {
+        return Promote(points[hull[Wrap(i, count)]]);
+    }
+
+    //a caliper resting on hull vertex at, with the vertex after it at hand for the edge test
+    template <class Points>
+    struct Caliper
+    {
+        Points           points;
+        const uint32_t*  hull;
+        size_t           count;
+        size_t           at;
+        Point2D          vertex;
+        Point2D          next;
+
+        void Start(size_t i)
+        {
+            at = i;
+            vertex = Vertex(points, hull, count, i);
+            next = Vertex(points, hull, count, i + 1);
+        }
+
+        void Advance()
+        {
+            at++;
+            vertex = next;
+            next = Vertex(points, hull, count, at + 1);
+        }
+    };
+
+    //exact sign of (a1 - a0) x (b1 - b0): > 0 while edge b turns less than 180 degrees past edge a
+    inline double EdgeCross(const Point2D& a0, const Point2D& a1, const Point2D& b0, const Point2D& b1)
+    {
+        return Predicates::DifferenceProducts(a1.x, a0.x, b1.y, b0.y, a1.y, a0.y, b1.x, b0.x);
+    }
+
+    //exact sign of (a1 - a0) . (b1 - b0)
+    inline double EdgeDot(const Point2D& a0, const Point2D& a1, const Point2D& b0, const Point2D& b1)
+    {
+        return Predicates::DifferenceProducts(a1.x, a0.x, b1.x, b0.x, a1.y, a0.y, b0.y, b1.y);
+    }
+
+    double Distance2(const Point2D& a, const Point2D& b)
+    {
+        return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+    }
+
+    //the first vertex from j on that lies farthest from the line of edge i
+    template <class Points>
+    size_t Antipode(const Points& points, const uint32_t* hull, size_t count, size_t i, size_t j)
+    {
+        const Point2D p = Vertex(points, hull, count, i);
+        const Point2D q = Vertex(points, hull, count, i + 1);
+        while (EdgeCross(p, q, Vertex(points, hull, count, j), Vertex(points, hull, count, j + 1)) > 0)
+        {
+            j++;
+        }
+        return j;
+    }
+
+    HullRectangle Rectangle(const Point2D& origin, const Point2D& u, double from, double to, double height, uint32_t edge)
+    {
+        const Point2D v = { -u.y, u.x };
+        HullRectangle rectangle;
+        rectangle.corners[0] = Point2D{ origin.x + from * u.x, origin.y + from * u.y };
+        rectangle.corners[1] = Point2D{ origin.x + to * u.x, origin.y + to * u.y };
+        rectangle.corners[2] = Point2D{ rectangle.corners[1].x + height * v.x, rectangle.corners[1].y + height * v.y };
+        rectangle.corners[3] = Point2D{ rectangle.corners[0].x + height * v.x, rectangle.corners[0].y + height * v.y };
+        rectangle.area = (to - from) * height;
+        rectangle.perimeter = 2 * ((to - from) + height);
+        rectangle.edge = edge;
+        return rectangle;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: AntipodalPairsCore
+
+    Summary:  As the calipers turn from edge i - 1 to edge i, vertex i
+              stays on one side while the other runs from the antipode
+              of edge i - 1 to that of edge i (and one past it, if edge
+              i is parallel to the antipode's edge). Each pair turns up
+              once from either end, so only the one with the smaller
+              hull position is kept.
+
+    Args:     const Points& points
+                a Point2<T> array or a PointSpan
+              const uint32_t* hull, size_t count
+                a hull of points, as QuickHull reports it
+              vector<pair<uint32_t, uint32_t>>& pairs
+                receives the pairs, as indices into points
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+template <class Points>
+void AntipodalPairsCore(const Points& points, const uint32_t* hull, size_t count, vector<pair<uint32_t, uint32_t>>& pairs)
+{
+    HULL_SCOPE("AntipodalPairs");
+    pairs.clear();
+    if (count < 3)
+    {
+        if (count == 2)
+        {
+            pairs.emplace_back(hull[0], hull[1]);
+        }
+        return;
+    }
+    size_t j = Antipode(points, hull, count, 0, 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        const size_t vertex = Wrap(i + 1, count);
+        const size_t next = Antipode(points, hull, count, i + 1, j);
+        const bool parallel = EdgeCross(Vertex(points, hull, count, i + 1), Vertex(points, hull, count, i + 2),
+            Vertex(points, hull, count, next), Vertex(points, hull, count, next + 1)) == 0;
+        for (size_t k = j; k <= next + parallel; k++)
+        {
+            if (vertex < Wrap(k, count))
+            {
+                pairs.emplace_back(hull[vertex], hull[Wrap(k, count)]);
+            }
+        }
+        j = next;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: MeasureHullCore
+
+    Summary:  Four calipers on one sweep over the edges: for edge i,
+              r is the vertex farthest along it, j the farthest from
+              its line (the antipode) and l the farthest back along it.
+              Each only moves forward, so the sweep is O(h). The width
+              and both rectangles are flush with some edge, and the
+              diameter is an antipodal pair, so both ends of edge i are
+              tried against j (and j + 1 when their edges are parallel).
+
+    Args:     const Points& points
+                a Point2<T> array or a PointSpan
+              const uint32_t* hull, size_t count
+                a hull of points, as QuickHull reports it
+
+    Returns:  HullMeasures
+-----------------------------------------------------------------F-F*/
+template <class Points>
+HullMeasures MeasureHullCore(const Points& points, const uint32_t* hull, size_t count)
+{
+    HULL_SCOPE("MeasureHull");
+    HullMeasures measures = {};
+    if (count == 0)
+    {
+        return measures;
+    }
+    const Point2D first = Vertex(points, hull, count, 0);
+    const Point2D last = Vertex(points, hull, count, count - 1);
+    measures.diameter = HullDiameter{ sqrt(Distance2(first, last)), hull[0], hull[count - 1] };
+    measures.width = HullWidth{ 0, hull[0], hull[count - 1] };
+    if (count < 3)
+    {
+        //a point or a segment: its rectangles are flat
+        const Point2D u = count == 2
+            ? Point2D{ (last.x - first.x) / measures.diameter.length, (last.y - first.y) / measures.diameter.length }
+            : Point2D{ 1, 0 };
+        measures.minArea = Rectangle(first, u, 0, measures.diameter.length, 0, hull[0]);
+        measures.minPerimeter = measures.minArea;
+        return measures;
+    }
+
+    measures.width.width = numeric_limits<double>::infinity();
+    measures.minArea.area = numeric_limits<double>::infinity();
+    measures.minPerimeter.perimeter = numeric_limits<double>::infinity();
+    double diameter2 = 0;
+    Caliper<Points> edge = { points, hull, count, 0, {}, {} };
+    edge.Start(0);
+    Caliper<Points> ahead = edge;
+    Caliper<Points> antipode = edge;
+    Caliper<Points> back = edge;
+    for (size_t i = 0; i < count; i++, edge.Advance())
+    {
+        const Point2D& p = edge.vertex;
+        const Point2D& q = edge.next;
+        if (ahead.at < i + 1)
+        {
+            ahead.Start(i + 1);
+        }
+        while (EdgeDot(p, q, ahead.vertex, ahead.next) > 0)
+        {
+            ahead.Advance();
+        }
+        if (antipode.at < ahead.at)
+        {
+            antipode = ahead;
+        }
+        while (EdgeCross(p, q, antipode.vertex, antipode.next) > 0)
+        {
+            antipode.Advance();
+        }
+        if (back.at < antipode.at)
+        {
+            back = antipode;
+        }
+        while (EdgeDot(p, q, back.vertex, back.next) < 0)
+        {
+            back.Advance();
+        }
+
+        const size_t j = antipode.at;
+        const bool parallel = EdgeCross(p, q, antipode.vertex, antipode.next) == 0;
+        const Point2D* ends[2] = { &p, &q };
+        for (const Point2D* end : ends)
+        {
+            for (size_t k = j; k <= j + parallel; k++)
+            {
+                const double d2 = Distance2(*end, k == j ? antipode.vertex : antipode.next);
+                if (d2 > diameter2)
+                {
+                    diameter2 = d2;
+                    measures.diameter.a = hull[Wrap(end == &p ? i : i + 1, count)];
+                    measures.diameter.b = hull[Wrap(k, count)];
+                }
+            }
+        }
+
+        const double length = sqrt(Distance2(p, q));
+        const Point2D u = { (q.x - p.x) / length, (q.y - p.y) / length };
+        const double height = Cross(p, q, antipode.vertex) / length;
+        if (height < measures.width.width)
+        {
+            measures.width = HullWidth{ height, hull[i], hull[Wrap(j, count)] };
+        }
+        const double from = (back.vertex.x - p.x) * u.x + (back.vertex.y - p.y) * u.y;
+        const double to = (ahead.vertex.x - p.x) * u.x + (ahead.vertex.y - p.y) * u.y;
+        const double area = (to - from) * height;
+        const double perimeter = 2 * ((to - from) + height);
+        if (area < measures.minArea.area)
+        {
+            measures.minArea = Rectangle(p, u, from, to, height, hull[i]);
+        }
+        if (perimeter < measures.minPerimeter.perimeter)
+        {
+            measures.minPerimeter = Rectangle(p, u, from, to, height, hull[i]);
+        }
+    }
+    measures.diameter.length = sqrt(diameter2);
+    return measures;
+}
+
+template <class T>
+void AntipodalPairs(const Point2<T>* points, const uint32_t* hull, size_t count, vector<pair<uint32_t, uint32_t>>& pairs)
+{
+    AntipodalPairsCore(points, hull, count, pairs);
+}
+
+void AntipodalPairs(const PointSpan& points, const uint32_t* hull, size_t count, vector<pair<uint32_t, uint32_t>>& pairs)
+{
+    AntipodalPairsCore(points, hull, count, pairs);
+}
+
+template <class T>
+HullMeasures MeasureHull(const Point2<T>* points, const uint32_t* hull, size_t count)
+{
+    return MeasureHullCore(points, hull, count);
+}
+
+HullMeasures MeasureHull(const PointSpan& points, const uint32_t* hull, size_t count)
+{
+    return MeasureHullCore(points, hull, count);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: MeasureHulls
+
+    Summary:  MeasureHull over every hull of a batch, with the hulls
+              split across threads by vertex count as BatchHulls splits
+              its sets by point count.
+
+    Args:     const Point2<T>* points
+                the packed points the batch indexes
+              const HullBatch& hulls
+              vector<HullMeasures>& measures
+                receives one entry per hull
+              unsigned threads
+                0 for one per hardware thread
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+template <class T>
+void MeasureHulls(const Point2<T>* points, const HullBatch& hulls, vector<HullMeasures>& measures, unsigned threads)
+{
+    HULL_SCOPE("MeasureHulls");
+    const size_t hullCount = hulls.Size();
+    measures.resize(hullCount);
+    if (hullCount == 0)
+    {
+        return;
+    }
+
+    //ranges smaller than this are not worth a thread
+    const size_t minRange = 1 << 14;
+    const uint32_t* offsets = hulls.offsets.data();
+    const size_t total = offsets[hullCount] - offsets[0];
+    unsigned threadCount = threads ? threads : thread::hardware_concurrency();
+    threadCount = (unsigned)max<size_t>(1, min<size_t>(max(threadCount, 1u), total / minRange));
+
+    auto worker = [&](unsigned id)
+    {
+        const uint32_t* end = offsets + hullCount;
+        const size_t begin = lower_bound(offsets, end, offsets[0] + total * id / threadCount) - offsets;
+        const size_t last = lower_bound(offsets, end, offsets[0] + total * (id + 1) / threadCount) - offsets;
+        for (size_t h = begin; h < (id + 1 == threadCount ? hullCount : last); h++)
+        {
+            measures[h] = MeasureHull(points, hulls.indices.data() + offsets[h], offsets[h + 1] - offsets[h]);
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& t : pool)
+    {
+        t.join();
+    }
+}
+
+/*--------------------------------------------------------------------
+    The instantiations calipers.h promises, one set per scalar type.
+--------------------------------------------------------------------*/
+#define INSTANTIATE_CALIPERS(T) \
+    template void AntipodalPairs<T>(const Point2<T>*, const uint32_t*, size_t, vector<pair<uint32_t, uint32_t>>&); \
+    template HullMeasures MeasureHull<T>(const Point2<T>*, const uint32_t*, size_t); \
+    template void MeasureHulls<T>(const Point2<T>*, const HullBatch&, vector<HullMeasures>&, unsigned);
+
+INSTANTIATE_CALIPERS(float)
+INSTANTIATE_CALIPERS(double)
+INSTANTIATE_CALIPERS(int32_t)
+
+#undef INSTANTIATE_CALIPERS
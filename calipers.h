@@ -0,0 +1,81 @@
+#ifndef _CALIPERS_H
+#define _CALIPERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "batchhull.h"
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Rotating calipers measurements of a hull, read straight from the
+    points and the index sequence QuickHull (or BatchHulls) returns:
+    counter-clockwise, no collinear vertices. Nothing is copied; every
+    routine is one O(h) sweep over a Point2<T> array or a PointSpan (a
+    mapped file, say). Results name vertices by their index into
+    points, as the hull does.
+
+    The calipers advance on exact signs of cross and dot products of
+    edge vectors (Predicates::DifferenceProducts on the coordinates,
+    which every T converts to exactly), so they turn consistently on
+    nearly parallel edges. Lengths and areas are rounded as usual.
+--------------------------------------------------------------------*/
+
+struct HullDiameter
+{
+    double   length;
+    uint32_t a;             // the farthest pair
+    uint32_t b;
+};
+
+struct HullWidth
+{
+    double   width;
+    uint32_t edge;          // the edge from this vertex to the next one
+    uint32_t vertex;        // farthest from that edge's line
+};
+
+struct HullRectangle
+{
+    Point2D  corners[4];    // counter-clockwise, the first two on the edge
+    double   area;
+    double   perimeter;
+    uint32_t edge;          // the hull edge it lies flush with, named by its first vertex
+};
+
+struct HullMeasures
+{
+    HullDiameter  diameter;
+    HullWidth     width;
+    HullRectangle minArea;
+    HullRectangle minPerimeter;
+};
+
+//instantiated for float, double and int32_t, like the kernel in geometry.h
+
+//every pair of vertices with parallel support lines through both, each pair once
+template <class T>
+void AntipodalPairs(const Point2<T>* points, const uint32_t* hull, size_t count,
+    std::vector<std::pair<uint32_t, uint32_t>>& pairs);
+void AntipodalPairs(const PointSpan& points, const uint32_t* hull, size_t count,
+    std::vector<std::pair<uint32_t, uint32_t>>& pairs);
+
+//diameter, width and both bounding rectangles in one sweep; a point or segment gives zero width
+template <class T>
+HullMeasures MeasureHull(const Point2<T>* points, const uint32_t* hull, size_t count);
+HullMeasures MeasureHull(const PointSpan& points, const uint32_t* hull, size_t count);
+
+template <class T>
+inline HullMeasures MeasureHull(const Point2<T>* points, const std::vector<uint32_t>& hull)
+{
+    return MeasureHull(points, hull.data(), hull.size());
+}
+
+//MeasureHull of every hull of a batch, split across threads by hull size
+template <class T>
+void MeasureHulls(const Point2<T>* points, const HullBatch& hulls, std::vector<HullMeasures>& measures,
+    unsigned threads = 0);
+
+#endif
@@ -0,0 +1,375 @@
+#ifndef _CONSTEXPRHULL_H
+#define _CONSTEXPRHULL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Compile time hulls and Minkowski sums, for shapes known when the
+    program is built: a constexpr table of points goes in, and the
+    compiler embeds the finished polygon in the binary, so startup
+    does no geometry at all.
+
+    The results are those of the runtime kernel: BakeHull gives the
+    vertices QuickHull would (counter-clockwise from the left most
+    point, no collinear vertices) and BakeMinkowskiSum those of
+    MinkowskiSum, vertex for vertex. A constant expression may not
+    call predicates.cpp or fma, so the orientation tests here compute
+    the exact sign directly with expansion arithmetic: slow, but exact
+    and only ever run by the compiler. Coordinates must be finite and
+    their products must stay clear of overflow and underflow.
+
+    Polygons are FixedPolygon<T, N>: room for N vertices, count used.
+    Check baked tables with static_assert(SameVertices(...)).
+--------------------------------------------------------------------*/
+
+template <class T, size_t N>
+struct FixedPolygon
+{
+    std::array<Point2<T>, N> vertices;
+    size_t                   count;
+
+    constexpr const Point2<T>& operator[](size_t i) const { return vertices[i]; }
+    constexpr size_t           Size() const { return count; }
+    const Point2<T>*           Data() const { return vertices.data(); }
+};
+
+namespace Baked
+{
+    constexpr void TwoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        const double bVirtual = x - a;
+        const double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    constexpr void TwoDiff(double a, double b, double& x, double& y)
+    {
+        x = a - b;
+        const double bVirtual = a - x;
+        const double aVirtual = x + bVirtual;
+        y = (a - aVirtual) + (bVirtual - b);
+    }
+
+    //Dekker's product, exact without fma
+    constexpr void TwoProduct(double a, double b, double& x, double& y)
+    {
+        const double splitter = 134217729.0;
+        x = a * b;
+        const double ca = splitter * a;
+        const double aHigh = ca - (ca - a);
+        const double aLow = a - aHigh;
+        const double cb = splitter * b;
+        const double bHigh = cb - (cb - b);
+        const double bLow = b - bHigh;
+        y = aLow * bLow - (((x - aHigh * bHigh) - aLow * bHigh) - aHigh * bLow);
+    }
+
+    //adds b to the expansion e[0..length), which stays non-overlapping in increasing magnitude
+    constexpr size_t Grow(double* e, size_t length, double b)
+    {
+        double q = b;
+        for (size_t i = 0; i < length; i++)
+        {
+            double sum = 0;
+            double tail = 0;
+            TwoSum(q, e[i], sum, tail);
+            e[i] = tail;
+            q = sum;
+        }
+        e[length] = q;
+        return length + 1;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: Baked::DifferenceProductsSign
+
+        Summary:  Exact sign of (a1 - a2)(b1 - b2) - (c1 - c2)(d1 - d2).
+                  Every difference is split into its rounded value and
+                  its rounding error, every product of those into two
+                  doubles, and all sixteen are summed into one
+                  expansion, whose largest non-zero component has the
+                  sign of the whole.
+
+        Returns:  int
+                    +1, -1 or 0
+    -----------------------------------------------------------------F-F*/
+    constexpr int DifferenceProductsSign(double a1, double a2, double b1, double b2,
+        double c1, double c2, double d1, double d2)
+    {
+        double a = 0, aTail = 0, b = 0, bTail = 0, c = 0, cTail = 0, d = 0, dTail = 0;
+        TwoDiff(a1, a2, a, aTail);
+        TwoDiff(b1, b2, b, bTail);
+        TwoDiff(c1, c2, c, cTail);
+        TwoDiff(d1, d2, d, dTail);
+
+        double e[16] = {};
+        size_t length = 0;
+        const double left[4][2] = { { a, b }, { a, bTail }, { aTail, b }, { aTail, bTail } };
+        const double right[4][2] = { { c, d }, { c, dTail }, { cTail, d }, { cTail, dTail } };
+        for (int i = 0; i < 4; i++)
+        {
+            double x = 0;
+            double y = 0;
+            TwoProduct(left[i][0], left[i][1], x, y);
+            length = Grow(e, length, x);
+            length = Grow(e, length, y);
+            TwoProduct(right[i][0], right[i][1], x, y);
+            length = Grow(e, length, -x);
+            length = Grow(e, length, -y);
+        }
+        for (size_t i = length; i-- > 0;)
+        {
+            if (e[i] != 0)
+            {
+                return e[i] > 0 ? 1 : -1;
+            }
+        }
+        return 0;
+    }
+
+    //Orientation, in a constant expression
+    template <class T>
+    constexpr int Orientation(const Point2<T>& a, const Point2<T>& b, const Point2<T>& c)
+    {
+        if constexpr (std::is_integral<T>::value)
+        {
+            const int64_t d = (int64_t)(b.x - a.x) * (c.y - a.y) - (int64_t)(b.y - a.y) * (c.x - a.x);
+            return (d > 0) - (d < 0);
+        }
+        else
+        {
+            return DifferenceProductsSign(a.x, c.x, b.y, c.y, a.y, c.y, b.x, c.x);
+        }
+    }
+
+    //sign of (na - pa) x (nb - pb), the turn between two edges
+    template <class T>
+    constexpr int EdgeTurn(const Point2<T>& pa, const Point2<T>& na, const Point2<T>& pb, const Point2<T>& nb)
+    {
+        if constexpr (std::is_integral<T>::value)
+        {
+            const int64_t d = (int64_t)(na.x - pa.x) * (nb.y - pb.y) - (int64_t)(na.y - pa.y) * (nb.x - pb.x);
+            return (d > 0) - (d < 0);
+        }
+        else
+        {
+            return DifferenceProductsSign(na.x, pa.x, nb.y, pb.y, na.y, pa.y, nb.x, pb.x);
+        }
+    }
+
+    template <class T>
+    constexpr bool Before(const Point2<T>& p, const Point2<T>& q)
+    {
+        return p.x < q.x || (p.x == q.x && p.y < q.y);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: BakeHull
+
+    Summary:  Hull of a constant table of points: an insertion sort
+              (std::sort is not constexpr in C++17) and Andrew's
+              monotone chain, lower hull then upper, popping every
+              vertex that does not turn left.
+
+    Args:     const std::array<Point2<T>, N>& points
+                points the hull will form around
+
+    Returns:  FixedPolygon<T, N>
+                the hull vertices, in QuickHull's order
+-----------------------------------------------------------------F-F*/
+template <class T, size_t N>
+constexpr FixedPolygon<T, N> BakeHull(const std::array<Point2<T>, N>& points)
+{
+    FixedPolygon<T, N> hull{};
+    if (N == 0)
+    {
+        return hull;
+    }
+
+    std::array<Point2<T>, N> sorted = points;
+    for (size_t i = 1; i < N; i++)
+    {
+        for (size_t j = i; j > 0 && Baked::Before(sorted[j], sorted[j - 1]); j--)
+        {
+            const Point2<T> t = sorted[j];
+            sorted[j] = sorted[j - 1];
+            sorted[j - 1] = t;
+        }
+    }
+    const Point2<T> left = sorted[0];
+    const Point2<T> right = sorted[N - 1];
+    if (left.x == right.x && left.y == right.y)
+    {
+        hull.vertices[0] = left;
+        hull.count = 1;
+        return hull;
+    }
+
+    //the chain closes on its first point, one past the hull
+    std::array<Point2<T>, N + 1> chain{};
+    size_t size = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        while (size >= 2 && Baked::Orientation(chain[size - 2], chain[size - 1], sorted[i]) <= 0)
+        {
+            size--;
+        }
+        chain[size++] = sorted[i];
+    }
+    const size_t lower = size + 1;
+    for (size_t i = N - 1; i-- > 0;)
+    {
+        while (size >= lower && Baked::Orientation(chain[size - 2], chain[size - 1], sorted[i]) <= 0)
+        {
+            size--;
+        }
+        chain[size++] = sorted[i];
+    }
+    hull.count = size - 1;
+    for (size_t i = 0; i < hull.count; i++)
+    {
+        hull.vertices[i] = chain[i];
+    }
+    return hull;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: BakeMinkowskiSum
+
+    Summary:  MinkowskiSum of two baked polygons, step for step: the
+              edges merged by angle from the lowest vertices, collinear
+              vertices dropped and the result started at its left most
+              vertex; a point or segment operand goes through the
+              pairwise sums and BakeHull instead.
+
+    Args:     const FixedPolygon<T, N>& a
+                first convex polygon
+              const FixedPolygon<T, M>& b
+                second convex polygon
+
+    Returns:  FixedPolygon<T, N + M>
+                the sum in hull order
+-----------------------------------------------------------------F-F*/
+template <class T, size_t N, size_t M>
+constexpr FixedPolygon<T, N + M> BakeMinkowskiSum(const FixedPolygon<T, N>& a, const FixedPolygon<T, M>& b)
+{
+    FixedPolygon<T, N + M> sum{};
+    const size_t countA = a.count;
+    const size_t countB = b.count;
+    if (countA == 0 || countB == 0)
+    {
+        return sum;
+    }
+
+    if (countA < 3 || countB < 3)
+    {
+        //unused slots repeat the first sum, which changes no hull
+        std::array<Point2<T>, N * M> pairs{};
+        for (size_t k = 0; k < N * M; k++)
+        {
+            const size_t i = k / M < countA ? k / M : 0;
+            const size_t j = k % M < countB ? k % M : 0;
+            pairs[k] = Point2<T>{ T(a[i].x + b[j].x), T(a[i].y + b[j].y) };
+        }
+        const FixedPolygon<T, N * M> hull = BakeHull(pairs);
+        sum.count = hull.count;
+        for (size_t i = 0; i < hull.count; i++)
+        {
+            sum.vertices[i] = hull[i];
+        }
+        return sum;
+    }
+
+    auto lowest = [](const auto& polygon)
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < polygon.count; i++)
+        {
+            if (polygon[i].y < polygon[best].y || (polygon[i].y == polygon[best].y && polygon[i].x < polygon[best].x))
+            {
+                best = i;
+            }
+        }
+        return best;
+    };
+    const size_t startA = lowest(a);
+    const size_t startB = lowest(b);
+    std::array<Point2<T>, N + M> merged{};
+    size_t length = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < countA || j < countB)
+    {
+        const Point2<T> pa = a[(startA + i) % countA];
+        const Point2<T> pb = b[(startB + j) % countB];
+        merged[length++] = Point2<T>{ T(pa.x + pb.x), T(pa.y + pb.y) };
+
+        const int turn = Baked::EdgeTurn(pa, a[(startA + i + 1) % countA], pb, b[(startB + j + 1) % countB]);
+        if (j == countB || (i < countA && turn > 0))
+        {
+            i++;
+        }
+        else if (i == countA || turn < 0)
+        {
+            j++;
+        }
+        else
+        {
+            i++;
+            j++;
+        }
+    }
+
+    //as NormalizeHull: keep the vertices that turn left, start at the left most one
+    std::array<Point2<T>, N + M> kept{};
+    size_t keptCount = 0;
+    for (size_t k = 0; k < length; k++)
+    {
+        const Point2<T> prev = keptCount == 0 ? merged[length - 1] : kept[keptCount - 1];
+        if (Baked::Orientation(prev, merged[k], merged[(k + 1) % length]) > 0)
+        {
+            kept[keptCount++] = merged[k];
+        }
+    }
+    size_t left = 0;
+    for (size_t k = 1; k < keptCount; k++)
+    {
+        if (Baked::Before(kept[k], kept[left]))
+        {
+            left = k;
+        }
+    }
+    sum.count = keptCount;
+    for (size_t k = 0; k < keptCount; k++)
+    {
+        sum.vertices[k] = kept[(left + k) % keptCount];
+    }
+    return sum;
+}
+
+//true if polygon holds exactly the expected vertices, in order; for static_assert
+template <class T, size_t N, size_t M>
+constexpr bool SameVertices(const FixedPolygon<T, N>& polygon, const std::array<Point2<T>, M>& expected)
+{
+    if (polygon.count != M)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < M; i++)
+    {
+        if (polygon[i].x != expected[i].x || polygon[i].y != expected[i].y)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
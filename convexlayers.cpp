@@ -0,0 +1,513 @@
+#include "convexlayers.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "predicates.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    const uint32_t None = UINT32_MAX;
+
+    inline unsigned LowestBit(uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return (unsigned)__builtin_ctz(mask);
+#endif
+    }
+
+    template <class T>
+    inline Point2D Promote(const Point2<T>& p)
+    {
+        return Point2D{ (double)p.x, (double)p.y };
+    }
+
+    //Andrew's order: by x, then y
+    inline bool Less(const Point2D& a, const Point2D& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HullTree
+
+      Summary:  Chazelle's hull tree over distinct sites in Andrew's
+                order, one site per leaf of a complete binary tree
+                (node 1 the root, node k's children 2k and 2k + 1). Each
+                node keeps the first and last live site below it and,
+                for the upper chain and the lower, the bridge joining
+                its children's chains, or None while a child is empty.
+                A node's chain is its left child's up to the bridge,
+                then its right child's; a site's bit d in leftOf says it
+                is the left end of the bridge at depth d on its path, so
+                its successor on the chain of any node above it is the
+                right end of the highest such bridge at or below that
+                node, found with one bit scan (rightOf likewise gives
+                predecessors). Both chains share a record per site and
+                per node, as a walk reads them together.
+
+      Methods:  Layer
+                  The live sites on the hull, counter-clockwise from
+                  the first.
+                Remove
+                  Takes a site out and repairs the bridges above it.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+    class HullTree
+    {
+    public:
+        explicit HullTree(const vector<Point2D>& points);
+
+        bool Empty() const { return nodes[1].first == None; }
+        void Layer(vector<uint32_t>& hull) const;
+        void Remove(uint32_t site);
+
+    private:
+        //chains are numbered Upper and Lower in the arrays below
+        enum { Upper, Lower };
+
+        struct Site
+        {
+            Point2D     at;
+            uint32_t    leftOf[2];      // a bit per depth
+            uint32_t    rightOf[2];
+        };
+
+        struct Node
+        {
+            uint32_t    first;
+            uint32_t    last;
+            uint32_t    left[2];        // bridge ends
+            uint32_t    right[2];
+        };
+
+        size_t   Index(uint32_t site, unsigned depth) const { return (leaves + site) >> (height - depth); }
+        uint32_t Next(int chain, uint32_t site, unsigned depth) const;
+        uint32_t Prev(int chain, uint32_t site, unsigned depth) const;
+        double   Beyond(int chain, uint32_t a, uint32_t b, uint32_t p) const;
+        bool     Steer(int chain, size_t node, uint32_t l, uint32_t n, uint32_t r, uint32_t q) const;
+        bool     IsBridge(int chain, unsigned depth, uint32_t l, uint32_t r) const;
+        void     SetBridge(int chain, size_t node, unsigned depth, uint32_t l, uint32_t r);
+        void     ClearBridge(int chain, size_t node, unsigned depth);
+        void     Merge(int chain, size_t node, unsigned depth);
+        void     Repair(int chain, size_t node, unsigned depth, uint32_t l, uint32_t r);
+        void     Remove(int chain, uint32_t site);
+
+        vector<Site>    sites;
+        vector<Node>    nodes;
+        size_t          leaves;
+        unsigned        height;
+    };
+
+    HullTree::HullTree(const vector<Point2D>& points) : sites(points.size()), leaves(1), height(0)
+    {
+        while (leaves < points.size())
+        {
+            leaves *= 2;
+            height++;
+        }
+        nodes.assign(2 * leaves, Node{ None, None, { None, None }, { None, None } });
+        for (uint32_t i = 0; i < points.size(); i++)
+        {
+            sites[i] = Site{ points[i], { 0, 0 }, { 0, 0 } };
+            nodes[leaves + i].first = nodes[leaves + i].last = i;
+        }
+        unsigned depth = height;
+        for (size_t node = leaves - 1; node >= 1; node--)
+        {
+            if ((node & (node + 1)) == 0)
+            {
+                depth--;
+            }
+            nodes[node].first = nodes[2 * node].first != None ? nodes[2 * node].first : nodes[2 * node + 1].first;
+            nodes[node].last = nodes[2 * node + 1].last != None ? nodes[2 * node + 1].last : nodes[2 * node].last;
+            if (nodes[2 * node].first != None && nodes[2 * node + 1].first != None)
+            {
+                Merge(Upper, node, depth);
+                Merge(Lower, node, depth);
+            }
+        }
+    }
+
+    //site's successor on the chain of the node at depth on its path, None if it ends there
+    uint32_t HullTree::Next(int chain, uint32_t site, unsigned depth) const
+    {
+        const uint32_t mask = depth < 32 ? sites[site].leftOf[chain] >> depth << depth : 0;
+        return mask ? nodes[Index(site, LowestBit(mask))].right[chain] : None;
+    }
+
+    uint32_t HullTree::Prev(int chain, uint32_t site, unsigned depth) const
+    {
+        const uint32_t mask = depth < 32 ? sites[site].rightOf[chain] >> depth << depth : 0;
+        return mask ? nodes[Index(site, LowestBit(mask))].left[chain] : None;
+    }
+
+    //> 0 if p lies strictly outside the line a->b: above it for the upper chain, below for the lower
+    double HullTree::Beyond(int chain, uint32_t a, uint32_t b, uint32_t p) const
+    {
+        const Point2D& pa = sites[a].at;
+        const Point2D& pb = sites[b].at;
+        const Point2D& pp = sites[p].at;
+        const double orientation = Orient2D(pa.x, pa.y, pb.x, pb.y, pp.x, pp.y);
+        return chain == Upper ? orientation : -orientation;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HullTree::Steer
+
+      Summary:  The step the inward walk cannot settle from signs alone:
+                both n after l and q before r lie beyond the line l->r,
+                so l is short of the bridge, or r is, or both. With a
+                vertical line x = m between the children, if l is the
+                bridge end the line through l and n meets it no further
+                out than the line through q and r, and if r is, no
+                nearer (Overmars and van Leeuwen's test). Rounding can
+                only send the walk the wrong way, which IsBridge then
+                catches.
+
+      Args:     int chain
+                size_t node
+                  the node whose bridge is sought
+                uint32_t l, uint32_t n
+                  a site on the left child's chain and the one after it
+                uint32_t r, uint32_t q
+                  a site on the right child's chain and the one before it
+
+      Returns:  bool
+                  true to advance l, false to step r back
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool HullTree::Steer(int chain, size_t node, uint32_t l, uint32_t n, uint32_t r, uint32_t q) const
+    {
+        const Point2D& a = sites[l].at;
+        const Point2D& b = sites[n].at;
+        const Point2D& c = sites[q].at;
+        const Point2D& d = sites[r].at;
+        //a vertical edge ends a chain, and its lower (upper) end is never on the bridge
+        if (a.x == b.x)
+        {
+            return true;
+        }
+        if (c.x == d.x)
+        {
+            return false;
+        }
+        const double m = sites[nodes[2 * node + 1].first].at.x;
+        const double atLeft = a.y + (m - a.x) * (b.y - a.y) / (b.x - a.x);
+        const double atRight = d.y + (m - d.x) * (d.y - c.y) / (d.x - c.x);
+        return chain == Upper ? atLeft > atRight : atLeft < atRight;
+    }
+
+    //with nothing beyond l->r after l or before r, as the walk leaves them, nothing on or beyond it outside either
+    bool HullTree::IsBridge(int chain, unsigned depth, uint32_t l, uint32_t r) const
+    {
+        const uint32_t before = Prev(chain, l, depth + 1);
+        const uint32_t after = Next(chain, r, depth + 1);
+        return (before == None || Beyond(chain, l, r, before) < 0) && (after == None || Beyond(chain, l, r, after) < 0);
+    }
+
+    void HullTree::SetBridge(int chain, size_t node, unsigned depth, uint32_t l, uint32_t r)
+    {
+        nodes[node].left[chain] = l;
+        nodes[node].right[chain] = r;
+        sites[l].leftOf[chain] |= 1u << depth;
+        sites[r].rightOf[chain] |= 1u << depth;
+    }
+
+    void HullTree::ClearBridge(int chain, size_t node, unsigned depth)
+    {
+        sites[nodes[node].left[chain]].leftOf[chain] &= ~(1u << depth);
+        sites[nodes[node].right[chain]].rightOf[chain] &= ~(1u << depth);
+        nodes[node].left[chain] = nodes[node].right[chain] = None;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HullTree::Merge
+
+      Summary:  Finds a node's bridge from scratch, walking out from the
+                last site on the left and the first on the right (the
+                merge step of divide and conquer hulls). Collinear sites
+                are stepped over, so the bridge ends are the outermost.
+
+      Args:     int chain
+                size_t node, unsigned depth
+                  a node with both children live
+
+      Modifies: the node's bridge
+
+      Returns:  void
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HullTree::Merge(int chain, size_t node, unsigned depth)
+    {
+        uint32_t l = nodes[2 * node].last;
+        uint32_t r = nodes[2 * node + 1].first;
+        bool moved = true;
+        while (moved)
+        {
+            moved = false;
+            for (uint32_t p = Prev(chain, l, depth + 1); p != None && Beyond(chain, l, r, p) >= 0; p = Prev(chain, l, depth + 1))
+            {
+                l = p;
+                moved = true;
+            }
+            for (uint32_t q = Next(chain, r, depth + 1); q != None && Beyond(chain, l, r, q) >= 0; q = Next(chain, r, depth + 1))
+            {
+                r = q;
+                moved = true;
+            }
+        }
+        SetBridge(chain, node, depth, l, r);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HullTree::Repair
+
+      Summary:  Finds a node's bridge again after one of its ends went,
+                walking in from sites known to be no further in than the
+                new ends: the surviving neighbour of the lost end, and
+                the other end, which the new bridge cannot pass since
+                the node's chain only gains sites as others go. Every
+                site walked over joins the node's chain for good, which
+                is what bounds the total. A result that is not a bridge
+                (Steer misled by rounding) is found again by Merge.
+
+      Args:     int chain
+                size_t node, unsigned depth
+                  a node with both children live and no bridge
+                uint32_t l, uint32_t r
+                  where to start on the left and right child's chains
+
+      Modifies: the node's bridge
+
+      Returns:  void
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HullTree::Repair(int chain, size_t node, unsigned depth, uint32_t l, uint32_t r)
+    {
+        for (;;)
+        {
+            const uint32_t n = Next(chain, l, depth + 1);
+            const uint32_t q = Prev(chain, r, depth + 1);
+            const bool advance = n != None && Beyond(chain, l, r, n) > 0;
+            const bool retreat = q != None && Beyond(chain, l, r, q) > 0;
+            if (!advance && !retreat)
+            {
+                break;
+            }
+            if (advance && (!retreat || Steer(chain, node, l, n, r, q)))
+            {
+                l = n;
+            }
+            else
+            {
+                r = q;
+            }
+        }
+        if (IsBridge(chain, depth, l, r))
+        {
+            SetBridge(chain, node, depth, l, r);
+        }
+        else
+        {
+            Merge(chain, node, depth);
+        }
+    }
+
+    //repairs chain from site's parent up, stopping at the first node whose chain site was not on
+    void HullTree::Remove(int chain, uint32_t site)
+    {
+        //site's neighbours on the old chain of the child in hand, read off the bridges as they go
+        uint32_t before = None;
+        uint32_t after = None;
+        for (unsigned depth = height; depth-- > 0; )
+        {
+            const size_t node = Index(site, depth);
+            const size_t child = Index(site, depth + 1);
+            const uint32_t l = nodes[node].left[chain];
+            const uint32_t r = nodes[node].right[chain];
+            if (l == None)
+            {
+                continue;
+            }
+            if (child == 2 * node)
+            {
+                if (site > l)
+                {
+                    return;
+                }
+                if (site == l)
+                {
+                    ClearBridge(chain, node, depth);
+                    if (nodes[child].first != None)
+                    {
+                        Repair(chain, node, depth, before != None ? before : nodes[child].first, r);
+                    }
+                    after = r;
+                }
+            }
+            else
+            {
+                if (site < r)
+                {
+                    return;
+                }
+                if (site == r)
+                {
+                    ClearBridge(chain, node, depth);
+                    if (nodes[child].first != None)
+                    {
+                        Repair(chain, node, depth, l, after != None ? after : nodes[child].last);
+                    }
+                    before = l;
+                }
+            }
+        }
+    }
+
+    void HullTree::Remove(uint32_t site)
+    {
+        size_t node = leaves + site;
+        nodes[node].first = nodes[node].last = None;
+        for (node /= 2; node >= 1; node /= 2)
+        {
+            nodes[node].first = nodes[2 * node].first != None ? nodes[2 * node].first : nodes[2 * node + 1].first;
+            nodes[node].last = nodes[2 * node + 1].last != None ? nodes[2 * node + 1].last : nodes[2 * node].last;
+        }
+        Remove(Upper, site);
+        Remove(Lower, site);
+    }
+
+    //the lower chain left to right, then the upper one back; a lone site, or two, once each
+    void HullTree::Layer(vector<uint32_t>& hull) const
+    {
+        hull.clear();
+        for (uint32_t site = nodes[1].first; site != None; site = Next(Lower, site, 0))
+        {
+            hull.push_back(site);
+        }
+        const size_t bottom = hull.size();
+        for (uint32_t site = Next(Upper, nodes[1].first, 0); site != None; site = Next(Upper, site, 0))
+        {
+            hull.push_back(site);
+        }
+        //the upper chain ends where the lower one does
+        if (hull.size() > bottom)
+        {
+            hull.pop_back();
+        }
+        reverse(hull.begin() + bottom, hull.end());
+    }
+
+    template <class Points>
+    size_t ConvexLayersCore(const Points& points, size_t count, vector<uint32_t>& layer, HullBatch* hulls)
+    {
+        HULL_SCOPE("ConvexLayers");
+        layer.assign(count, 0);
+        if (hulls)
+        {
+            hulls->offsets.assign(1, 0);
+            hulls->indices.clear();
+        }
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        vector<uint32_t> order(count);
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&points](uint32_t a, uint32_t b)
+        {
+            const Point2D p = Promote(points[a]);
+            const Point2D q = Promote(points[b]);
+            return Less(p, q) || (!Less(q, p) && a < b);
+        });
+        //coincident points share a site and take turns at it, one per layer, as repeated QuickHull would
+        vector<Point2D> sites;
+        vector<uint32_t> start;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const Point2D p = Promote(points[order[i]]);
+            if (sites.empty() || Less(sites.back(), p))
+            {
+                sites.push_back(p);
+                start.push_back(i);
+            }
+        }
+        start.push_back((uint32_t)count);
+        vector<uint32_t> next(start.begin(), start.end() - 1);
+
+        HullTree tree(sites);
+        sites.clear();
+        sites.shrink_to_fit();
+        vector<uint32_t> hull;
+        size_t layers = 0;
+        while (!tree.Empty())
+        {
+            tree.Layer(hull);
+            for (const uint32_t site : hull)
+            {
+                const uint32_t point = order[next[site]];
+                layer[point] = (uint32_t)layers;
+                if (hulls)
+                {
+                    hulls->indices.push_back(point);
+                }
+                if (++next[site] == start[site + 1])
+                {
+                    tree.Remove(site);
+                }
+            }
+            if (hulls)
+            {
+                hulls->offsets.push_back((uint32_t)hulls->indices.size());
+            }
+            layers++;
+        }
+        return layers;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: ConvexLayers
+
+    Summary:  Peels the points layer by layer with a hull tree, in
+              O(n log n) all told.
+
+    Args:     const Point2<T>* points, size_t count
+                or a PointSpan
+              vector<uint32_t>& layer
+                receives each point's layer, 0 outermost
+              HullBatch* hulls
+                if not null, receives each layer's hull as indices
+                into points, counter-clockwise from its left most point
+
+    Returns:  size_t
+                the number of layers
+-----------------------------------------------------------------F-F*/
+template <class T>
+size_t ConvexLayers(const Point2<T>* points, size_t count, vector<uint32_t>& layer, HullBatch* hulls)
+{
+    return ConvexLayersCore(points, count, layer, hulls);
+}
+
+size_t ConvexLayers(const PointSpan& points, vector<uint32_t>& layer, HullBatch* hulls)
+{
+    return ConvexLayersCore(points, points.count, layer, hulls);
+}
+
+/*---- Instantiations for the supported coordinate types. ----*/
+#define INSTANTIATE_CONVEXLAYERS(T) \
+    template size_t ConvexLayers<T>(const Point2<T>*, size_t, vector<uint32_t>&, HullBatch*);
+
+INSTANTIATE_CONVEXLAYERS(float)
+INSTANTIATE_CONVEXLAYERS(double)
+INSTANTIATE_CONVEXLAYERS(int32_t)
+
+#undef INSTANTIATE_CONVEXLAYERS
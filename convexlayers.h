@@ -0,0 +1,44 @@
+#ifndef _CONVEXLAYERS_H
+#define _CONVEXLAYERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "batchhull.h"
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Convex layers (onion peeling): layer 0 is the hull of the points,
+    layer 1 the hull of what is left once its vertices are removed,
+    and so on. A layer holds exactly the vertices QuickHull would
+    report for the points left, so points on an edge but not at a
+    corner wait for a later layer, and of coincident points one goes
+    to each layer in turn.
+
+    The points are sorted once into the leaves of a balanced tree whose
+    nodes keep the bridge joining their children's upper chains, and
+    another for the lower chains (Chazelle's hull tree). Walking a
+    node's chain needs no copy of it: each point keeps a bit per tree
+    level at which it is a bridge end, and its neighbour on any chain
+    is the other end of the highest such bridge. Peeling a point
+    repairs the bridges above it by walking the two child chains in
+    from the old bridge's surviving neighbours. A point that joins a
+    node's chain stays on it until peeled, and only points that join
+    are walked over, so all the peeling costs O(n log n) together with
+    the sort. The walk decides its direction in floating point where
+    it has to; every bridge it finds is checked with exact orientation
+    tests, and a bridge that fails the check is redone from scratch.
+
+    Points go in as for the other engines: a Point2<T> array (float,
+    double or int32_t) or a PointSpan, and come out as indices. hulls,
+    when given, receives each layer's hull in HullBatch form,
+    counter-clockwise from its left most point like QuickHull's.
+--------------------------------------------------------------------*/
+
+//layer[i] is the depth of point i, 0 for the outer hull; returns the number of layers
+template <class T>
+size_t ConvexLayers(const Point2<T>* points, size_t count, std::vector<uint32_t>& layer, HullBatch* hulls = nullptr);
+size_t ConvexLayers(const PointSpan& points, std::vector<uint32_t>& layer, HullBatch* hulls = nullptr);
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _DATAFLOW_H
+#define _DATAFLOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "instrument.h"
+
+/*--------------------------------------------------------------------
+    Dirty tracking for a small pipeline of computations, such as point
+    sets -> hulls -> Minkowski hull -> queries in MainWindow::AlgoTest.
+
+    Sources are values changed from outside (a point set, the origin);
+    stages are computed from earlier nodes. Every node has a version:
+    Touch bumps a source's, and Computed bumps a stage's only when its
+    value came out different, so a hull rebuilt to the same vertices
+    leaves everything downstream of it clean. A stage is stale when an
+    input's version differs from the one it last computed from, and
+    is recomputed by its owner, who keeps the memoized value; the graph
+    holds versions only. Owners visit stages in the order they were
+    added, which is always a topological order.
+--------------------------------------------------------------------*/
+
+class DirtyGraph
+{
+public:
+    typedef size_t Node;
+
+    //a value set from outside
+    Node AddSource()
+    {
+        return AddStage({});
+    }
+
+    //a value computed from inputs added before it; stale until first computed
+    Node AddStage(std::initializer_list<Node> inputs)
+    {
+        versions.push_back(0);
+        stages.push_back(Stage{ std::vector<Node>(inputs), std::vector<uint64_t>(inputs.size(), NeverComputed) });
+        return versions.size() - 1;
+    }
+
+    void Touch(Node source)
+    {
+        versions[source]++;
+    }
+
+    //every node, for when the inputs are replaced wholesale
+    void TouchAll()
+    {
+        for (uint64_t& version : versions)
+        {
+            version++;
+        }
+    }
+
+    bool Stale(Node stage) const
+    {
+        const Stage& s = stages[stage];
+        for (size_t i = 0; i < s.inputs.size(); i++)
+        {
+            if (s.seen[i] != versions[s.inputs[i]])
+            {
+                HULL_COUNT(PipelineStagesRun, 1);
+                return true;
+            }
+        }
+        HULL_COUNT(PipelineStagesSkipped, 1);
+        return false;
+    }
+
+    //the stage was recomputed from its inputs as they are now
+    void Computed(Node stage, bool changed)
+    {
+        Stage& s = stages[stage];
+        for (size_t i = 0; i < s.inputs.size(); i++)
+        {
+            s.seen[i] = versions[s.inputs[i]];
+        }
+        versions[stage] += changed;
+    }
+
+private:
+    static constexpr uint64_t NeverComputed = ~(uint64_t)0;
+
+    struct Stage
+    {
+        std::vector<Node>     inputs;
+        std::vector<uint64_t> seen;     // input versions at the last Computed
+    };
+
+    std::vector<uint64_t> versions;
+    std::vector<Stage>    stages;
+};
+
+#endif
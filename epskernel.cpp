@@ -0,0 +1,424 @@
+#include "epskernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+    //relative to the radius of the cloud, far above what the rounding of a distance can reach
+    const double RoundingMargin = 1e-9;
+
+    //anchors sit this many cloud radii from the centre
+    const double AnchorScale = 2;
+
+    const double Pi = 3.14159265358979323846;
+
+    //monotone in the angle of (dx, dy), from 0 to 4, without a trigonometric call
+    double PseudoAngle(double dx, double dy)
+    {
+        if (dy >= 0)
+        {
+            return dx >= 0 ? dy / (dx + dy) : 1 - dx / (dy - dx);
+        }
+        return dx < 0 ? 2 - dy / (-dx - dy) : 3 + dx / (dx - dy);
+    }
+
+    //the angle, in [0, 2π), of the pseudo angle a
+    double AngleOf(double a)
+    {
+        const int quadrant = min(3, (int)a);
+        const double t = a - quadrant;
+        const double x[4] = { 1 - t, -t, t - 1, t };
+        const double y[4] = { t, 1 - t, -t, t - 1 };
+        const double angle = atan2(y[quadrant], x[quadrant]);
+        return angle < 0 ? angle + 2 * Pi : angle;
+    }
+
+    bool Less(const Point2D& a, const Point2D& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+
+    double SegmentDistance(const Point2D& p, const Point2D& a, const Point2D& b)
+    {
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double length2 = dx * dx + dy * dy;
+        double t = length2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length2 : 0;
+        t = min(1.0, max(0.0, t));
+        return hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+    }
+
+    //distance of a point outside a convex polygon (or on it) from the polygon
+    double PolygonDistance(const Point2D& p, const vector<Point2D>& polygon)
+    {
+        if (polygon.size() == 1)
+        {
+            return hypot(p.x - polygon[0].x, p.y - polygon[0].y);
+        }
+        double distance = numeric_limits<double>::infinity();
+        for (size_t i = 0; i < polygon.size(); i++)
+        {
+            distance = min(distance, SegmentDistance(p, polygon[i], polygon[(i + 1) % polygon.size()]));
+        }
+        return distance;
+    }
+}
+
+EpsKernel::EpsKernel(double eps) : epsilon(min(1.0, max(1e-6, eps)))
+{
+    //a multiple of 4, so every direction has its opposite for Diameter
+    const size_t m = ((size_t)ceil(2 * Pi / sqrt(epsilon)) + 3) / 4 * 4;
+    step = 2 * Pi / m;
+    for (size_t j = 0; j < m; j++)
+    {
+        directions.push_back(Point2D{ cos(j * step), sin(j * step) });
+    }
+    //each pseudo angle bucket widened out to the anchors around it, so Refresh can look cosines up
+    const size_t buckets = m / 2;
+    for (size_t b = 0; b < buckets; b++)
+    {
+        const double from = AngleOf(4.0 * b / buckets);
+        const double to = b + 1 == buckets ? 2 * Pi : AngleOf(4.0 * (b + 1) / buckets);
+        bucketFirst.push_back((long)floor(from / step));
+        bucketLast.push_back((long)ceil(to / step));
+    }
+    for (size_t d = 0; d < m / 4; d++)
+    {
+        cosines.push_back(cos(d * step));
+        sines.push_back(sin(d * step));
+    }
+    Clear();
+}
+
+void EpsKernel::Clear()
+{
+    count = 0;
+    center = Point2D{ 0, 0 };
+    radius = 0;
+    anchorRadius = 0;
+    nearest.clear();
+    nearestDistance2.clear();
+    farthestNearest2 = 0;
+    extreme.clear();
+    extent.clear();
+    smallestExtent = 0;
+    bucketReach.assign(bucketFirst.size(), 0);
+    changes = 0;
+    kernel.clear();
+    kernelValid = false;
+}
+
+void EpsKernel::Add(const PointSpan& points)
+{
+    HULL_SCOPE("EpsKernel::Add");
+    for (size_t i = 0; i < points.count; i++)
+    {
+        Add(points[i]);
+    }
+}
+
+void EpsKernel::Add(const Point2D& p)
+{
+    if (count++ == 0)
+    {
+        //the first point is the centre, and everything until a second one turns up
+        center = p;
+        nearest.assign(directions.size(), p);
+        nearestDistance2.assign(directions.size(), 0);
+        extreme.assign(directions.size(), p);
+        extent.assign(directions.size(), 0);
+        kernelValid = false;
+        return;
+    }
+    const double dx = p.x - center.x;
+    const double dy = p.y - center.y;
+    const double distance = sqrt(dx * dx + dy * dy);
+    if (distance > radius)
+    {
+        Grow(distance);
+    }
+    if (radius == 0)
+    {
+        return;
+    }
+    const size_t buckets = bucketReach.size();
+    const size_t b = min(buckets - 1, (size_t)(PseudoAngle(dx, dy) * buckets / 4));
+    if (distance < bucketReach[b])
+    {
+        return;
+    }
+    Offer(p, dx, dy, distance);
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   EpsKernel::Grow
+
+  Summary:  Moves the anchors out to twice the distance of a point
+            that fell outside the circle, and finds the nearest point
+            to each of them again among the kernel so far. The extremes
+            stay as they are, since they do not depend on the anchors;
+            each one starts as its anchor's nearest point, so the
+            pruning in Offer works from the first candidate on.
+
+  Args:     double distance
+              of the new point from the centre
+
+  Modifies: [radius, anchorRadius, nearest, nearestDistance2, farthestNearest2].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void EpsKernel::Grow(double distance)
+{
+    const vector<Point2D> candidates = Points();
+    fill(bucketReach.begin(), bucketReach.end(), 0.0);
+    radius = 2 * distance;
+    anchorRadius = AnchorScale * radius;
+    for (size_t j = 0; j < directions.size(); j++)
+    {
+        const double ax = center.x + anchorRadius * directions[j].x - extreme[j].x;
+        const double ay = center.y + anchorRadius * directions[j].y - extreme[j].y;
+        nearest[j] = extreme[j];
+        nearestDistance2[j] = ax * ax + ay * ay;
+    }
+    Refresh();
+    for (const Point2D& p : candidates)
+    {
+        const double dx = p.x - center.x;
+        const double dy = p.y - center.y;
+        Offer(p, dx, dy, hypot(dx, dy));
+    }
+    Refresh();
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   EpsKernel::AngleRange
+
+  Summary:  The anchors j for which directions[j] . d can exceed
+            threshold, with d the point's offset from the centre: those
+            within acos(threshold / |d|) of d's own angle, widened by
+            one on each side for rounding.
+
+  Args:     double dx, dy, distance
+              the offset and its length
+            double threshold
+              the value to beat
+            long& first, long& last
+              receive the range, to be taken modulo the anchor count
+
+  Returns:  bool
+              false if no anchor can
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool EpsKernel::AngleRange(double dx, double dy, double distance, double threshold, long& first, long& last) const
+{
+    if (threshold >= distance)
+    {
+        return false;
+    }
+    const long m = (long)directions.size();
+    if (threshold <= -distance)
+    {
+        first = 0;
+        last = m - 1;
+        return true;
+    }
+    const double angle = atan2(dy, dx);
+    const double spread = acos(threshold / distance);
+    first = (long)floor((angle - spread) / step) - 1;
+    last = (long)ceil((angle + spread) / step) + 1;
+    if (last - first + 1 >= m)
+    {
+        first = 0;
+        last = m - 1;
+    }
+    return true;
+}
+
+//p as a candidate extreme and nearest point for the anchors it can matter to
+void EpsKernel::Offer(const Point2D& p, double dx, double dy, double distance)
+{
+    const long m = (long)directions.size();
+    long first = 0;
+    long last = 0;
+    if (AngleRange(dx, dy, distance, smallestExtent, first, last))
+    {
+        for (long k = first; k <= last; k++)
+        {
+            const size_t j = (size_t)((k % m + m) % m);
+            const double along = directions[j].x * dx + directions[j].y * dy;
+            if (along > extent[j])
+            {
+                extent[j] = along;
+                extreme[j] = p;
+                changes++;
+            }
+        }
+    }
+    //|anchor - p|^2 = R^2 + |d|^2 - 2R directions[j] . d, so only a large enough dot product can win
+    const double threshold = (anchorRadius * anchorRadius + distance * distance - farthestNearest2) / (2 * anchorRadius);
+    if (AngleRange(dx, dy, distance, threshold, first, last))
+    {
+        for (long k = first; k <= last; k++)
+        {
+            const size_t j = (size_t)((k % m + m) % m);
+            const double ax = anchorRadius * directions[j].x - dx;
+            const double ay = anchorRadius * directions[j].y - dy;
+            const double distance2 = ax * ax + ay * ay;
+            if (distance2 < nearestDistance2[j])
+            {
+                nearestDistance2[j] = distance2;
+                nearest[j] = p;
+                changes++;
+            }
+        }
+    }
+    if (changes >= directions.size())
+    {
+        Refresh();
+    }
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   EpsKernel::Refresh
+
+  Summary:  Works out again the bounds Add and Offer prune with. A
+            point can only change the kernel if directions[j] . d
+            exceeds extent[j], or if it lies inside the disc about
+            anchor j through nearest[j], for some j. Outside all of
+            those the point changes nothing, and that region holds the
+            centre (once no disc covers it), so a lower bound of its
+            radius over each angular bucket lets most points through
+            with one compare. Every bound only goes stale in the safe
+            direction as extents grow and discs shrink, so they are
+            redone once per m changes.
+
+  Modifies: [smallestExtent, farthestNearest2, bucketReach, changes].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void EpsKernel::Refresh()
+{
+    HULL_SCOPE("EpsKernel::Refresh");
+    smallestExtent = *min_element(extent.begin(), extent.end());
+    farthestNearest2 = *max_element(nearestDistance2.begin(), nearestDistance2.end());
+    changes = 0;
+    kernelValid = false;
+
+    const long m = (long)directions.size();
+    vector<double> offset(m);
+    double smallestOffset = numeric_limits<double>::infinity();
+    bool centreCovered = false;
+    for (long j = 0; j < m; j++)
+    {
+        const double nearestRadius = sqrt(nearestDistance2[j]);
+        offset[j] = max(0.0, min(extent[j], anchorRadius - nearestRadius));
+        smallestOffset = min(smallestOffset, offset[j]);
+        centreCovered = centreCovered || nearestRadius >= anchorRadius;
+    }
+    //a point at the centre itself would be nearer some anchor, which happens while few points are in
+    if (centreCovered)
+    {
+        fill(bucketReach.begin(), bucketReach.end(), 0.0);
+        return;
+    }
+    //how far out from the centre, at d steps from anchor j, a point can lie and still be no
+    //nearer the anchor than its nearest point and no further along than its extreme
+    const auto along = [&](long j, long d)
+    {
+        j = (j % m + m) % m;
+        const double c = cosines[d];
+        const double s = sines[d];
+        double limit = c > 0 ? extent[j] / c : numeric_limits<double>::infinity();
+        const double clearance = nearestDistance2[j] - anchorRadius * anchorRadius * s * s;
+        if (clearance >= 0)
+        {
+            limit = min(limit, max(0.0, anchorRadius * c - sqrt(clearance)));
+        }
+        return limit;
+    };
+    //over a bucket, the anchors inside it count at their own angle and those d steps outside
+    //at d steps, the nearest a ray through the bucket can pass them; both limits only grow
+    //with the angle, and from at least offset[j] / cos, which stops the search
+    for (size_t b = 0; b < bucketReach.size(); b++)
+    {
+        double reach = numeric_limits<double>::infinity();
+        for (long j = bucketFirst[b]; j <= bucketLast[b]; j++)
+        {
+            reach = min(reach, along(j, 0));
+        }
+        for (long d = 1; d < (long)cosines.size() && smallestOffset / cosines[d] < reach; d++)
+        {
+            reach = min(reach, along(bucketFirst[b] - d, d));
+            reach = min(reach, along(bucketLast[b] + d, d));
+        }
+        bucketReach[b] = reach * (1 - RoundingMargin);
+    }
+}
+
+const vector<Point2D>& EpsKernel::Points()
+{
+    if (!kernelValid)
+    {
+        kernel = nearest;
+        kernel.insert(kernel.end(), extreme.begin(), extreme.end());
+        sort(kernel.begin(), kernel.end(), Less);
+        kernel.erase(unique(kernel.begin(), kernel.end(),
+            [](const Point2D& a, const Point2D& b) { return a.x == b.x && a.y == b.y; }), kernel.end());
+        kernelValid = true;
+    }
+    return kernel;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   EpsKernel::ErrorBound
+
+  Summary:  Every point seen lies inside the support lines of the
+            extremes, so within the polygon they enclose, and the
+            distance from the kernel's hull is largest at one of that
+            polygon's corners. A margin covers the rounding.
+
+  Returns:  double
+              a bound on the Hausdorff distance between the hulls of
+              the kernel and of every point added
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+double EpsKernel::ErrorBound()
+{
+    if (radius == 0)
+    {
+        return 0;
+    }
+    const vector<Point2D>& points = Points();
+    vector<uint32_t> index;
+    vector<Point2D> hull;
+    QuickHull(points, index);
+    HullVertices(points.data(), index, hull);
+
+    const size_t m = directions.size();
+    double bound = 0;
+    for (size_t j = 0; j < m; j++)
+    {
+        const Point2D& d = directions[j];
+        const Point2D& e = directions[(j + 1) % m];
+        const double h = extent[j];
+        const double g = extent[(j + 1) % m];
+        const double det = d.x * e.y - d.y * e.x;
+        const Point2D corner = { center.x + (h * e.y - g * d.y) / det, center.y + (d.x * g - e.x * h) / det };
+        bound = max(bound, PolygonDistance(corner, hull));
+    }
+    return bound + RoundingMargin * radius;
+}
+
+//within a factor cos(step / 2) of the true diameter
+double EpsKernel::Diameter() const
+{
+    const size_t m = directions.size();
+    double diameter = 0;
+    for (size_t j = 0; j < m / 2 && count > 0; j++)
+    {
+        diameter = max(diameter, extent[j] + extent[j + m / 2]);
+    }
+    return diameter;
+}
@@ -0,0 +1,101 @@
+#ifndef _EPSKERNEL_H
+#define _EPSKERNEL_H
+
+#include <cstddef>
+#include <vector>
+
+#include "geometry.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    EpsKernel
+
+  Summary:  Streaming ε-kernel: a small subset of a point cloud whose
+            hull is within ε times the cloud's diameter of the hull of
+            the whole cloud, found in one pass and O(1/√ε) memory, so
+            it can stand in for the cloud ahead of any hull, Minkowski
+            or collision routine. Points can come straight from a
+            mapped file through Add(PointSpan).
+
+            The kernel is the Agarwal, Har-Peled and Varadarajan one:
+            m = 2π/√ε anchors on a circle around the cloud, and for
+            each the input point nearest to it. The circle is centred
+            on the first point and doubles its radius whenever a point
+            falls outside it, rebuilding the nearest points from the
+            kernel so far (whose error is at most half the new one,
+            so the errors sum to a constant factor). The extreme point
+            in each anchor's direction is kept as well. The extremes
+            bound the whole cloud by m support lines, so ErrorBound()
+            is a certified Hausdorff distance from the kernel's hull,
+            whatever the input.
+
+            The guarantee is relative to the diameter, not to the width
+            in each direction: that needs an affine normalization of
+            the cloud first, which a single pass cannot know.
+
+            Points that cannot change the kernel are told apart by
+            their distance from the centre against a bound kept per
+            angular bucket, so a point inside costs a distance and a
+            compare; one near the boundary only visits the anchors
+            within the angle where it can be nearest or extreme.
+
+  Methods:  Add
+              Streams points in.
+            Points
+              The kernel, each point once.
+            ErrorBound
+              Largest distance of a point of the cloud's hull from the
+              kernel's hull.
+            Diameter
+              Largest width of the cloud over the kernel directions.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class EpsKernel
+{
+public:
+    //epsilon is clamped to [1e-6, 1]
+    explicit EpsKernel(double epsilon = 0.01);
+
+    void Clear();
+    void Add(const Point2D& p);
+    void Add(const PointSpan& points);
+
+    const std::vector<Point2D>& Points();
+    double ErrorBound();
+    double Diameter() const;
+
+    double Epsilon() const { return epsilon; }
+    size_t Directions() const { return directions.size(); }
+    size_t Count() const { return count; }
+
+private:
+    void   Grow(double distance);
+    void   Offer(const Point2D& p, double dx, double dy, double distance);
+    void   Refresh();
+    bool   AngleRange(double dx, double dy, double distance, double threshold, long& first, long& last) const;
+
+    double                  epsilon;
+    double                  step;           // between anchors, radians
+    std::vector<Point2D>    directions;     // unit, anchor j at center + anchorRadius * directions[j]
+
+    size_t                  count;
+    Point2D                 center;
+    double                  radius;         // every point so far lies within it of center
+    double                  anchorRadius;
+
+    std::vector<Point2D>    nearest;
+    std::vector<double>     nearestDistance2;
+    double                  farthestNearest2;   // largest of nearestDistance2
+    std::vector<Point2D>    extreme;
+    std::vector<double>     extent;         // directions[j] . (extreme[j] - center)
+    double                  smallestExtent;     // smallest of extent
+    std::vector<long>       bucketFirst;    // anchors around each pseudo angle bucket
+    std::vector<long>       bucketLast;
+    std::vector<double>     cosines;        // of 0 to m / 4 anchor steps, exclusive
+    std::vector<double>     sines;
+    std::vector<double>     bucketReach;    // per bucket, a point nearer the centre changes nothing
+    size_t                  changes;        // since the bounds above were worked out
+
+    std::vector<Point2D>    kernel;
+    bool                    kernelValid;
+};
+
+#endif
@@ -0,0 +1,881 @@
+#include "geometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "arena.h"
+
+using namespace std;
+
+namespace
+{
+    /*----------------------------------------------------------------
+        The two ways QuickHull runs its tests on floating point
+        coordinates, float or double, in double. Each pass
+        runs first with RawPredicates, the plain cross products, which
+        note in uncertain whether any result was too near zero for the
+        filter to vouch for its sign; only then is the pass repeated
+        with ExactPredicates. Passes start from scratch, so the second
+        run simply replaces the first. This keeps the filter's branch
+        and its out of line fallback out of the hot loops.
+    ----------------------------------------------------------------*/
+    struct RawPredicates
+    {
+        const OrientFilter& filter;
+        bool                uncertain;
+
+        //Cross(a, b, c), the sign is that of Orientation; the zero of
+        //c on a or b, which every pass meets, is exact as well
+        template <class P>
+        double Orient(const P& a, const P& b, const P& c)
+        {
+            HULL_COUNT(OrientationTests, 1);
+            const double d = Cross(a, b, c);
+            uncertain |= !filter.Certain(d) && !Same(c, a) && !Same(c, b);
+            return d;
+        }
+
+        //Cross(a, b, p) - Cross(a, b, q), the sign is that of CrossDifference
+        template <class P>
+        double Farther(const P& a, const P& b, const P& p, const P& q)
+        {
+            const double d = ((double)b.x - a.x) * ((double)p.y - q.y) - ((double)b.y - a.y) * ((double)p.x - q.x);
+            uncertain |= !filter.Certain(d) && !Same(p, q);
+            return d;
+        }
+
+        template <class P>
+        static bool Same(const P& p, const P& q)
+        {
+            return p.x == q.x && p.y == q.y;
+        }
+    };
+
+    struct ExactPredicates
+    {
+        const OrientFilter& filter;
+
+        template <class P>
+        double Orient(const P& a, const P& b, const P& c)
+        {
+            HULL_COUNT(OrientationTests, 1);
+            return filter.Orient2D(a.x, a.y, b.x, b.y, c.x, c.y);
+        }
+
+        template <class P>
+        double Farther(const P& a, const P& b, const P& p, const P& q)
+        {
+            return filter.CrossDifference(a.x, a.y, b.x, b.y, p.x, p.y, q.x, q.y);
+        }
+    };
+
+    //fixed point cross products are exact as they are
+    struct IntegerPredicates
+    {
+        int64_t Orient(const Point2I& a, const Point2I& b, const Point2I& c)
+        {
+            HULL_COUNT(OrientationTests, 1);
+            return Cross(a, b, c);
+        }
+
+        int64_t Farther(const Point2I& a, const Point2I& b, const Point2I& p, const Point2I& q)
+        {
+            return (int64_t)(b.x - a.x) * (p.y - q.y) - (int64_t)(b.y - a.y) * (p.x - q.x);
+        }
+    };
+
+    /*----------------------------------------------------------------
+        HullPasses<T> is the predicate policy of QuickHull: it runs a
+        pass with the predicates for T coordinates, and Wide is the
+        type their cross products come in. Floating point goes through
+        the filter, fixed point needs nothing.
+    ----------------------------------------------------------------*/
+    template <class T>
+    class HullPasses
+    {
+    public:
+        typedef double Wide;
+
+        explicit HullPasses(double extent) : filter(extent) { }
+
+        template <class Pass>
+        void Run(Pass pass) const
+        {
+            RawPredicates raw{ filter, false };
+            pass(raw);
+            if (raw.uncertain)
+            {
+                ExactPredicates exact{ filter };
+                pass(exact);
+            }
+        }
+
+    private:
+        OrientFilter filter;
+    };
+
+    template <>
+    class HullPasses<int32_t>
+    {
+    public:
+        typedef int64_t Wide;
+
+        explicit HullPasses(double) { }
+
+        template <class Pass>
+        void Run(Pass pass) const
+        {
+            IntegerPredicates exact;
+            pass(exact);
+        }
+    };
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: QuickHull
+
+    Summary:  Headless QuickHull over count points of T coordinates.
+              Same scheme as MainWindow::QuickHull (split on the left
+              and right most points, recurse on the farthest point),
+              but it works on an index array that is partitioned in
+              place and uses an explicit stack instead of recursion, so
+              large or adversarial inputs do not allocate per point or
+              overflow the call stack. The index array and the stack
+              live in scratch.
+
+    Args:     const Points& points
+                points the convex hull will form around, a PointSpan
+                or a Point2I array
+              size_t count
+                number of points
+              vector<uint32_t>& hull
+                receives the hull as indices into points
+              Arena& scratch
+                temporaries, rewound before returning
+              const atomic<bool>* cancel
+                null, or a flag set by another thread to stop early;
+                checked before every task
+
+    Modifies: [hull].
+
+    Returns:  bool
+                false if cancelled, with hull empty
+-----------------------------------------------------------------F-F*/
+template <class T, class Points>
+bool QuickHullCore(const Points& points, size_t count, vector<uint32_t>& hull, Arena& scratch, const atomic<bool>* cancel)
+{
+    typedef typename HullPasses<T>::Wide Wide;
+    HULL_SCOPE("QuickHull");
+    hull.clear();
+    if (count == 0)
+    {
+        return true;
+    }
+    ArenaScope scope(scratch);
+
+    uint32_t left = 0;
+    uint32_t right = 0;
+    T minY = points[0].y;
+    T maxY = points[0].y;
+    for (uint32_t i = 1; i < count; i++)
+    {
+        const Point2<T> p = points[i];
+        if (p.x < points[left].x || (p.x == points[left].x && p.y < points[left].y))
+        {
+            left = i;
+        }
+        if (p.x > points[right].x || (p.x == points[right].x && p.y > points[right].y))
+        {
+            right = i;
+        }
+        minY = min(minY, p.y);
+        maxY = max(maxY, p.y);
+    }
+    const HullPasses<T> passes(max((double)points[right].x - points[left].x, (double)maxY - minY));
+
+    hull.push_back(left);
+    if (left == right)
+    {
+        return true;
+    }
+
+    // Points below left->right go first, points above it after them.
+    ArenaVector<uint32_t> index{ ArenaAllocator<uint32_t>(scratch) };
+    index.reserve(count);
+    size_t lowerEnd = 0;
+    passes.Run([&](auto& predicates)
+    {
+        index.clear();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (predicates.Orient(points[left], points[right], points[i]) < 0)
+            {
+                index.push_back(i);
+            }
+        }
+        lowerEnd = index.size();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (predicates.Orient(points[right], points[left], points[i]) < 0)
+            {
+                index.push_back(i);
+            }
+        }
+    });
+
+    // A task either emits a vertex (lo == hi == npos) or finds the hull
+    // of index[lo, hi) outside the edge a->b.
+    struct Task
+    {
+        uint32_t a;
+        uint32_t b;
+        size_t   lo;
+        size_t   hi;
+    };
+    const size_t emit = (size_t)-1;
+
+    ArenaVector<Task> stack{ ArenaAllocator<Task>(scratch) };
+    stack.reserve(64);
+    stack.push_back({ right, left, lowerEnd, index.size() });
+    stack.push_back({ right, 0, emit, emit });
+    stack.push_back({ left, right, 0, lowerEnd });
+
+    while (!stack.empty())
+    {
+        if (cancel && cancel->load(memory_order_relaxed))
+        {
+            hull.clear();
+            return false;
+        }
+        HULL_COUNT(QuickHullTasks, 1);
+        HULL_MAX(QuickHullMaxStack, stack.size());
+        const Task task = stack.back();
+        stack.pop_back();
+
+        if (task.lo == emit)
+        {
+            hull.push_back(task.a);
+            continue;
+        }
+        if (task.lo == task.hi)
+        {
+            continue;
+        }
+
+        const Point2<T> a = points[task.a];
+        const Point2<T> b = points[task.b];
+        // Farthest point from a->b. On ties take the one nearest a
+        // along a->b, otherwise a point in the middle of an edge that
+        // runs parallel to a->b would be reported as a vertex.
+        const Wide dx = (Wide)b.x - a.x;
+        const Wide dy = (Wide)b.y - a.y;
+        size_t far = task.lo;
+        passes.Run([&](auto& predicates)
+        {
+            far = task.lo;
+            Point2<T> farPoint = points[index[far]];
+            Wide farAlong = ((Wide)farPoint.x - a.x) * dx + ((Wide)farPoint.y - a.y) * dy;
+            for (size_t i = task.lo + 1; i < task.hi; i++)
+            {
+                const Point2<T> p = points[index[i]];
+                // The points are right of a->b, so the farther one has
+                // the more negative cross product.
+                const Wide compare = predicates.Farther(a, b, p, farPoint);
+                if (compare > 0)
+                {
+                    continue;
+                }
+                const Wide along = ((Wide)p.x - a.x) * dx + ((Wide)p.y - a.y) * dy;
+                if (compare < 0 || along < farAlong)
+                {
+                    farPoint = p;
+                    farAlong = along;
+                    far = i;
+                }
+            }
+        });
+        const uint32_t top = index[far];
+        const Point2<T> c = points[top];
+
+        // Partition in place: [lo, mid) outside a->top, [mid, end) outside top->b.
+        size_t mid = task.lo;
+        size_t end = task.lo;
+        passes.Run([&](auto& predicates)
+        {
+            mid = task.lo;
+            for (size_t i = task.lo; i < task.hi; i++)
+            {
+                if (predicates.Orient(a, c, points[index[i]]) < 0)
+                {
+                    swap(index[i], index[mid++]);
+                }
+            }
+            end = mid;
+            for (size_t i = mid; i < task.hi; i++)
+            {
+                if (predicates.Orient(c, b, points[index[i]]) < 0)
+                {
+                    swap(index[i], index[end++]);
+                }
+            }
+        });
+
+        stack.push_back({ top, task.b, mid, end });
+        stack.push_back({ top, 0, emit, emit });
+        stack.push_back({ task.a, top, task.lo, mid });
+    }
+    return true;
+}
+
+void QuickHull(const PointSpan& points, vector<uint32_t>& hull, Arena& scratch)
+{
+    QuickHullCore<double>(points, points.count, hull, scratch, nullptr);
+}
+
+void QuickHull(const PointSpan& points, vector<uint32_t>& hull)
+{
+    //one block for the index array, the stack grows into a second only on deep inputs
+    Arena scratch(points.count * sizeof(uint32_t) + 64 * 1024);
+    QuickHull(points, hull, scratch);
+}
+
+template <class T>
+void QuickHull(const Point2<T>* points, size_t count, vector<uint32_t>& hull, Arena& scratch)
+{
+    QuickHullCore<T>(points, count, hull, scratch, nullptr);
+}
+
+template <class T>
+bool QuickHull(const Point2<T>* points, size_t count, vector<uint32_t>& hull, Arena& scratch, const atomic<bool>& cancel)
+{
+    return QuickHullCore<T>(points, count, hull, scratch, &cancel);
+}
+
+template <class T>
+void QuickHull(const Point2<T>* points, size_t count, vector<uint32_t>& hull)
+{
+    Arena scratch(count * sizeof(uint32_t) + 64 * 1024);
+    QuickHull(points, count, hull, scratch);
+}
+
+void HullVertices(const PointSpan& points, const vector<uint32_t>& hull, vector<Point2D>& vertices)
+{
+    vertices.clear();
+    vertices.reserve(hull.size());
+    for (uint32_t i : hull)
+    {
+        vertices.push_back(points[i]);
+    }
+}
+
+template <class T>
+void HullVertices(const Point2<T>* points, const vector<uint32_t>& hull, vector<Point2<T>>& vertices)
+{
+    vertices.clear();
+    vertices.reserve(hull.size());
+    for (uint32_t i : hull)
+    {
+        vertices.push_back(points[i]);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Quantize
+
+    Summary:  Converts points to fixed point in two passes: one for the
+              bounding box, which fixes the grid, and one that scales
+              and rounds every point, with no branches so it
+              vectorizes. The grid step is the smallest power of two
+              that keeps the box within FixedLimit of the origin, and
+              the origin is the center of the box rounded to the grid.
+
+    Args:     const PointSpan& points
+                points to convert
+              vector<Point2I>& fixed
+                receives the points on the grid, in input order, so
+                hull indices of fixed are indices into points
+
+    Modifies: [fixed].
+
+    Returns:  Quantization
+                the grid, to convert results back
+-----------------------------------------------------------------F-F*/
+Quantization Quantize(const PointSpan& points, vector<Point2I>& fixed)
+{
+    HULL_SCOPE("Quantize");
+    Quantization grid{ 0, 0, 1 };
+    fixed.resize(points.count);
+    if (points.count == 0)
+    {
+        return grid;
+    }
+
+    double minX = points[0].x;
+    double maxX = minX;
+    double minY = points[0].y;
+    double maxY = minY;
+    for (size_t i = 1; i < points.count; i++)
+    {
+        const Point2D p = points[i];
+        minX = min(minX, p.x);
+        maxX = max(maxX, p.x);
+        minY = min(minY, p.y);
+        maxY = max(maxY, p.y);
+    }
+
+    //the largest power of two that keeps half the box within FixedLimit
+    //less one step, the step to spare covers rounding the origin
+    const double half = max(maxX - minX, maxY - minY) / 2;
+    const double room = (FixedLimit - 1) / half;
+    if (half > 0 && isfinite(room))
+    {
+        int exponent;
+        frexp(room, &exponent);
+        grid.scale = ldexp(1.0, exponent - 1);
+    }
+    grid.originX = floor((minX + maxX) / 2 * grid.scale + 0.5) / grid.scale;
+    grid.originY = floor((minY + maxY) / 2 * grid.scale + 0.5) / grid.scale;
+
+    for (size_t i = 0; i < points.count; i++)
+    {
+        const Point2D p = points[i];
+        fixed[i].x = (int32_t)floor((p.x - grid.originX) * grid.scale + 0.5);
+        fixed[i].y = (int32_t)floor((p.y - grid.originY) * grid.scale + 0.5);
+    }
+    return grid;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: PointInConvexHull
+
+    Summary:  Headless version of MainWindow::PointInConvexHull. Binary
+              search over the fan of triangles from the first vertex,
+              then one edge test, so O(log n). Points on the boundary
+              count as inside.
+
+    Args:     const Point2<T>& point
+                point being checked
+              const Point2<T>* hull, size_t count
+                convex polygon in hull order
+
+    Returns:  bool
+                true if point is inside or on the polygon
+-----------------------------------------------------------------F-F*/
+template <class T>
+bool PointInConvexHull(const Point2<T>& point, const Point2<T>* hull, size_t count)
+{
+    HULL_COUNT(PointInHullQueries, 1);
+    if (count == 0)
+    {
+        return false;
+    }
+    const Point2<T>& o = hull[0];
+    if (count == 1)
+    {
+        return point.x == o.x && point.y == o.y;
+    }
+    if (count == 2)
+    {
+        const Point2<T>& b = hull[1];
+        return Orientation(o, b, point) == 0
+            && min(o.x, b.x) <= point.x && point.x <= max(o.x, b.x)
+            && min(o.y, b.y) <= point.y && point.y <= max(o.y, b.y);
+    }
+
+    if (Orientation(o, hull[1], point) < 0 || Orientation(o, hull[count - 1], point) > 0)
+    {
+        return false;
+    }
+    size_t lo = 1;
+    size_t hi = count - 2;
+    while (lo < hi)
+    {
+        const size_t mid = (lo + hi + 1) / 2;
+        if (Orientation(o, hull[mid], point) >= 0)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return Orientation(hull[lo], hull[lo + 1], point) >= 0;
+}
+
+namespace
+{
+    //index of the lowest vertex, left most among equals
+    template <class T>
+    size_t LowestVertex(const Point2<T>* polygon, size_t count)
+    {
+        size_t lowest = 0;
+        for (size_t i = 1; i < count; i++)
+        {
+            if (polygon[i].y < polygon[lowest].y || (polygon[i].y == polygon[lowest].y && polygon[i].x < polygon[lowest].x))
+            {
+                lowest = i;
+            }
+        }
+        return lowest;
+    }
+
+    //drops collinear vertices left by nearly parallel edges and starts the polygon at its left most vertex
+    template <class T>
+    void NormalizeHull(vector<Point2<T>>& polygon, Arena& scratch)
+    {
+        ArenaScope scope(scratch);
+        ArenaVector<Point2<T>> kept{ ArenaAllocator<Point2<T>>(scratch) };
+        kept.reserve(polygon.size());
+        for (size_t i = 0; i < polygon.size(); i++)
+        {
+            const Point2<T>& prev = kept.empty() ? polygon.back() : kept.back();
+            const Point2<T>& next = polygon[(i + 1) % polygon.size()];
+            if (Orientation(prev, polygon[i], next) > 0)
+            {
+                kept.push_back(polygon[i]);
+            }
+        }
+        size_t left = 0;
+        for (size_t i = 1; i < kept.size(); i++)
+        {
+            if (kept[i].x < kept[left].x || (kept[i].x == kept[left].x && kept[i].y < kept[left].y))
+            {
+                left = i;
+            }
+        }
+        //kept is never longer than polygon, so this reuses polygon's storage
+        polygon.assign(kept.begin() + left, kept.end());
+        polygon.insert(polygon.end(), kept.begin(), kept.begin() + left);
+    }
+
+    //sign of (na - pa) x (nb - pb), exact, so parallel edges merge
+    template <class T>
+    int EdgeTurn(const Point2<T>& pa, const Point2<T>& na, const Point2<T>& pb, const Point2<T>& nb)
+    {
+        const double d = Predicates::DifferenceProducts(na.x, pa.x, nb.y, pb.y, na.y, pa.y, nb.x, pb.x);
+        return (d > 0) - (d < 0);
+    }
+
+    int EdgeTurn(const Point2I& pa, const Point2I& na, const Point2I& pb, const Point2I& nb)
+    {
+        const int64_t d = (int64_t)(na.x - pa.x) * (nb.y - pb.y) - (int64_t)(na.y - pa.y) * (nb.x - pb.x);
+        return (d > 0) - (d < 0);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: MinkowskiSum
+
+    Summary:  Minkowski sum of two convex polygons. MainWindow adds
+              every pair of vertices and hulls the n * m results; here
+              the edges of both polygons are merged by angle starting
+              from their lowest vertices, which gives the sum's
+              vertices directly in O(n + m). Polygons with fewer than
+              three vertices go through the pairwise sum instead.
+
+    Args:     const Point2<T>* a, size_t countA
+                first convex polygon in hull order
+              const Point2<T>* b, size_t countB
+                second convex polygon in hull order
+              vector<Point2<T>>& sum
+                receives the sum in hull order
+              Arena& scratch
+                temporaries, rewound before returning
+
+    Modifies: [sum].
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+template <class T>
+void MinkowskiSum(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, vector<Point2<T>>& sum, Arena& scratch)
+{
+    HULL_SCOPE("MinkowskiSum");
+    sum.clear();
+    if (countA == 0 || countB == 0)
+    {
+        return;
+    }
+
+    if (countA < 3 || countB < 3)
+    {
+        ArenaScope scope(scratch);
+        ArenaVector<Point2<T>> pairs{ ArenaAllocator<Point2<T>>(scratch) };
+        pairs.reserve(countA * countB);
+        for (size_t i = 0; i < countA; i++)
+        {
+            for (size_t j = 0; j < countB; j++)
+            {
+                pairs.push_back(Point2<T>{ T(a[i].x + b[j].x), T(a[i].y + b[j].y) });
+            }
+        }
+        //the only heap use left: a point or segment operand, which needs the index hull
+        vector<uint32_t> hull;
+        QuickHull(pairs.data(), pairs.size(), hull, scratch);
+        HullVertices(pairs.data(), hull, sum);
+        HULL_COUNT(MinkowskiPoints, pairs.size());
+        return;
+    }
+
+    const size_t startA = LowestVertex(a, countA);
+    const size_t startB = LowestVertex(b, countB);
+    sum.reserve(countA + countB);
+    size_t i = 0;
+    size_t j = 0;
+    while (i < countA || j < countB)
+    {
+        const Point2<T>& pa = a[(startA + i) % countA];
+        const Point2<T>& pb = b[(startB + j) % countB];
+        sum.push_back(Point2<T>{ T(pa.x + pb.x), T(pa.y + pb.y) });
+
+        const Point2<T>& na = a[(startA + i + 1) % countA];
+        const Point2<T>& nb = b[(startB + j + 1) % countB];
+        const int turn = EdgeTurn(pa, na, pb, nb);
+        if (j == countB || (i < countA && turn > 0))
+        {
+            i++;
+        }
+        else if (i == countA || turn < 0)
+        {
+            j++;
+        }
+        else
+        {
+            i++;
+            j++;
+        }
+    }
+    HULL_COUNT(MinkowskiPoints, sum.size());
+    NormalizeHull(sum, scratch);
+}
+
+template <class T>
+void MinkowskiSum(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, vector<Point2<T>>& sum)
+{
+    Arena scratch;
+    MinkowskiSum(a, countA, b, countB, sum, scratch);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: MinkowskiDifference
+
+    Summary:  a + (-b). Negating a polygon turns it half way around, so
+              -b is still counter-clockwise and goes straight into
+              MinkowskiSum. Unlike MainWindow::MinkowskiDiff the result
+              is not shifted to a graph origin.
+
+    Args:     const Point2<T>* a, size_t countA
+                first convex polygon in hull order
+              const Point2<T>* b, size_t countB
+                convex polygon subtracted from a
+              vector<Point2<T>>& difference
+                receives the difference in hull order
+              Arena& scratch
+                temporaries, rewound before returning
+
+    Modifies: [difference].
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+template <class T>
+void MinkowskiDifference(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, vector<Point2<T>>& difference,
+    Arena& scratch)
+{
+    ArenaScope scope(scratch);
+    Point2<T>* negated = scratch.Allocate<Point2<T>>(countB);
+    for (size_t i = 0; i < countB; i++)
+    {
+        negated[i] = Point2<T>{ T(-b[i].x), T(-b[i].y) };
+    }
+    MinkowskiSum(a, countA, negated, countB, difference, scratch);
+}
+
+template <class T>
+void MinkowskiDifference(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, vector<Point2<T>>& difference)
+{
+    Arena scratch;
+    MinkowskiDifference(a, countA, b, countB, difference, scratch);
+}
+
+namespace
+{
+    inline double Dot(const Point2D& u, const Point2D& v)
+    {
+        return u.x * v.x + u.y * v.y;
+    }
+
+    //the vertex farthest along direction, taken in double whatever T is
+    template <class T>
+    const Point2<T>& Support(const Point2<T>* polygon, size_t count, const Point2D& direction)
+    {
+        size_t best = 0;
+        double bestDot = polygon[0].x * direction.x + polygon[0].y * direction.y;
+        for (size_t i = 1; i < count; i++)
+        {
+            const double d = polygon[i].x * direction.x + polygon[i].y * direction.y;
+            if (d > bestDot)
+            {
+                bestDot = d;
+                best = i;
+            }
+        }
+        return polygon[best];
+    }
+
+    //closest point to the origin on segment p->q; shrinks the simplex to the feature it lies on
+    Point2D ClosestOnSegment(Point2D* simplex, size_t& size, size_t first, size_t second)
+    {
+        const Point2D p = simplex[first];
+        const Point2D q = simplex[second];
+        const Point2D edge{ q.x - p.x, q.y - p.y };
+        const double length2 = Dot(edge, edge);
+        const double t = length2 > 0 ? -Dot(p, edge) / length2 : 0;
+        if (t <= 0)
+        {
+            simplex[0] = p;
+            size = 1;
+            return p;
+        }
+        if (t >= 1)
+        {
+            simplex[0] = q;
+            size = 1;
+            return q;
+        }
+        simplex[0] = p;
+        simplex[1] = q;
+        size = 2;
+        return Point2D{ p.x + t * edge.x, p.y + t * edge.y };
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: GjkIntersect
+
+    Summary:  Gilbert-Johnson-Keerthi test: two convex polygons
+              intersect when the origin lies in their Minkowski
+              difference. MainWindow's GJK mode builds that difference
+              and tests the origin against its hull; this walks a
+              simplex of support points towards the origin instead and
+              never builds the difference. Touching counts as
+              intersecting, up to rounding in the support points. The
+              simplex is kept in double for every T; differences of
+              float or fixed point vertices are exact there.
+
+    Args:     const Point2<T>* a, size_t countA
+                first convex polygon (any vertex order)
+              const Point2<T>* b, size_t countB
+                second convex polygon (any vertex order)
+              size_t* iterations
+                optional, receives the number of support queries
+
+    Returns:  bool
+                true if the polygons intersect
+-----------------------------------------------------------------F-F*/
+template <class T>
+bool GjkIntersect(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, size_t* iterations)
+{
+    HULL_SCOPE("GjkIntersect");
+    if (iterations)
+    {
+        *iterations = 0;
+    }
+    if (countA == 0 || countB == 0)
+    {
+        return false;
+    }
+
+    auto support = [&](const Point2D& d)
+    {
+        const Point2<T>& pa = Support(a, countA, d);
+        const Point2<T>& pb = Support(b, countB, Point2D{ -d.x, -d.y });
+        return Point2D{ (double)pa.x - pb.x, (double)pa.y - pb.y };
+    };
+    const Point2D origin{ 0, 0 };
+
+    Point2D simplex[3];
+    size_t size = 1;
+    simplex[0] = support(Point2D{ 1, 0 });
+    Point2D v = simplex[0];
+
+    //the difference has at most countA * countB vertices and GJK never revisits one
+    const size_t limit = 64 + countA + countB;
+    for (size_t step = 1; step <= limit; step++)
+    {
+        if (iterations)
+        {
+            *iterations = step;
+        }
+        const double vv = Dot(v, v);
+        if (vv == 0)
+        {
+            return true;
+        }
+
+        const Point2D w = support(Point2D{ -v.x, -v.y });
+        if (Dot(w, v) > 0)
+        {
+            //-v separates the origin from the difference
+            return false;
+        }
+        if (vv - Dot(w, v) <= 1e-12 * vv)
+        {
+            //no progress: v is the closest point and it is not the origin
+            return false;
+        }
+
+        simplex[size++] = w;
+        if (size == 2)
+        {
+            v = ClosestOnSegment(simplex, size, 0, 1);
+            continue;
+        }
+
+        const int turn = Orientation(simplex[0], simplex[1], simplex[2]);
+        if (turn != 0
+            && Orientation(simplex[0], simplex[1], origin) * turn >= 0
+            && Orientation(simplex[1], simplex[2], origin) * turn >= 0
+            && Orientation(simplex[2], simplex[0], origin) * turn >= 0)
+        {
+            return true;
+        }
+
+        //the closest point lies on one of the two edges through the new vertex
+        Point2D edges[2][3] = { { simplex[0], simplex[2] }, { simplex[1], simplex[2] } };
+        size_t sizes[2];
+        Point2D closest[2];
+        for (int e = 0; e < 2; e++)
+        {
+            closest[e] = ClosestOnSegment(edges[e], sizes[e], 0, 1);
+        }
+        const int best = Dot(closest[0], closest[0]) <= Dot(closest[1], closest[1]) ? 0 : 1;
+        size = sizes[best];
+        for (size_t k = 0; k < size; k++)
+        {
+            simplex[k] = edges[best][k];
+        }
+        v = closest[best];
+    }
+    return Dot(v, v) == 0;
+}
+
+/*--------------------------------------------------------------------
+    The instantiations geometry.h promises, one set per scalar type.
+--------------------------------------------------------------------*/
+#define INSTANTIATE_GEOMETRY_KERNEL(T) \
+    template void QuickHull<T>(const Point2<T>*, size_t, vector<uint32_t>&); \
+    template void QuickHull<T>(const Point2<T>*, size_t, vector<uint32_t>&, Arena&); \
+    template bool QuickHull<T>(const Point2<T>*, size_t, vector<uint32_t>&, Arena&, const atomic<bool>&); \
+    template void HullVertices<T>(const Point2<T>*, const vector<uint32_t>&, vector<Point2<T>>&); \
+    template bool PointInConvexHull<T>(const Point2<T>&, const Point2<T>*, size_t); \
+    template void MinkowskiSum<T>(const Point2<T>*, size_t, const Point2<T>*, size_t, vector<Point2<T>>&); \
+    template void MinkowskiSum<T>(const Point2<T>*, size_t, const Point2<T>*, size_t, vector<Point2<T>>&, Arena&); \
+    template void MinkowskiDifference<T>(const Point2<T>*, size_t, const Point2<T>*, size_t, vector<Point2<T>>&); \
+    template void MinkowskiDifference<T>(const Point2<T>*, size_t, const Point2<T>*, size_t, vector<Point2<T>>&, Arena&); \
+    template bool GjkIntersect<T>(const Point2<T>*, size_t, const Point2<T>*, size_t, size_t*);
+
+INSTANTIATE_GEOMETRY_KERNEL(float)
+INSTANTIATE_GEOMETRY_KERNEL(double)
+INSTANTIATE_GEOMETRY_KERNEL(int32_t)
+
+#undef INSTANTIATE_GEOMETRY_KERNEL
@@ -0,0 +1,234 @@
+#ifndef _GEOMETRY_H
+#define _GEOMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "instrument.h"
+#include "predicates.h"
+
+class Arena;
+
+/*--------------------------------------------------------------------
+    Headless geometry kernel used by the engines that run outside of
+    MainWindow. Nothing in here may pull in windows.h or d2d1.h.
+
+    Orientation convention: counter-clockwise in a y-up frame, so a
+    positive Cross(a, b, c) means c lies to the left of the line a->b.
+    Hulls are reported as indices into the input, counter-clockwise,
+    starting at the left most point, without collinear vertices.
+
+    Routines that need temporaries have an overload taking an Arena
+    for them; it is rewound before they return, so a caller that keeps
+    one arena across calls makes no heap allocations once it has grown.
+    The overloads without one use a private arena per call.
+
+    Points are Point2<T> for three scalar types: Point2D (double,
+    exact predicates through the filters in predicates.h), Point2F
+    (float, half the memory, the same predicates on the promoted
+    values, so still exact) and Point2I (int32 fixed point, exact
+    predicates in plain int64 arithmetic). Quantize turns double input
+    into fixed point.
+
+    The engines below are templates on T. Their definitions live in
+    geometry.cpp, which instantiates each of them for float, double
+    and int32_t; every instantiation is resolved at compile time, with
+    no virtual dispatch, and any other T fails to link. Inside, the
+    predicate policy for T picks how cross products are widened and
+    whether a result needs the exact fallback.
+--------------------------------------------------------------------*/
+
+template <class T>
+struct Point2
+{
+    T x;
+    T y;
+};
+
+typedef Point2<double>  Point2D;
+typedef Point2<float>   Point2F;
+typedef Point2<int32_t> Point2I;
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Cross
+
+    Summary:  Cross product of (b - a) and (c - a). Twice the signed
+              area of the triangle a, b, c, rounded; decisions go
+              through Orientation.
+-----------------------------------------------------------------F-F*/
+inline double Cross(const Point2D& a, const Point2D& b, const Point2D& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Orientation
+
+    Summary:  Exact sign of Cross(a, b, c). Every engine goes through
+              this function (or, in QuickHull, a filter that gives the
+              same answers) for its left/right decisions, so nearly
+              collinear input gets consistent answers.
+
+    Returns:  int
+                +1 if c is left of a->b, -1 if right, 0 if collinear
+-----------------------------------------------------------------F-F*/
+inline int Orientation(const Point2D& a, const Point2D& b, const Point2D& c)
+{
+    HULL_COUNT(OrientationTests, 1);
+    const double d = Orient2D(a.x, a.y, b.x, b.y, c.x, c.y);
+    return (d > 0) - (d < 0);
+}
+
+//floats convert to double exactly, so these are Cross and Orientation on the promoted points
+inline double Cross(const Point2F& a, const Point2F& b, const Point2F& c)
+{
+    return ((double)b.x - a.x) * ((double)c.y - a.y) - ((double)b.y - a.y) * ((double)c.x - a.x);
+}
+
+inline int Orientation(const Point2F& a, const Point2F& b, const Point2F& c)
+{
+    HULL_COUNT(OrientationTests, 1);
+    const double d = Orient2D(a.x, a.y, b.x, b.y, c.x, c.y);
+    return (d > 0) - (d < 0);
+}
+
+/*--------------------------------------------------------------------
+    Fixed point coordinates must lie within [-FixedLimit, FixedLimit].
+    Then a coordinate difference fits an int32, a product of two is
+    below 2^62 and a cross product fits an int64 exactly, so the
+    integer predicates are exact with no filter and no branch.
+--------------------------------------------------------------------*/
+const int32_t FixedLimit = (1 << 30) - 1;
+
+inline int64_t Cross(const Point2I& a, const Point2I& b, const Point2I& c)
+{
+    return (int64_t)(b.x - a.x) * (c.y - a.y) - (int64_t)(b.y - a.y) * (c.x - a.x);
+}
+
+inline int Orientation(const Point2I& a, const Point2I& b, const Point2I& c)
+{
+    HULL_COUNT(OrientationTests, 1);
+    const int64_t d = Cross(a, b, c);
+    return (d > 0) - (d < 0);
+}
+
+/*--------------------------------------------------------------------
+    Read-only view of count points whose x and y values sit stride
+    doubles apart. An array of Point2D (or a mapped file of xy pairs)
+    is stride 2, two separate x and y arrays are stride 1. Engines take
+    a PointSpan so data can be handed over without copying it.
+--------------------------------------------------------------------*/
+struct PointSpan
+{
+    const double*   x;
+    const double*   y;
+    size_t          count;
+    size_t          stride;
+
+    Point2D operator[](size_t i) const
+    {
+        return Point2D{ x[i * stride], y[i * stride] };
+    }
+};
+
+inline PointSpan MakePointSpan(const Point2D* points, size_t count)
+{
+    return points ? PointSpan{ &points->x, &points->y, count, 2 } : PointSpan{ nullptr, nullptr, 0, 2 };
+}
+
+inline PointSpan MakePointSpan(const double* x, const double* y, size_t count)
+{
+    return PointSpan{ x, y, count, 1 };
+}
+
+/*--------------------------------------------------------------------
+    Owning, contiguous point storage in the same x / y layout as the
+    binary point file, for loaders that build point sets on the fly.
+--------------------------------------------------------------------*/
+struct PointBuffer
+{
+    std::vector<double> x;
+    std::vector<double> y;
+
+    size_t    Size() const { return x.size(); }
+    void      Clear() { x.clear(); y.clear(); }
+    void      Push(double px, double py) { x.push_back(px); y.push_back(py); }
+    PointSpan Span() const { return MakePointSpan(x.data(), y.data(), x.size()); }
+};
+
+void QuickHull(const PointSpan& points, std::vector<uint32_t>& hull);
+void QuickHull(const PointSpan& points, std::vector<uint32_t>& hull, Arena& scratch);
+
+template <class T>
+void QuickHull(const Point2<T>* points, size_t count, std::vector<uint32_t>& hull);
+template <class T>
+void QuickHull(const Point2<T>* points, size_t count, std::vector<uint32_t>& hull, Arena& scratch);
+
+//gives up once another thread sets cancel, checked between subproblems: false, with hull empty
+template <class T>
+bool QuickHull(const Point2<T>* points, size_t count, std::vector<uint32_t>& hull, Arena& scratch,
+    const std::atomic<bool>& cancel);
+
+template <class T>
+inline void QuickHull(const std::vector<Point2<T>>& points, std::vector<uint32_t>& hull)
+{
+    QuickHull(points.data(), points.size(), hull);
+}
+
+//hull vertices (counter-clockwise, as QuickHull reports them) gathered from points
+void HullVertices(const PointSpan& points, const std::vector<uint32_t>& hull, std::vector<Point2D>& vertices);
+template <class T>
+void HullVertices(const Point2<T>* points, const std::vector<uint32_t>& hull, std::vector<Point2<T>>& vertices);
+
+/*--------------------------------------------------------------------
+    Float to fixed point conversion. The grid step is a power of two
+    and the origin lies on the grid, so converting is exact whenever
+    the input already sits on a grid that fine (integer input spanning
+    at most 2 * (FixedLimit - 1) always does) and Dequantize gives the
+    input back. Otherwise points are rounded to the nearest grid point,
+    which may merge points closer than a step: a hull of quantized
+    points is then the hull of the input to within half a step in each
+    coordinate.
+--------------------------------------------------------------------*/
+struct Quantization
+{
+    double originX;
+    double originY;
+    double scale;       //grid steps per input unit
+
+    Point2D Dequantize(const Point2I& p) const
+    {
+        return Point2D{ originX + p.x / scale, originY + p.y / scale };
+    }
+};
+
+Quantization Quantize(const PointSpan& points, std::vector<Point2I>& fixed);
+
+/*--------------------------------------------------------------------
+    The routines below take convex polygons as vertex arrays in hull
+    order: counter-clockwise, no collinear vertices. One or two
+    vertices (a point or a segment) are valid polygons.
+--------------------------------------------------------------------*/
+
+template <class T>
+bool PointInConvexHull(const Point2<T>& point, const Point2<T>* hull, size_t count);
+
+//sums of fixed point polygons stay in range while both lie within FixedLimit / 2
+template <class T>
+void MinkowskiSum(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, std::vector<Point2<T>>& sum);
+template <class T>
+void MinkowskiSum(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, std::vector<Point2<T>>& sum,
+    Arena& scratch);
+template <class T>
+void MinkowskiDifference(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB,
+    std::vector<Point2<T>>& difference);
+template <class T>
+void MinkowskiDifference(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB,
+    std::vector<Point2<T>>& difference, Arena& scratch);
+
+template <class T>
+bool GjkIntersect(const Point2<T>* a, size_t countA, const Point2<T>* b, size_t countB, size_t* iterations = nullptr);
+
+#endif
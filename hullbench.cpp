@@ -0,0 +1,604 @@
+/*--------------------------------------------------------------------
+    hullbench: scaling benchmark for the headless geometry kernel.
+
+    Runs QuickHull, PointInConvexHull, MinkowskiSum and the point
+    generators themselves, QuickHull on the points rounded to float
+    (quickhull-float), and Quantize and QuickHull on the quantized
+    int32 points (quickhull-fixed), and BatchHulls over the points cut
+    into sets of 32 (batch-hull, hull size is the sum over the sets),
+    over the pointgen distributions (uniform square, uniform disk,
+    circle, Gaussian, clustered, near collinear and duplicate heavy)
+    for n = 10, 100, ... up to --max-n, and writes one row per case: ns
+    per point, hull size, heap allocations and bytes allocated in one
+    run, and the repetitions timed.
+
+    hullbench [--max-n N] [--dist a,b,..] [--algo a,b,..] [--seed S]
+              [--min-time MS] [--format csv|json] [--out FILE]
+              [--baseline FILE] [--threshold RATIO] [--perf]
+
+    --perf adds hardware counters of the fastest repetition, per
+    point: cycles, instructions (and instructions per cycle), L1 data
+    and last level cache misses and branch misses. A counter the
+    system does not provide (no perf_event_open, a container or VM
+    without a PMU, perf_event_paranoid too high) is left empty; the
+    benchmark itself runs either way.
+
+    With --baseline (a CSV written earlier by hullbench) every case is
+    compared with its baseline row; a case slower than threshold times
+    the baseline (default 1.10), or with a different hull size, is a
+    regression and makes the exit code 1.
+
+    Build: ConvexHullBench.vcxproj, or on Linux
+      g++ -std=c++17 -O2 -pthread hullbench.cpp arena.cpp batchhull.cpp geometry.cpp
+          instrument.cpp perfcounters.cpp pointgen.cpp predicates.cpp -o hullbench
+--------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "batchhull.h"
+#include "geometry.h"
+#include "perfcounters.h"
+#include "pointgen.h"
+
+using namespace std;
+
+/*--------------------------------------------------------------------
+    Allocation counting: every global new in the process goes through
+    these, so a case's allocations are the counter difference across
+    one run.
+--------------------------------------------------------------------*/
+#if defined(__GNUC__) && !defined(__clang__)
+//gcc cannot see that the replaced new below pairs with free
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace
+{
+    atomic<uint64_t> allocationCount(0);
+    atomic<uint64_t> allocationBytes(0);
+}
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocationBytes.fetch_add(size, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+    const char* const Algorithms[] = { "generate", "quickhull", "quickhull-float", "quantize", "quickhull-fixed",
+        "batch-hull", "point-in-hull", "minkowski-sum" };
+
+    struct Result
+    {
+        string   algorithm;
+        string   distribution;
+        size_t   n = 0;
+        double   nsPerPoint = 0;
+        size_t   hullSize = 0;
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        unsigned repetitions = 0;
+        size_t   pointsPerRun = 0;
+        PerfSample perf;
+
+        //counter per point, negative if the counter was not available
+        double PerPoint(PerfEvent event) const
+        {
+            return perf.Has(event) ? (double)perf[event] / max<size_t>(pointsPerRun, 1) : -1;
+        }
+
+        double InstructionsPerCycle() const
+        {
+            return perf.Has(PerfEvent::Cycles) && perf.Has(PerfEvent::Instructions) && perf[PerfEvent::Cycles]
+                ? (double)perf[PerfEvent::Instructions] / perf[PerfEvent::Cycles] : -1;
+        }
+    };
+
+    typedef tuple<string, string, size_t> CaseKey;
+    typedef chrono::steady_clock Clock;
+
+    //keeps whole program optimization from dropping query loops whose answer is unused
+    volatile size_t sink;
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: Measure
+
+        Summary:  Times run until minTime has passed (at least once) and
+                  keeps the fastest repetition. Allocations are counted
+                  on the first repetition only. With counters, the
+                  hardware counts reported are those of the fastest
+                  repetition; they are enabled outside the timed
+                  interval so the ioctls do not show up in ns/pt.
+    -----------------------------------------------------------------F-F*/
+    template <class Run>
+    void Measure(Run run, size_t pointsPerRun, double minTimeMs, PerfCounters* counters, Result& result)
+    {
+        double best = 0;
+        double spent = 0;
+        unsigned reps = 0;
+        do
+        {
+            const uint64_t count = allocationCount.load();
+            const uint64_t bytes = allocationBytes.load();
+            if (counters)
+            {
+                counters->Start();
+            }
+            const auto start = Clock::now();
+            run();
+            const double ms = chrono::duration<double, milli>(Clock::now() - start).count();
+            const PerfSample sample = counters ? counters->Stop() : PerfSample();
+            if (reps == 0)
+            {
+                result.allocations = allocationCount.load() - count;
+                result.allocatedBytes = allocationBytes.load() - bytes;
+            }
+            if (reps == 0 || ms < best)
+            {
+                result.perf = sample;
+            }
+            best = reps == 0 ? ms : min(best, ms);
+            spent += ms;
+            reps++;
+        } while (spent < minTimeMs && reps < 1000);
+
+        result.nsPerPoint = best * 1e6 / max<size_t>(pointsPerRun, 1);
+        result.repetitions = reps;
+        result.pointsPerRun = pointsPerRun;
+    }
+
+    Result RunCase(const string& algorithm, PointDistribution distribution, size_t n, uint64_t seed, double minTimeMs,
+        PerfCounters* counters)
+    {
+        Result result;
+        result.algorithm = algorithm;
+        result.distribution = DistributionName(distribution);
+        result.n = n;
+
+        PointBuffer points;
+        GeneratePoints(distribution, n, seed, points);
+        const PointSpan span = points.Span();
+        vector<uint32_t> index;
+        //kept across repetitions like a frame arena, so allocations show the steady state
+        Arena scratch;
+
+        if (algorithm == "generate")
+        {
+            //the buffer is already sized, so this times generation alone
+            Measure([&] { GeneratePoints(distribution, n, seed, points); }, n, minTimeMs, counters, result);
+        }
+        else if (algorithm == "quickhull")
+        {
+            index.reserve(n);
+            QuickHull(span, index, scratch);
+            Measure([&] { QuickHull(span, index, scratch); }, n, minTimeMs, counters, result);
+            result.hullSize = index.size();
+        }
+        else if (algorithm == "quickhull-float")
+        {
+            vector<Point2F> narrow(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                narrow[i] = Point2F{ (float)points.x[i], (float)points.y[i] };
+            }
+            index.reserve(n);
+            QuickHull(narrow.data(), n, index, scratch);
+            Measure([&] { QuickHull(narrow.data(), n, index, scratch); }, n, minTimeMs, counters, result);
+            result.hullSize = index.size();
+        }
+        else if (algorithm == "quantize")
+        {
+            vector<Point2I> fixed;
+            Quantize(span, fixed);
+            Measure([&] { Quantize(span, fixed); }, n, minTimeMs, counters, result);
+        }
+        else if (algorithm == "quickhull-fixed")
+        {
+            //quantized once up front: this times the integer predicates alone
+            vector<Point2I> fixed;
+            Quantize(span, fixed);
+            index.reserve(n);
+            QuickHull(fixed.data(), n, index, scratch);
+            Measure([&] { QuickHull(fixed.data(), n, index, scratch); }, n, minTimeMs, counters, result);
+            result.hullSize = index.size();
+        }
+        else if (algorithm == "batch-hull")
+        {
+            //one thread, so ns/pt compares with quickhull
+            const size_t setSize = 32;
+            vector<Point2D> packed(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                packed[i] = span[i];
+            }
+            vector<uint32_t> offsets;
+            for (size_t i = 0; i < n; i += setSize)
+            {
+                offsets.push_back((uint32_t)i);
+            }
+            offsets.push_back((uint32_t)n);
+            HullBatch hulls;
+            BatchHulls(packed.data(), offsets.data(), offsets.size() - 1, hulls, 1);
+            Measure([&] { BatchHulls(packed.data(), offsets.data(), offsets.size() - 1, hulls, 1); }, n, minTimeMs, counters,
+                result);
+            result.hullSize = hulls.indices.size();
+        }
+        else if (algorithm == "point-in-hull")
+        {
+            vector<Point2D> hull;
+            QuickHull(span, index);
+            HullVertices(span, index, hull);
+            //queries in the box around the input, so some fall outside the hull
+            PointBuffer queries;
+            GeneratePoints(PointDistribution::Square, n, seed + 1, queries);
+            const double scale = distribution == PointDistribution::Gaussian ? 4.0 : 1.25;
+            size_t inside = 0;
+            Measure([&]
+            {
+                inside = 0;
+                for (size_t i = 0; i < n; i++)
+                {
+                    inside += PointInConvexHull(Point2D{ queries.x[i] * scale, queries.y[i] * scale }, hull.data(), hull.size());
+                }
+            }, n, minTimeMs, counters, result);
+            result.hullSize = hull.size();
+            sink = inside;
+        }
+        else
+        {
+            PointBuffer other;
+            GeneratePoints(distribution, n, seed + 1, other);
+            vector<Point2D> hullA, hullB, sum;
+            auto run = [&]
+            {
+                QuickHull(span, index, scratch);
+                HullVertices(span, index, hullA);
+                QuickHull(other.Span(), index, scratch);
+                HullVertices(other.Span(), index, hullB);
+                MinkowskiSum(hullA.data(), hullA.size(), hullB.data(), hullB.size(), sum, scratch);
+            };
+            run();
+            Measure(run, 2 * n, minTimeMs, counters, result);
+            result.hullSize = sum.size();
+        }
+        return result;
+    }
+
+    vector<string> SplitList(const string& list)
+    {
+        vector<string> items;
+        stringstream stream(list);
+        string item;
+        while (getline(stream, item, ','))
+        {
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    //the per point hardware counter columns, in output order
+    vector<pair<string, double>> PerfColumns(const Result& r)
+    {
+        vector<pair<string, double>> columns;
+        for (unsigned e = 0; e < (unsigned)PerfEvent::Count; e++)
+        {
+            columns.emplace_back(string(PerfEventName((PerfEvent)e)) + "_per_point", r.PerPoint((PerfEvent)e));
+        }
+        columns.emplace_back("ipc", r.InstructionsPerCycle());
+        return columns;
+    }
+
+    //the perf columns follow the existing ones, so baselines written without --perf still compare
+    void WriteCsv(FILE* out, const vector<Result>& results, bool perf)
+    {
+        fprintf(out, "algorithm,distribution,n,ns_per_point,hull_size,allocations,allocated_bytes,repetitions");
+        if (perf)
+        {
+            for (const auto& column : PerfColumns(Result()))
+            {
+                fprintf(out, ",%s", column.first.c_str());
+            }
+        }
+        fprintf(out, "\n");
+        for (const Result& r : results)
+        {
+            fprintf(out, "%s,%s,%zu,%.4f,%zu,%llu,%llu,%u", r.algorithm.c_str(), r.distribution.c_str(), r.n,
+                r.nsPerPoint, r.hullSize, (unsigned long long)r.allocations, (unsigned long long)r.allocatedBytes, r.repetitions);
+            if (perf)
+            {
+                for (const auto& column : PerfColumns(r))
+                {
+                    if (column.second < 0)
+                    {
+                        fprintf(out, ",");
+                    }
+                    else
+                    {
+                        fprintf(out, ",%.4f", column.second);
+                    }
+                }
+            }
+            fprintf(out, "\n");
+        }
+    }
+
+    void WriteJson(FILE* out, const vector<Result>& results, bool perf)
+    {
+        fprintf(out, "[\n");
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result& r = results[i];
+            fprintf(out, "  {\"algorithm\": \"%s\", \"distribution\": \"%s\", \"n\": %zu, \"ns_per_point\": %.4f, "
+                "\"hull_size\": %zu, \"allocations\": %llu, \"allocated_bytes\": %llu, \"repetitions\": %u",
+                r.algorithm.c_str(), r.distribution.c_str(), r.n, r.nsPerPoint, r.hullSize,
+                (unsigned long long)r.allocations, (unsigned long long)r.allocatedBytes, r.repetitions);
+            if (perf)
+            {
+                for (const auto& column : PerfColumns(r))
+                {
+                    if (column.second < 0)
+                    {
+                        fprintf(out, ", \"%s\": null", column.first.c_str());
+                    }
+                    else
+                    {
+                        fprintf(out, ", \"%s\": %.4f", column.first.c_str(), column.second);
+                    }
+                }
+            }
+            fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(out, "]\n");
+    }
+
+    bool ReadBaseline(const string& path, map<CaseKey, Result>& baseline)
+    {
+        ifstream in(path);
+        if (!in)
+        {
+            return false;
+        }
+        string line;
+        getline(in, line);
+        while (getline(in, line))
+        {
+            const vector<string> fields = SplitList(line);
+            if (fields.size() < 5)
+            {
+                continue;
+            }
+            Result r;
+            r.algorithm = fields[0];
+            r.distribution = fields[1];
+            r.n = (size_t)strtoull(fields[2].c_str(), nullptr, 10);
+            r.nsPerPoint = atof(fields[3].c_str());
+            r.hullSize = (size_t)strtoull(fields[4].c_str(), nullptr, 10);
+            baseline[CaseKey(r.algorithm, r.distribution, r.n)] = r;
+        }
+        return true;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: CompareBaseline
+
+        Summary:  Prints every case next to its baseline row to stderr
+                  and counts regressions: slower than threshold times
+                  the baseline, or a different hull size (inputs are
+                  seeded, so the hull size is a correctness check).
+    -----------------------------------------------------------------F-F*/
+    size_t CompareBaseline(const vector<Result>& results, const map<CaseKey, Result>& baseline, double threshold)
+    {
+        size_t regressions = 0;
+        fprintf(stderr, "%-14s %-11s %10s %12s %12s %7s\n", "algorithm", "dist", "n", "base ns/pt", "ns/pt", "ratio");
+        for (const Result& r : results)
+        {
+            auto found = baseline.find(CaseKey(r.algorithm, r.distribution, r.n));
+            if (found == baseline.end())
+            {
+                continue;
+            }
+            const Result& b = found->second;
+            const double ratio = b.nsPerPoint > 0 ? r.nsPerPoint / b.nsPerPoint : 1.0;
+            const bool slower = ratio > threshold;
+            const bool changed = r.hullSize != b.hullSize;
+            regressions += (slower || changed) ? 1 : 0;
+            fprintf(stderr, "%-14s %-11s %10zu %12.3f %12.3f %7.3f%s%s\n", r.algorithm.c_str(), r.distribution.c_str(), r.n,
+                b.nsPerPoint, r.nsPerPoint, ratio, slower ? "  SLOWER" : "", changed ? "  HULL SIZE CHANGED" : "");
+        }
+        fprintf(stderr, "%zu regression(s)\n", regressions);
+        return regressions;
+    }
+
+    int Usage()
+    {
+        fprintf(stderr,
+            "usage: hullbench [--max-n N] [--dist a,b,..] [--algo a,b,..] [--seed S] [--min-time MS]\n"
+            "                 [--format csv|json] [--out FILE] [--baseline FILE] [--threshold RATIO] [--perf]\n");
+        return 2;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxN = 1000000;
+    vector<string> distributions = { "square", "disk", "circle", "gaussian", "clustered", "collinear", "duplicates" };
+    vector<string> algorithms(begin(Algorithms), end(Algorithms));
+    uint64_t seed = 1;
+    double minTimeMs = 200;
+    string format = "csv";
+    string outPath;
+    string baselinePath;
+    double threshold = 1.10;
+    bool perf = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const string arg = argv[i];
+        if (arg == "--perf")
+        {
+            perf = true;
+            continue;
+        }
+        if (i + 1 == argc)
+        {
+            return Usage();
+        }
+        const string value = argv[++i];
+        if (arg == "--max-n")
+        {
+            maxN = (size_t)atof(value.c_str());
+        }
+        else if (arg == "--dist")
+        {
+            distributions = SplitList(value);
+        }
+        else if (arg == "--algo")
+        {
+            algorithms = SplitList(value);
+        }
+        else if (arg == "--seed")
+        {
+            seed = strtoull(value.c_str(), nullptr, 10);
+        }
+        else if (arg == "--min-time")
+        {
+            minTimeMs = atof(value.c_str());
+        }
+        else if (arg == "--format")
+        {
+            format = value;
+        }
+        else if (arg == "--out")
+        {
+            outPath = value;
+        }
+        else if (arg == "--baseline")
+        {
+            baselinePath = value;
+        }
+        else if (arg == "--threshold")
+        {
+            threshold = atof(value.c_str());
+        }
+        else
+        {
+            return Usage();
+        }
+    }
+    vector<PointDistribution> families;
+    for (const string& d : distributions)
+    {
+        families.emplace_back();
+        if (!ParseDistribution(d, families.back()))
+        {
+            fprintf(stderr, "hullbench: unknown distribution %s\n", d.c_str());
+            return Usage();
+        }
+    }
+    for (const string& a : algorithms)
+    {
+        if (find(begin(Algorithms), end(Algorithms), a) == end(Algorithms))
+        {
+            fprintf(stderr, "hullbench: unknown algorithm %s\n", a.c_str());
+            return Usage();
+        }
+    }
+
+    //counters are per thread and every case runs on this one
+    PerfCounters counters;
+    if (perf)
+    {
+        const size_t opened = counters.Open();
+        if (opened < (size_t)PerfEvent::Count)
+        {
+            fprintf(stderr, "hullbench: %s hardware counters unavailable (%s)\n", opened ? "some" : "all", counters.Error().c_str());
+        }
+    }
+
+    vector<Result> results;
+    for (const string& algorithm : algorithms)
+    {
+        for (PointDistribution distribution : families)
+        {
+            for (size_t n = 10; n <= maxN; n *= 10)
+            {
+                results.push_back(RunCase(algorithm, distribution, n, seed, minTimeMs, counters.Available() ? &counters : nullptr));
+                const Result& r = results.back();
+                fprintf(stderr, "%-14s %-11s %10zu %10.3f ns/pt  hull %zu", r.algorithm.c_str(), r.distribution.c_str(), r.n, r.nsPerPoint, r.hullSize);
+                if (r.perf.Has(PerfEvent::Cycles))
+                {
+                    fprintf(stderr, "  %.1f cycles/pt", r.PerPoint(PerfEvent::Cycles));
+                }
+                if (r.InstructionsPerCycle() >= 0)
+                {
+                    fprintf(stderr, "  ipc %.2f", r.InstructionsPerCycle());
+                }
+                fprintf(stderr, "\n");
+            }
+        }
+    }
+
+    FILE* out = outPath.empty() ? stdout : fopen(outPath.c_str(), "w");
+    if (!out)
+    {
+        fprintf(stderr, "hullbench: cannot write %s\n", outPath.c_str());
+        return 1;
+    }
+    if (format == "json")
+    {
+        WriteJson(out, results, perf);
+    }
+    else
+    {
+        WriteCsv(out, results, perf);
+    }
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    if (!baselinePath.empty())
+    {
+        map<CaseKey, Result> baseline;
+        if (!ReadBaseline(baselinePath, baseline))
+        {
+            fprintf(stderr, "hullbench: cannot read baseline %s\n", baselinePath.c_str());
+            return 1;
+        }
+        return CompareBaseline(results, baseline, threshold) ? 1 : 0;
+    }
+    return 0;
+}
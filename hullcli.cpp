@@ -0,0 +1,2827 @@
+/*--------------------------------------------------------------------
+    hullcli: headless batch driver for the geometry algorithms, for
+    jobs that cannot open a window. Links only the headless kernel
+    (no windows.h or d2d1.h).
+
+    hullcli [options] <mode> <input> [<input>]
+    hullcli [options] --batch <job file | ->
+    hullcli --verify-static
+    hullcli --verify-kinetic
+    hullcli --verify-snapshot
+    hullcli --verify-stream
+    hullcli --verify-window
+    hullcli --verify-polyline
+    hullcli --verify-batch
+    hullcli --verify-layers
+    hullcli --verify-calipers
+    hullcli --verify-lod
+    hullcli --drag-sim [--events N] [--interval MS] [--max-lag MS] <points> <points>
+    hullcli --anytime [--budget MS] [--directions K] <points>
+    hullcli --eps-kernel [--epsilon E] [--output FILE] <points>
+    hullcli --stream-hull [--chunk BYTES] [--output FILE] <text points>
+    hullcli --stream-hull --raw f32|f64 [--skip BYTES] [--chunk N] [--threads T] [--output FILE] <pairs>
+    hullcli --window-hull [--window W] [--span T] [--output FILE] <points>
+    hullcli --polyline-hull [--trust-simple] [--output FILE] <points>
+    hullcli --simplify [--max-vertices K | --tolerance T] [--outer] [--output FILE] <points>
+
+    Modes
+      quickhull       <points>             hull of the points
+      minkowski-sum   <points> <points>    sum of the two hulls
+      minkowski-diff  <points> <points>    difference of the two hulls
+      point-in-hull   <points> <queries>   which queries are in the hull
+      gjk             <points> <points>    do the two hulls intersect
+      measure         <points>             diameter, width and least area
+                                           and perimeter rectangles of the
+                                           hull, by rotating calipers
+      layers          <points>             convex layer (onion depth) of
+                                           each point
+
+    Options
+      --repeat N      run the computation N times, report best and mean
+      --quiet         print only the summary line of each job
+      --output FILE   write the result as a binary point file (.chp)
+      --trace FILE    write a Chrome trace of the run and print the
+                      counter summary (needs a HULL_INSTRUMENT build)
+
+    Inputs are binary point files or text (CSV / whitespace x y lines),
+    told apart by the file header. A binary file is checked against
+    its checksum and rejected if corrupt; text lines that are not
+    points are skipped with a warning. A batch file holds one job per
+    line in the same form as the command line; lines may carry their
+    own options. Inputs are loaded once and shared by every job that
+    names them, so a batch pays for startup and loading only once.
+
+    --verify-static recomputes every shape baked at compile time in
+    staticshapes.h with the runtime engines and reports any table that
+    differs, exiting with 1 if one does.
+
+    --verify-kinetic moves point sets with a KineticHull and checks its
+    hull against a QuickHull of the same positions after every step:
+    a set whose rounded failure times once kept Advance from returning,
+    then sets on the integer grid, where collinear and coincident
+    points are the rule. It exits with 1 if a hull differs.
+
+    --verify-snapshot has four reader threads pin views of a
+    SnapshotPublisher, some of them nested, while the main thread
+    publishes versions filled in from recycled ones, and checks that
+    no view ever changes under its reader and that every retired
+    version is reclaimed at the end. It exits with 1 if one is not.
+
+    --verify-stream writes text point files in the working directory,
+    hulls them chunk by chunk as --stream-hull does, with chunks small
+    enough that lines straddle them and that chunk hulls are folded,
+    then raw float and double pair files behind a header and with a
+    stray tail, and checks each hull against a QuickHull of all the
+    points, exiting with 1 if one differs.
+
+    --verify-window drives SlidingWindowHulls with random pushes, pops,
+    evictions and clears, on a small grid and in a square, and checks
+    the hull after every step against a QuickHull of the points the
+    window should hold, exiting with 1 if one differs.
+
+    --verify-polyline pushes simple polylines through MelkmanHull with
+    and without its exact check, and points in random order with it,
+    and checks every prefix hull against QuickHull, exiting with 1 if
+    one differs or a simple polyline was taken for one that is not.
+
+    --verify-batch hulls batches of random, duplicate, collinear and
+    ulp apart sets of float, double and int32_t points, packed after a
+    few points that belong to no set, with BatchHulls and checks each
+    set against a QuickHull of it alone, exiting with 1 if one differs.
+
+    --verify-layers peels random sets, grid sets full of coincident and
+    collinear points, and concentric circles with ConvexLayers and by
+    repeated QuickHull, and compares each layer's points and hull,
+    exiting with 1 if a set's layers differ.
+
+    --verify-calipers checks the diameter, width, both rectangles and
+    the antipodal pairs of random hulls, on a grid and in a square,
+    against brute force over every vertex or pair, and MeasureHulls on
+    a batch against MeasureHull of each hull, exiting with 1 if any of
+    them differ.
+
+    --verify-lod builds inner and outer level of detail chains for
+    pairs of nearly touching circles, checks that they nest, and that
+    GjkIntersectLod on the outer chains agrees with GjkIntersect on
+    the full hulls, exiting with 1 if not.
+
+    --drag-sim replays a synthetic drag: the second set swept across
+    the first in N mouse moves (default 200) every MS milliseconds
+    (default 8), each one a Minkowski difference and origin test as in
+    the GJK view. It runs the stream twice, computing inline on every
+    event as the window used to, then through a latest-wins HullWorker
+    with the given lag bound (default 100), and prints the latency from
+    event to result of both.
+
+    --anytime refines an AnytimeHull in frames of MS milliseconds
+    (default 1) from the extremes in K directions (default 8), printing
+    the vertex count and error bound after each frame, and checks the
+    final hull against QuickHull, exiting with 1 if they differ.
+
+    --eps-kernel streams the points once, straight from the mapped
+    file, through an EpsKernel for E (default 0.01), and prints the
+    kernel size, its certified error bound against the diameter, and
+    the time against a QuickHull of the whole set. --output writes the
+    kernel as a point set.
+
+    --stream-hull hulls a text file that need not fit in memory: it is
+    parsed in chunks of BYTES (default 16 MB) and only the hull of each
+    chunk is kept. It prints the hull size and the parse throughput,
+    and --output writes the hull. With --raw the input is instead a
+    flat file of interleaved float or double x, y pairs after a header
+    of BYTES (default 0), hulled by OutOfCoreHull from chunks of N
+    points (default 4M) mapped one at a time on T threads (default all
+    cores).
+
+    --window-hull replays the points in file order as a stream, point i
+    at time i, through a SlidingWindowHull that keeps the last W points
+    (default 1000) and, with --span, only those newer than T. It asks
+    for the hull after every point and prints the time per update and
+    the hull sizes; --output writes the final hull.
+
+    --polyline-hull reads the points in file order as the vertices of
+    a polyline and hulls them with MelkmanHull, falling back to
+    QuickHull if the polyline crosses itself, and prints the time
+    against a QuickHull of the same points. --trust-simple skips the
+    exact check, which is faster but gives a wrong hull if the
+    polyline is not simple after all.
+
+    --simplify hulls the points and cuts the hull down to K vertices
+    (default 16), or to as few as stay within T of it, inside the hull
+    or, with --outer, around it. It prints the result's size and error
+    and the level of detail chain the hull would get, and --output
+    writes the simplified polygon.
+
+    Build: ConvexHullCli.vcxproj, or on Linux
+      g++ -std=c++17 -O2 -pthread hullcli.cpp anytimehull.cpp arena.cpp batchhull.cpp calipers.cpp
+          convexlayers.cpp epskernel.cpp geometry.cpp hullsimplify.cpp hullworker.cpp instrument.cpp
+          kinetichull.cpp mappedfile.cpp melkmanhull.cpp outofcorehull.cpp pointfile.cpp predicates.cpp
+          slidingwindowhull.cpp textpointparser.cpp -o hullcli
+    (add -DHULL_INSTRUMENT for counters and traces)
+--------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "anytimehull.h"
+#include "arena.h"
+#include "batchhull.h"
+#include "calipers.h"
+#include "convexlayers.h"
+#include "epskernel.h"
+#include "geometry.h"
+#include "hullsimplify.h"
+#include "hullworker.h"
+#include "instrument.h"
+#include "kinetichull.h"
+#include "melkmanhull.h"
+#include "outofcorehull.h"
+#include "pointfile.h"
+#include "slidingwindowhull.h"
+#include "snapshot.h"
+#include "staticshapes.h"
+#include "textpointparser.h"
+
+using namespace std;
+
+namespace
+{
+    enum class JobMode
+    {
+        QuickHull,
+        MinkowskiSum,
+        MinkowskiDifference,
+        PointInHull,
+        Gjk,
+        Measure,
+        Layers
+    };
+
+    struct ModeName
+    {
+        const char* name;
+        JobMode     mode;
+        size_t      inputs;
+    };
+
+    const ModeName Modes[] =
+    {
+        { "quickhull", JobMode::QuickHull, 1 },
+        { "minkowski-sum", JobMode::MinkowskiSum, 2 },
+        { "minkowski-diff", JobMode::MinkowskiDifference, 2 },
+        { "point-in-hull", JobMode::PointInHull, 2 },
+        { "gjk", JobMode::Gjk, 2 },
+        { "measure", JobMode::Measure, 1 },
+        { "layers", JobMode::Layers, 1 }
+    };
+
+    struct Job
+    {
+        const ModeName* mode = nullptr;
+        vector<string>  inputs;
+        string          output;
+        unsigned        repeat = 1;
+        bool            quiet = false;
+    };
+
+    //a loaded input: binary files stay mapped, text files are parsed into a buffer
+    struct Input
+    {
+        PointFile   file;
+        PointBuffer buffer;
+        bool        mapped = false;
+        double      loadMs = 0;
+
+        PointSpan Span() const { return mapped ? file.Points() : buffer.Span(); }
+    };
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: OpenInput
+
+        Summary:  Maps path if it starts with the point file magic, with
+                  its checksum verified, and parses it as text otherwise.
+                  A point file that fails its checks is reported, never
+                  read as text; text lines that are not points are
+                  counted in a warning.
+
+        Args:     const string& path
+                    file to load
+                  Input& input
+                    receives the points
+
+        Modifies: [input].
+
+        Returns:  bool
+                    false if the file cannot be read or is corrupt
+    -----------------------------------------------------------------F-F*/
+    bool OpenInput(const string& path, Input& input)
+    {
+        if (IsPointFile(path))
+        {
+            input.mapped = input.file.Open(path, true);
+            if (!input.mapped)
+            {
+                fprintf(stderr, "hullcli: %s is not a valid point file (bad header, index or checksum)\n", path.c_str());
+            }
+            return input.mapped;
+        }
+
+        input.mapped = false;
+        TextParseStats stats;
+        if (!ParseTextFile(path, input.buffer, TextParseOptions(), &stats))
+        {
+            return false;
+        }
+        if (stats.badLines > 0)
+        {
+            fprintf(stderr, "hullcli: %s: skipped %llu lines that are not x y points\n",
+                path.c_str(), (unsigned long long)stats.badLines);
+        }
+        return true;
+    }
+
+    //the points of path copied out, for modes that work on a vector
+    bool LoadPoints(const string& path, vector<Point2D>& points)
+    {
+        Input input;
+        if (!OpenInput(path, input))
+        {
+            return false;
+        }
+        const PointSpan span = input.Span();
+        points.resize(span.count);
+        for (size_t i = 0; i < span.count; i++)
+        {
+            points[i] = span[i];
+        }
+        return true;
+    }
+
+    typedef chrono::steady_clock Clock;
+
+    double Milliseconds(Clock::time_point start)
+    {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: ParseJob
+
+        Summary:  Builds a job from command line style tokens. Options
+                  may appear anywhere; the first other token is the mode
+                  and the rest are inputs.
+
+        Args:     const vector<string>& tokens
+                    tokens of one job
+                  Job& job
+                    starts with the default options, receives the job
+                  string& error
+                    receives the reason when the job is malformed
+
+        Modifies: [job, error].
+
+        Returns:  bool
+                    false if the job is malformed
+    -----------------------------------------------------------------F-F*/
+    bool ParseJob(const vector<string>& tokens, Job& job, string& error)
+    {
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            const string& token = tokens[i];
+            if (token == "--quiet")
+            {
+                job.quiet = true;
+            }
+            else if (token == "--repeat" || token == "--output")
+            {
+                if (i + 1 == tokens.size())
+                {
+                    error = token + " needs a value";
+                    return false;
+                }
+                const string& value = tokens[++i];
+                if (token == "--output")
+                {
+                    job.output = value;
+                }
+                else
+                {
+                    job.repeat = (unsigned)max(1, atoi(value.c_str()));
+                }
+            }
+            else if (!job.mode)
+            {
+                for (const ModeName& m : Modes)
+                {
+                    if (token == m.name)
+                    {
+                        job.mode = &m;
+                    }
+                }
+                if (!job.mode)
+                {
+                    error = "unknown mode " + token;
+                    return false;
+                }
+            }
+            else
+            {
+                job.inputs.push_back(token);
+            }
+        }
+        if (!job.mode)
+        {
+            error = "no mode";
+            return false;
+        }
+        if (job.inputs.size() != job.mode->inputs)
+        {
+            error = string(job.mode->name) + " takes " + to_string(job.mode->inputs) + " input(s)";
+            return false;
+        }
+        return true;
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    JobRunner
+
+      Summary:  Runs jobs one after another, loading each input the
+                first time a job names it and keeping it for the rest
+                of the process.
+
+      Methods:  Run
+                  runs one job and prints its result and timing
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+    class JobRunner
+    {
+    public:
+        JobRunner() : jobCount(0) { }
+
+        bool Run(const Job& job);
+
+    private:
+        const Input* Load(const string& path);
+
+        map<string, unique_ptr<Input>> inputs;
+        size_t                         jobCount;
+    };
+
+    const Input* JobRunner::Load(const string& path)
+    {
+        auto found = inputs.find(path);
+        if (found != inputs.end())
+        {
+            return found->second.get();
+        }
+
+        const auto start = Clock::now();
+        unique_ptr<Input> input(new Input());
+        if (!OpenInput(path, *input))
+        {
+            return nullptr;
+        }
+        input->loadMs = Milliseconds(start);
+        return (inputs[path] = move(input)).get();
+    }
+
+    void Hull(const PointSpan& points, vector<uint32_t>& index, vector<Point2D>& vertices)
+    {
+        QuickHull(points, index);
+        HullVertices(points, index, vertices);
+    }
+
+    void PrintPoints(const vector<Point2D>& points)
+    {
+        for (const Point2D& p : points)
+        {
+            printf("  %.17g %.17g\n", p.x, p.y);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobRunner::Run
+
+      Summary:  Loads the job's inputs, runs its computation repeat
+                times and prints a summary line (sizes, load time, best
+                and mean compute time) followed by the result unless
+                the job is quiet. Hull inputs are hulled inside the
+                timed region, as MainWindow::AlgoTest does.
+
+      Args:     const Job& job
+                  job to run
+
+      Modifies: [inputs, jobCount].
+
+      Returns:  bool
+                  false if an input could not be loaded or the output
+                  could not be written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool JobRunner::Run(const Job& job)
+    {
+        jobCount++;
+        printf("job %zu: %s", jobCount, job.mode->name);
+        for (const string& path : job.inputs)
+        {
+            printf(" %s", path.c_str());
+        }
+        printf("\n");
+
+        const Input* loaded[2] = {};
+        double loadMs = 0;
+        for (size_t i = 0; i < job.inputs.size(); i++)
+        {
+            const bool cached = inputs.count(job.inputs[i]) > 0;
+            loaded[i] = Load(job.inputs[i]);
+            if (!loaded[i])
+            {
+                printf("  error: cannot read %s\n", job.inputs[i].c_str());
+                return false;
+            }
+            loadMs += cached ? 0 : loaded[i]->loadMs;
+        }
+        const PointSpan first = loaded[0]->Span();
+        const PointSpan second = loaded[1] ? loaded[1]->Span() : PointSpan{ nullptr, nullptr, 0, 1 };
+
+        vector<uint32_t> index;
+        vector<Point2D> hullA, hullB, result;
+        vector<uint8_t> inside;
+        size_t insideCount = 0;
+        size_t gjkIterations = 0;
+        bool intersect = false;
+        HullMeasures measures = {};
+        vector<uint32_t> layer;
+        HullBatch layerHulls;
+        size_t layerCount = 0;
+
+        double bestMs = 0;
+        double totalMs = 0;
+        for (unsigned run = 0; run < job.repeat; run++)
+        {
+            const auto start = Clock::now();
+            switch (job.mode->mode)
+            {
+            case JobMode::QuickHull:
+                Hull(first, index, result);
+                break;
+            case JobMode::MinkowskiSum:
+                Hull(first, index, hullA);
+                Hull(second, index, hullB);
+                MinkowskiSum(hullA.data(), hullA.size(), hullB.data(), hullB.size(), result);
+                break;
+            case JobMode::MinkowskiDifference:
+                Hull(first, index, hullA);
+                Hull(second, index, hullB);
+                MinkowskiDifference(hullA.data(), hullA.size(), hullB.data(), hullB.size(), result);
+                break;
+            case JobMode::PointInHull:
+                Hull(first, index, hullA);
+                inside.resize(second.count);
+                insideCount = 0;
+                for (size_t i = 0; i < second.count; i++)
+                {
+                    inside[i] = PointInConvexHull(second[i], hullA.data(), hullA.size());
+                    insideCount += inside[i];
+                }
+                break;
+            case JobMode::Gjk:
+                Hull(first, index, hullA);
+                Hull(second, index, hullB);
+                intersect = GjkIntersect(hullA.data(), hullA.size(), hullB.data(), hullB.size(), &gjkIterations);
+                break;
+            case JobMode::Measure:
+                QuickHull(first, index);
+                measures = MeasureHull(first, index.data(), index.size());
+                break;
+            case JobMode::Layers:
+                layerCount = ConvexLayers(first, layer, &layerHulls);
+                break;
+            }
+            const double ms = Milliseconds(start);
+            bestMs = run == 0 ? ms : min(bestMs, ms);
+            totalMs += ms;
+        }
+
+        printf("  points %zu", first.count);
+        if (loaded[1])
+        {
+            printf(" + %zu", second.count);
+        }
+        switch (job.mode->mode)
+        {
+        case JobMode::QuickHull:
+        case JobMode::MinkowskiSum:
+        case JobMode::MinkowskiDifference:
+            printf("  result %zu vertices", result.size());
+            break;
+        case JobMode::PointInHull:
+            printf("  inside %zu of %zu", insideCount, second.count);
+            break;
+        case JobMode::Gjk:
+            printf("  %s after %zu iterations", intersect ? "intersect" : "separate", gjkIterations);
+            break;
+        case JobMode::Measure:
+            printf("  hull %zu vertices", index.size());
+            break;
+        case JobMode::Layers:
+            printf("  %zu layers, outermost %zu vertices", layerCount,
+                layerCount ? (size_t)(layerHulls.offsets[1] - layerHulls.offsets[0]) : (size_t)0);
+            break;
+        }
+        printf("  load %.3f ms  compute %.3f ms best, %.3f ms mean of %u\n", loadMs, bestMs, totalMs / job.repeat, job.repeat);
+
+        if (!job.quiet)
+        {
+            if (job.mode->mode == JobMode::PointInHull)
+            {
+                for (size_t i = 0; i < second.count; i++)
+                {
+                    printf("  %.17g %.17g %d\n", second[i].x, second[i].y, (int)inside[i]);
+                }
+            }
+            else if (job.mode->mode == JobMode::Measure)
+            {
+                const HullDiameter& d = measures.diameter;
+                printf("  diameter %.17g between %u and %u\n", d.length, d.a, d.b);
+                printf("  width %.17g from edge at %u to %u\n", measures.width.width, measures.width.edge, measures.width.vertex);
+                const HullRectangle* rectangles[2] = { &measures.minArea, &measures.minPerimeter };
+                for (const HullRectangle* rectangle : rectangles)
+                {
+                    printf("  %s rectangle area %.17g perimeter %.17g on edge at %u\n",
+                        rectangle == &measures.minArea ? "least area" : "least perimeter",
+                        rectangle->area, rectangle->perimeter, rectangle->edge);
+                    PrintPoints(vector<Point2D>(rectangle->corners, rectangle->corners + 4));
+                }
+            }
+            else if (job.mode->mode == JobMode::Layers)
+            {
+                for (size_t i = 0; i < first.count; i++)
+                {
+                    printf("  %.17g %.17g %u\n", first[i].x, first[i].y, layer[i]);
+                }
+            }
+            else if (job.mode->mode != JobMode::Gjk)
+            {
+                PrintPoints(result);
+            }
+        }
+
+        if (!job.output.empty())
+        {
+            bool written = false;
+            if (job.mode->mode == JobMode::QuickHull)
+            {
+                written = WritePointFile(job.output, PointFileKind::Hull, first, index.data(), index.size());
+            }
+            else if (job.mode->mode == JobMode::MinkowskiSum || job.mode->mode == JobMode::MinkowskiDifference)
+            {
+                vector<uint32_t> order(result.size());
+                for (uint32_t i = 0; i < order.size(); i++)
+                {
+                    order[i] = i;
+                }
+                written = WritePointFile(job.output, PointFileKind::Minkowski,
+                    MakePointSpan(result.data(), result.size()), order.data(), order.size());
+            }
+            else
+            {
+                printf("  error: %s has no point output\n", job.mode->name);
+                return false;
+            }
+            if (!written)
+            {
+                printf("  error: cannot write %s\n", job.output.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    vector<string> SplitTokens(const string& line)
+    {
+        vector<string> tokens;
+        istringstream stream(line);
+        string token;
+        while (stream >> token)
+        {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    //compares a baked table with the runtime result for the same input
+    template <class T, size_t N>
+    bool SameAsRuntime(const char* name, const FixedPolygon<T, N>& baked, const vector<Point2<T>>& runtime)
+    {
+        bool same = baked.Size() == runtime.size();
+        for (size_t i = 0; same && i < runtime.size(); i++)
+        {
+            same = baked[i].x == runtime[i].x && baked[i].y == runtime[i].y;
+        }
+        printf("  %-14s %2zu vertices  %s\n", name, baked.Size(), same ? "ok" : "differs");
+        return same;
+    }
+
+    template <class T, size_t N>
+    vector<Point2<T>> RuntimeHull(const array<Point2<T>, N>& points)
+    {
+        vector<uint32_t> index;
+        vector<Point2<T>> vertices;
+        QuickHull(points.data(), points.size(), index);
+        HullVertices(points.data(), index, vertices);
+        return vertices;
+    }
+
+    template <class T>
+    vector<Point2<T>> RuntimeSum(const vector<Point2<T>>& a, const vector<Point2<T>>& b)
+    {
+        vector<Point2<T>> sum;
+        MinkowskiSum(a.data(), a.size(), b.data(), b.size(), sum);
+        return sum;
+    }
+
+    //--verify-static: every baked shape against QuickHull and MinkowskiSum
+    int VerifyStatic()
+    {
+        using namespace StaticShapes;
+        printf("static shapes\n");
+        const vector<Point2D> crate = RuntimeHull(CratePoints);
+        const vector<Point2D> wedge = RuntimeHull(WedgePoints);
+        const vector<Point2D> hexagon = RuntimeHull(HexagonPoints);
+        const vector<Point2I> tile = RuntimeHull(TilePoints);
+        bool same = SameAsRuntime("Crate", Crate, crate);
+        same &= SameAsRuntime("Wedge", Wedge, wedge);
+        same &= SameAsRuntime("Hexagon", Hexagon, hexagon);
+        same &= SameAsRuntime("Tile", Tile, tile);
+        same &= SameAsRuntime("CrateHexagon", CrateHexagon, RuntimeSum(crate, hexagon));
+        same &= SameAsRuntime("CrateWedge", CrateWedge, RuntimeSum(crate, wedge));
+        same &= SameAsRuntime("TileTile", TileTile, RuntimeSum(tile, tile));
+        return same ? 0 : 1;
+    }
+
+    bool SameVertices(const vector<Point2D>& a, const vector<Point2D>& b)
+    {
+        return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(),
+            [](const Point2D& p, const Point2D& q) { return p.x == q.x && p.y == q.y; });
+    }
+
+    //hull against a QuickHull of points, vertex by vertex
+    bool SameAsQuickHull(const vector<Point2D>& points, const vector<Point2D>& hull)
+    {
+        vector<uint32_t> index;
+        vector<Point2D> expected;
+        Hull(MakePointSpan(points.data(), points.size()), index, expected);
+        return SameVertices(hull, expected);
+    }
+
+    //the kinetic hull at its current time against a QuickHull of the same positions
+    bool SameAsQuickHull(KineticHull& kinetic)
+    {
+        const vector<uint32_t>& hull = kinetic.Hull();
+        vector<Point2D> positions(kinetic.Size());
+        for (uint32_t i = 0; i < positions.size(); i++)
+        {
+            positions[i] = kinetic.Position(i);
+        }
+        vector<uint32_t> expected;
+        QuickHull(positions, expected);
+        if (hull.size() != expected.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < hull.size(); i++)
+        {
+            const Point2D& a = positions[hull[i]];
+            const Point2D& b = positions[expected[i]];
+            if (a.x != b.x || a.y != b.y)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyKinetic
+
+        Summary:  --verify-kinetic: KineticHull against QuickHull. First
+                  three points whose rounded failure times once had
+                  Advance repair the same certificates forever, then
+                  SetVelocities with fewer velocities than points, then
+                  1000 sets of up to 32 points with positions and
+                  velocities in 0..3, advanced in quarter steps (so
+                  every position is exact) with one velocity changed
+                  half way.
+
+        Returns:  int
+                    exit code, 1 if a hull differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyKinetic()
+    {
+        printf("kinetic hull\n");
+        KineticHull kinetic;
+        kinetic.Reset({ { 1, 3 }, { 1, 2 }, { 2, 2 } },
+            { { 0.51795314274158133, 0.016267195504643173 }, { 0.40845876048473939, 0.45865306989758081 },
+              { -0.79147322806743481, 0.29179568540610346 } });
+        bool same = true;
+        for (int step = 1; step <= 7; step++)
+        {
+            kinetic.Advance(0.137 * step);
+            same &= SameAsQuickHull(kinetic);
+        }
+        printf("  %-14s %zu events  %s\n", "RoundedRoots", kinetic.EventCount(), same ? "ok" : "differs");
+
+        //a shorter velocity list changes only the points it covers; the rest go on from where they are
+        kinetic.Reset({ { 0, 0 }, { 1, 0 }, { 0, 1 } }, { { 1, 0 }, { 1, 0 }, { 1, 0 } });
+        kinetic.Advance(5);
+        kinetic.SetVelocities({ { 0, 0 } });
+        kinetic.Advance(6);
+        const bool kept = kinetic.Position(0).x == 5 && kinetic.Position(1).x == 7 && kinetic.Position(2).x == 6
+            && SameAsQuickHull(kinetic);
+        printf("  %-14s %s\n", "SetVelocities", kept ? "ok" : "differs");
+        same &= kept;
+
+        //a fixed linear congruential sequence, so every run checks the same sets
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+        size_t checks = 0;
+        size_t differs = 0;
+        for (int trial = 0; trial < 1000; trial++)
+        {
+            const size_t n = 3 + draw(30);
+            vector<Point2D> positions(n);
+            vector<Point2D> velocities(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                positions[i] = Point2D{ (double)draw(4), (double)draw(4) };
+                velocities[i] = Point2D{ (double)draw(4), (double)draw(4) };
+            }
+            kinetic.Reset(positions, velocities);
+            for (int step = 0; step < 16; step++)
+            {
+                kinetic.Advance(0.25 * step);
+                if (step == 8)
+                {
+                    kinetic.SetVelocity(draw((uint32_t)n), Point2D{ (double)draw(4), (double)draw(4) });
+                }
+                checks++;
+                differs += SameAsQuickHull(kinetic) ? 0 : 1;
+            }
+        }
+        printf("  %-14s %zu of %zu hulls differ  %s\n", "Grid", differs, checks, differs == 0 ? "ok" : "differs");
+        return same && differs == 0 ? 0 : 1;
+    }
+
+    //a published version whose every value follows from its stamp, so a torn or reused one shows
+    struct StampedVersion
+    {
+        uint64_t         stamp;
+        vector<uint64_t> values;
+
+        void Fill(uint64_t s)
+        {
+            stamp = s;
+            values.resize(1 + s % 61);
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                values[i] = s * 1000003u + i;
+            }
+        }
+
+        bool Intact() const
+        {
+            bool intact = values.size() == 1 + stamp % 61;
+            for (size_t i = 0; intact && i < values.size(); i++)
+            {
+                intact = values[i] == stamp * 1000003u + i;
+            }
+            return intact;
+        }
+    };
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifySnapshot
+
+        Summary:  --verify-snapshot: four readers read a SnapshotPublisher
+                  as fast as they can while the main thread publishes
+                  20000 versions, each one taken from Recycle when there
+                  is one, so a version freed or refilled too early would
+                  change under a reader. Each read checks its version
+                  before and after a nested read, that stamps never go
+                  backwards, and that the nested view is at least as new.
+                  Once the readers are gone Reclaim must leave nothing.
+
+        Returns:  int
+                    exit code, 1 if a view changed or a version was not
+                    reclaimed
+    -----------------------------------------------------------------F-F*/
+    int VerifySnapshot()
+    {
+        printf("snapshot publisher\n");
+        const uint64_t versions = 20000;
+        const unsigned readers = 4;
+        SnapshotPublisher<StampedVersion> publisher;
+        unique_ptr<StampedVersion> first(new StampedVersion);
+        first->Fill(0);
+        publisher.Publish(move(first));
+
+        atomic<bool> done(false);
+        atomic<size_t> reads(0);
+        atomic<size_t> torn(0);
+        vector<thread> threads;
+        for (unsigned r = 0; r < readers; r++)
+        {
+            threads.emplace_back([&]()
+            {
+                SnapshotPublisher<StampedVersion>::Reader reader(publisher);
+                uint64_t last = 0;
+                size_t count = 0;
+                size_t bad = 0;
+                while (!done.load(memory_order_acquire))
+                {
+                    auto view = reader.Read();
+                    const uint64_t stamp = view->stamp;
+                    bool ok = stamp >= last && view->Intact();
+                    if (count % 4 == 0)
+                    {
+                        auto inner = reader.Read();
+                        ok = ok && inner->stamp >= stamp && inner->Intact();
+                    }
+                    ok = ok && view->stamp == stamp && view->Intact();
+                    last = stamp;
+                    bad += ok ? 0 : 1;
+                    count++;
+                }
+                reads += count;
+                torn += bad;
+            });
+        }
+
+        size_t allocated = 0;
+        for (uint64_t v = 1; v <= versions; v++)
+        {
+            unique_ptr<StampedVersion> next = publisher.Recycle();
+            if (!next)
+            {
+                next.reset(new StampedVersion);
+                allocated++;
+            }
+            next->Fill(v);
+            publisher.Publish(move(next));
+            //let the readers move on now and then, or nearly every version is still pinned when the next one comes
+            if (v % 16 == 0)
+            {
+                this_thread::yield();
+            }
+        }
+        done.store(true, memory_order_release);
+        for (thread& t : threads)
+        {
+            t.join();
+        }
+
+        printf("  %-14s %zu reads, %zu changed under a view  %s\n", "Readers", reads.load(), torn.load(),
+            torn == 0 ? "ok" : "differs");
+        publisher.Reclaim();
+        const size_t left = publisher.Retired();
+        printf("  %-14s %zu allocated for %llu versions, %zu left retired  %s\n", "Reclaim", allocated,
+            (unsigned long long)versions, left, left == 0 ? "ok" : "differs");
+        return torn == 0 && left == 0 ? 0 : 1;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyWindow
+
+        Summary:  --verify-window: SlidingWindowHull against QuickHull of
+                  the points it should hold, after every operation. Each
+                  trial streams points on a small grid (so duplicates and
+                  collinear runs are common) or anywhere in a square into
+                  a window of up to 24 points, mixing pushes past
+                  capacity, PopFront, EvictOlderThan and Clear.
+
+        Returns:  int
+                    exit code, 1 if a hull differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyWindow()
+    {
+        printf("sliding window hull\n");
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+
+        struct Sample
+        {
+            Point2D point;
+            double  timestamp;
+        };
+        size_t checks[2] = {};
+        size_t differs[2] = {};
+        for (int trial = 0; trial < 400; trial++)
+        {
+            const int grid = trial % 2;
+            const size_t capacity = 1 + draw(24);
+            SlidingWindowHull window(capacity);
+            deque<Sample> live;
+            vector<Point2D> points;
+            double now = 0;
+            for (int op = 0; op < 300; op++)
+            {
+                const uint32_t kind = draw(16);
+                if (kind < 11)
+                {
+                    const Point2D p = grid == 0 ? Point2D{ (double)draw(6), (double)draw(6) }
+                        : Point2D{ draw(65536) / 32768.0 - 1, draw(65536) / 32768.0 - 1 };
+                    now += draw(3);
+                    window.PushBack(p, now);
+                    live.push_back(Sample{ p, now });
+                    if (live.size() > capacity)
+                    {
+                        live.pop_front();
+                    }
+                }
+                else if (kind < 13)
+                {
+                    if (!live.empty())
+                    {
+                        window.PopFront();
+                        live.pop_front();
+                    }
+                }
+                else if (kind < 15)
+                {
+                    const double cutoff = now - draw(12);
+                    window.EvictOlderThan(cutoff);
+                    while (!live.empty() && live.front().timestamp < cutoff)
+                    {
+                        live.pop_front();
+                    }
+                }
+                else if (draw(8) == 0)
+                {
+                    window.Clear();
+                    live.clear();
+                }
+
+                points.clear();
+                for (const Sample& sample : live)
+                {
+                    points.push_back(sample.point);
+                }
+                checks[grid]++;
+                differs[grid] += window.Size() == live.size() && SameAsQuickHull(points, window.Hull()) ? 0 : 1;
+            }
+        }
+        const char* names[2] = { "Grid", "Square" };
+        for (int i = 0; i < 2; i++)
+        {
+            printf("  %-14s %zu of %zu hulls differ  %s\n", names[i], differs[i], checks[i], differs[i] == 0 ? "ok" : "differs");
+        }
+        return differs[0] == 0 && differs[1] == 0 ? 0 : 1;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyPolyline
+
+        Summary:  --verify-polyline: MelkmanHull against QuickHull of
+                  the prefix pushed so far, after every push. Simple
+                  polylines (x monotone on a grid, so with collinear
+                  runs, and star shaped around a center) must come out
+                  right with verify off and never fall back with it on;
+                  points in random order, which are mostly not simple,
+                  must come out right with verify on.
+
+        Returns:  int
+                    exit code, 1 if a hull differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyPolyline()
+    {
+        printf("melkman hull\n");
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+
+        //pushes points one at a time, checking every prefix; returns the number of prefixes that differ
+        const auto run = [](MelkmanHull& melkman, const vector<Point2D>& points)
+        {
+            size_t differs = 0;
+            vector<Point2D> prefix;
+            melkman.Clear();
+            for (const Point2D& p : points)
+            {
+                melkman.Push(p);
+                prefix.push_back(p);
+                differs += SameAsQuickHull(prefix, melkman.Hull()) ? 0 : 1;
+            }
+            return differs;
+        };
+
+        const char* names[3] = { "Monotone", "Star", "Random" };
+        size_t checks[3] = {};
+        size_t differs[3] = {};
+        size_t fellBack[3] = {};
+        MelkmanHull trusting(false);
+        MelkmanHull checked(true);
+        vector<Point2D> points;
+        for (int trial = 0; trial < 3000; trial++)
+        {
+            const int kind = trial % 3;
+            const size_t n = 1 + draw(40);
+            points.resize(n);
+            if (kind == 0)
+            {
+                //distinct x in order, y on a small grid
+                uint32_t x = draw(4);
+                for (Point2D& p : points)
+                {
+                    p = Point2D{ (double)x, (double)draw(5) };
+                    x += 1 + draw(3);
+                }
+                if (draw(2))
+                {
+                    reverse(points.begin(), points.end());
+                }
+            }
+            else if (kind == 1)
+            {
+                //distinct angles in order around the origin
+                double angle = draw(1000) / 1000.0;
+                for (Point2D& p : points)
+                {
+                    const double radius = 0.5 + draw(1000) / 1000.0;
+                    p = Point2D{ radius * cos(angle), radius * sin(angle) };
+                    angle += 6.0 / n * (0.2 + draw(1000) / 1250.0);
+                }
+            }
+            else
+            {
+                for (Point2D& p : points)
+                {
+                    p = Point2D{ (double)draw(8), (double)draw(8) };
+                }
+            }
+
+            if (kind != 2)
+            {
+                differs[kind] += run(trusting, points);
+                checks[kind] += n;
+            }
+            differs[kind] += run(checked, points);
+            checks[kind] += n;
+            fellBack[kind] += checked.FellBack() ? 1 : 0;
+        }
+
+        bool same = true;
+        for (int i = 0; i < 3; i++)
+        {
+            //only the random sets may be caught out as not simple
+            const bool ok = differs[i] == 0 && (i == 2 || fellBack[i] == 0);
+            printf("  %-14s %zu of %zu hulls differ, %zu fell back  %s\n", names[i], differs[i], checks[i], fellBack[i],
+                ok ? "ok" : "differs");
+            same &= ok;
+        }
+        return same ? 0 : 1;
+    }
+
+    //v moved k representable values up: ulps for floating point, units for integers
+    template <class T>
+    T StepUp(T v, uint32_t k)
+    {
+        for (uint32_t i = 0; i < k; i++)
+        {
+            v = is_floating_point<T>::value ? (T)nextafter(v, numeric_limits<T>::max()) : (T)(v + 1);
+        }
+        return v;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: BatchDiffers
+
+        Summary:  Builds sets of 0 to 100 points of one kind each behind
+                  a few points that belong to no set, so offsets[0] is
+                  not 0, hulls them with BatchHulls and compares every
+                  set's hull with QuickHull of that set alone.
+
+        Args:     int kind
+                    0 random, 1 duplicates, 2 collinear, 3 x and y a
+                    few ulps apart
+                  uint32_t& state
+                    the caller's LCG state
+
+        Returns:  size_t
+                    how many sets differ, out of 200
+    -----------------------------------------------------------------F-F*/
+    template <class T>
+    size_t BatchDiffers(int kind, uint32_t& state)
+    {
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+        const size_t setCount = 200;
+        vector<Point2<T>> points(draw(5));
+        vector<uint32_t> offsets(1, (uint32_t)points.size());
+        for (size_t set = 0; set < setCount; set++)
+        {
+            const size_t n = draw(101);
+            const Point2<T> a{ (T)((int)draw(201) - 100), (T)((int)draw(201) - 100) };
+            const Point2<T> d{ (T)((int)draw(7) - 3), (T)((int)draw(7) - 3) };
+            for (size_t i = 0; i < n; i++)
+            {
+                switch (kind)
+                {
+                case 0:
+                    points.push_back(Point2<T>{ (T)((int)draw(2001) - 1000), (T)((int)draw(2001) - 1000) });
+                    break;
+                case 1:
+                    points.push_back(Point2<T>{ (T)(a.x + draw(2)), (T)(a.y + draw(2)) });
+                    break;
+                case 2:
+                {
+                    const T k = (T)draw(20);
+                    points.push_back(Point2<T>{ (T)(a.x + k * d.x), (T)(a.y + k * d.y) });
+                    break;
+                }
+                default:
+                    points.push_back(Point2<T>{ StepUp((T)(a.x / 64), draw(6)), StepUp((T)(a.y / 64), draw(6)) });
+                    break;
+                }
+            }
+            offsets.push_back((uint32_t)points.size());
+        }
+
+        HullBatch hulls;
+        BatchHulls(points.data(), offsets.data(), setCount, hulls, 4);
+        if (hulls.Size() != setCount)
+        {
+            return setCount;
+        }
+        size_t differs = 0;
+        vector<uint32_t> index;
+        for (size_t set = 0; set < setCount; set++)
+        {
+            QuickHull(points.data() + offsets[set], offsets[set + 1] - offsets[set], index);
+            const uint32_t first = hulls.offsets[set];
+            bool same = hulls.offsets[set + 1] - first == index.size();
+            for (size_t i = 0; same && i < index.size(); i++)
+            {
+                const Point2<T>& p = points[hulls.indices[first + i]];
+                const Point2<T>& q = points[offsets[set] + index[i]];
+                same = p.x == q.x && p.y == q.y;
+            }
+            differs += same ? 0 : 1;
+        }
+        return differs;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyBatch
+
+        Summary:  --verify-batch: BatchHulls against per set QuickHull
+                  for float, double and int32_t points, with random,
+                  duplicate, collinear and ulp apart sets, each kind
+                  crossing the 64 point line between the sorting
+                  network and QuickHull.
+
+        Returns:  int
+                    exit code, 1 if a hull differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyBatch()
+    {
+        printf("batch hulls\n");
+        const char* kinds[4] = { "Random", "Duplicates", "Collinear", "Ulps" };
+        uint32_t state = 1;
+        bool same = true;
+        for (int kind = 0; kind < 4; kind++)
+        {
+            size_t differs[3] = {};
+            for (int round = 0; round < 10; round++)
+            {
+                differs[0] += BatchDiffers<float>(kind, state);
+                differs[1] += BatchDiffers<double>(kind, state);
+                differs[2] += BatchDiffers<int32_t>(kind, state);
+            }
+            const bool ok = differs[0] == 0 && differs[1] == 0 && differs[2] == 0;
+            printf("  %-14s %zu float, %zu double, %zu int sets of 2000 differ  %s\n", kinds[kind],
+                differs[0], differs[1], differs[2], ok ? "ok" : "differs");
+            same &= ok;
+        }
+        return same ? 0 : 1;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: SameLayers
+
+        Summary:  ConvexLayers against peeling by repeated QuickHull.
+                  Which of several coincident points lands in which
+                  layer is arbitrary, so layers are compared as sorted
+                  coordinate lists, and each layer's hull both against
+                  the peeled hull and for naming only points of that
+                  layer.
+
+        Args:     const vector<Point2<T>>& points
+                    the set to peel
+
+        Returns:  bool
+                    true if every layer agrees
+    -----------------------------------------------------------------F-F*/
+    template <class T>
+    bool SameLayers(const vector<Point2<T>>& points)
+    {
+        const auto less = [](const Point2<T>& a, const Point2<T>& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); };
+        const auto equalPoint = [](const Point2<T>& a, const Point2<T>& b) { return a.x == b.x && a.y == b.y; };
+
+        vector<uint32_t> layer;
+        HullBatch hulls;
+        const size_t layerCount = ConvexLayers(points.data(), points.size(), layer, &hulls);
+        if (layer.size() != points.size() || hulls.Size() != layerCount)
+        {
+            return false;
+        }
+
+        vector<Point2<T>> left = points;
+        vector<Point2<T>> peeledHull;
+        vector<Point2<T>> members;
+        vector<Point2<T>> expected;
+        vector<uint32_t> index;
+        for (size_t depth = 0; !left.empty(); depth++)
+        {
+            if (depth >= layerCount)
+            {
+                return false;
+            }
+            QuickHull(left.data(), left.size(), index);
+            peeledHull.clear();
+            for (uint32_t i : index)
+            {
+                peeledHull.push_back(left[i]);
+            }
+            expected = peeledHull;
+            sort(expected.begin(), expected.end(), less);
+            members.clear();
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                if (layer[i] == depth)
+                {
+                    members.push_back(points[i]);
+                }
+            }
+            sort(members.begin(), members.end(), less);
+            if (members.size() != expected.size() || !equal(members.begin(), members.end(), expected.begin(), equalPoint))
+            {
+                return false;
+            }
+            const uint32_t first = hulls.offsets[depth];
+            if (hulls.offsets[depth + 1] - first != peeledHull.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < peeledHull.size(); i++)
+            {
+                const uint32_t vertex = hulls.indices[first + i];
+                if (layer[vertex] != depth || !equalPoint(points[vertex], peeledHull[i]))
+                {
+                    return false;
+                }
+            }
+
+            //take out the reported vertices themselves, so of coincident points only one goes
+            sort(index.begin(), index.end());
+            for (size_t i = index.size(); i-- > 0;)
+            {
+                left.erase(left.begin() + index[i]);
+            }
+        }
+        return true;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyLayers
+
+        Summary:  --verify-layers: ConvexLayers against a repeated
+                  QuickHull peel for random double sets, int32_t sets on
+                  a small grid (stacks of coincident points, long
+                  collinear runs) and double sets on concentric circles
+                  with their center.
+
+        Returns:  int
+                    exit code, 1 if a set's layers differ
+    -----------------------------------------------------------------F-F*/
+    int VerifyLayers()
+    {
+        printf("convex layers\n");
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+        const char* names[3] = { "Random", "Grid", "Circles" };
+        size_t differs[3] = {};
+        const size_t sets = 1000;
+        for (size_t trial = 0; trial < sets; trial++)
+        {
+            const size_t n = draw(300);
+            vector<Point2D> random(n);
+            for (Point2D& p : random)
+            {
+                p = Point2D{ draw(65536) / 32768.0 - 1, draw(65536) / 32768.0 - 1 };
+            }
+            vector<Point2I> grid(n);
+            for (Point2I& p : grid)
+            {
+                p = Point2I{ (int32_t)draw(7), (int32_t)draw(7) };
+            }
+            vector<Point2D> circles(1, Point2D{ 0, 0 });
+            const uint32_t rings = 1 + draw(6);
+            const uint32_t spokes = 3 + draw(12);
+            for (uint32_t r = 1; r <= rings; r++)
+            {
+                for (uint32_t k = 0; k < spokes; k++)
+                {
+                    const double angle = 6.283185307179586 * k / spokes;
+                    circles.push_back(Point2D{ r * cos(angle), r * sin(angle) });
+                }
+            }
+            differs[0] += SameLayers(random) ? 0 : 1;
+            differs[1] += SameLayers(grid) ? 0 : 1;
+            differs[2] += SameLayers(circles) ? 0 : 1;
+        }
+        bool same = true;
+        for (int i = 0; i < 3; i++)
+        {
+            printf("  %-14s %zu of %zu sets differ  %s\n", names[i], differs[i], sets, differs[i] == 0 ? "ok" : "differs");
+            same &= differs[i] == 0;
+        }
+        return same ? 0 : 1;
+    }
+
+    double Distance(const Point2D& a, const Point2D& b)
+    {
+        return sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+    }
+
+    //brute force measures of a hull of at least three vertices, rounded the way MeasureHull rounds them
+    template <class T>
+    HullMeasures BruteMeasures(const Point2<T>* points, const vector<uint32_t>& hull)
+    {
+        const size_t count = hull.size();
+        HullMeasures m = {};
+        m.width.width = numeric_limits<double>::infinity();
+        m.minArea.area = numeric_limits<double>::infinity();
+        m.minPerimeter.perimeter = numeric_limits<double>::infinity();
+        for (size_t i = 0; i < count; i++)
+        {
+            const Point2D p = { (double)points[hull[i]].x, (double)points[hull[i]].y };
+            const Point2D q = { (double)points[hull[(i + 1) % count]].x, (double)points[hull[(i + 1) % count]].y };
+            const double length = Distance(p, q);
+            const Point2D u = { (q.x - p.x) / length, (q.y - p.y) / length };
+            double height = 0;
+            double from = 0;
+            double to = 0;
+            for (size_t j = 0; j < count; j++)
+            {
+                const Point2D v = { (double)points[hull[j]].x, (double)points[hull[j]].y };
+                m.diameter.length = max(m.diameter.length, Distance(p, v));
+                height = max(height, Cross(p, q, v) / length);
+                from = min(from, (v.x - p.x) * u.x + (v.y - p.y) * u.y);
+                to = max(to, (v.x - p.x) * u.x + (v.y - p.y) * u.y);
+            }
+            m.width.width = min(m.width.width, height);
+            m.minArea.area = min(m.minArea.area, (to - from) * height);
+            m.minPerimeter.perimeter = min(m.minPerimeter.perimeter, 2 * ((to - from) + height));
+        }
+        return m;
+    }
+
+    //every hull vertex inside r, give or take tolerance
+    template <class T>
+    bool Encloses(const HullRectangle& r, const Point2<T>* points, const vector<uint32_t>& hull, double tolerance)
+    {
+        for (uint32_t i : hull)
+        {
+            const Point2D v = { (double)points[i].x, (double)points[i].y };
+            for (int k = 0; k < 4; k++)
+            {
+                const Point2D& a = r.corners[k];
+                const Point2D& b = r.corners[(k + 1) % 4];
+                if (Cross(a, b, v) < -tolerance * Distance(a, b))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: BruteAntipodalPairs
+
+        Summary:  Antipodal pairs by testing every pair of vertices: i
+                  and j admit parallel support lines when the arc of
+                  directions from the edge into i to the edge out of i
+                  meets the reverse of j's. Coordinates are small enough
+                  that the cross products are exact.
+
+        Args:     const Point2<T>* points
+                    the points
+                  const vector<uint32_t>& hull
+                    a hull of at least three vertices
+
+        Returns:  vector<pair<uint32_t, uint32_t>>
+                    the pairs as point indices, the smaller first, sorted
+    -----------------------------------------------------------------F-F*/
+    template <class T>
+    vector<pair<uint32_t, uint32_t>> BruteAntipodalPairs(const Point2<T>* points, const vector<uint32_t>& hull)
+    {
+        const size_t count = hull.size();
+        const auto edge = [&](size_t i)
+        {
+            const Point2<T>& a = points[hull[i % count]];
+            const Point2<T>& b = points[hull[(i + 1) % count]];
+            return Point2D{ (double)b.x - a.x, (double)b.y - a.y };
+        };
+        const auto cross = [](const Point2D& a, const Point2D& b) { return a.x * b.y - a.y * b.x; };
+        //v in the counter-clockwise arc from a to b, which is less than a half turn
+        const auto within = [&cross](const Point2D& v, const Point2D& a, const Point2D& b) { return cross(a, v) >= 0 && cross(v, b) >= 0; };
+
+        vector<pair<uint32_t, uint32_t>> pairs;
+        for (size_t i = 0; i < count; i++)
+        {
+            const Point2D a1 = edge(i + count - 1);
+            const Point2D a2 = edge(i);
+            for (size_t j = i + 1; j < count; j++)
+            {
+                const Point2D b1 = { -edge(j + count - 1).x, -edge(j + count - 1).y };
+                const Point2D b2 = { -edge(j).x, -edge(j).y };
+                if (within(b1, a1, a2) || within(a1, b1, b2))
+                {
+                    pairs.emplace_back(min(hull[i], hull[j]), max(hull[i], hull[j]));
+                }
+            }
+        }
+        sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: CalipersDiffer
+
+        Summary:  MeasureHull and AntipodalPairs on the hull of one set
+                  against the brute force versions, and the rectangles
+                  for enclosing the hull with the area and perimeter
+                  they report.
+
+        Args:     const vector<Point2<T>>& points
+                    the set
+                  double scale
+                    size of the coordinates, for the tolerances
+
+        Returns:  int
+                    a bit per failed part: 1 measures, 2 rectangles,
+                    4 antipodal pairs
+    -----------------------------------------------------------------F-F*/
+    template <class T>
+    int CalipersDiffer(const vector<Point2<T>>& points, double scale)
+    {
+        vector<uint32_t> hull;
+        QuickHull(points.data(), points.size(), hull);
+        if (hull.size() < 3)
+        {
+            return 0;
+        }
+        const HullMeasures m = MeasureHull(points.data(), hull);
+        const HullMeasures brute = BruteMeasures(points.data(), hull);
+        const auto near = [scale](double a, double b, double size) { return fabs(a - b) <= 1e-12 * size * scale; };
+        const auto length = [&points](uint32_t a, uint32_t b)
+        {
+            const Point2D p = { (double)points[a].x, (double)points[a].y };
+            const Point2D q = { (double)points[b].x, (double)points[b].y };
+            return Distance(p, q);
+        };
+
+        int failed = 0;
+        if (!near(m.diameter.length, brute.diameter.length, 1) || !near(length(m.diameter.a, m.diameter.b), m.diameter.length, 1)
+            || !near(m.width.width, brute.width.width, 1) || !near(m.minArea.area, brute.minArea.area, scale)
+            || !near(m.minPerimeter.perimeter, brute.minPerimeter.perimeter, 1))
+        {
+            failed |= 1;
+        }
+        const HullRectangle* rectangles[2] = { &m.minArea, &m.minPerimeter };
+        for (const HullRectangle* r : rectangles)
+        {
+            const double w = Distance(r->corners[0], r->corners[1]);
+            const double h = Distance(r->corners[1], r->corners[2]);
+            if (!Encloses(*r, points.data(), hull, 1e-12 * scale) || !near(w * h, r->area, scale) || !near(2 * (w + h), r->perimeter, 1))
+            {
+                failed |= 2;
+            }
+        }
+
+        vector<pair<uint32_t, uint32_t>> pairs;
+        AntipodalPairs(points.data(), hull.data(), hull.size(), pairs);
+        for (pair<uint32_t, uint32_t>& p : pairs)
+        {
+            p = make_pair(min(p.first, p.second), max(p.first, p.second));
+        }
+        sort(pairs.begin(), pairs.end());
+        if (pairs != BruteAntipodalPairs(points.data(), hull))
+        {
+            failed |= 4;
+        }
+        return failed;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyCalipers
+
+        Summary:  --verify-calipers: the rotating calipers against brute
+                  force on int32_t sets on a grid, where parallel edges
+                  are common, and on double sets in a square; then
+                  MeasureHulls over a batch against MeasureHull of each
+                  hull.
+
+        Returns:  int
+                    exit code, 1 if anything differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyCalipers()
+    {
+        printf("rotating calipers\n");
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+
+        const char* parts[3] = { "Measures", "Rectangles", "Antipodal" };
+        size_t failures[3] = {};
+        const size_t sets = 2000;
+        for (size_t trial = 0; trial < sets; trial++)
+        {
+            vector<Point2I> grid(3 + draw(40));
+            const uint32_t range = 2 + draw(20);
+            for (Point2I& p : grid)
+            {
+                p = Point2I{ (int32_t)draw(range), (int32_t)draw(range) };
+            }
+            vector<Point2D> square(3 + draw(40));
+            for (Point2D& p : square)
+            {
+                p = Point2D{ draw(65536) / 32768.0 - 1, draw(65536) / 32768.0 - 1 };
+            }
+            const int failed = CalipersDiffer(grid, range) | CalipersDiffer(square, 2.0);
+            for (int i = 0; i < 3; i++)
+            {
+                failures[i] += (failed >> i) & 1;
+            }
+        }
+        bool same = true;
+        for (int i = 0; i < 3; i++)
+        {
+            printf("  %-14s %zu of %zu set pairs differ  %s\n", parts[i], failures[i], sets, failures[i] == 0 ? "ok" : "differs");
+            same &= failures[i] == 0;
+        }
+
+        //a batch of grid sets, measured on four threads and one hull at a time
+        vector<Point2I> packed;
+        vector<uint32_t> offsets(1, 0);
+        for (int set = 0; set < 500; set++)
+        {
+            const size_t n = draw(60);
+            for (size_t i = 0; i < n; i++)
+            {
+                packed.push_back(Point2I{ (int32_t)draw(50), (int32_t)draw(50) });
+            }
+            offsets.push_back((uint32_t)packed.size());
+        }
+        HullBatch hulls;
+        BatchHulls(packed.data(), offsets.data(), offsets.size() - 1, hulls);
+        vector<HullMeasures> measures;
+        MeasureHulls(packed.data(), hulls, measures, 4);
+        size_t batchDiffers = measures.size() == hulls.Size() ? 0 : hulls.Size();
+        for (size_t i = 0; batchDiffers == 0 && i < measures.size(); i++)
+        {
+            const HullMeasures one = MeasureHull(packed.data(), hulls.indices.data() + hulls.offsets[i],
+                hulls.offsets[i + 1] - hulls.offsets[i]);
+            const HullMeasures& many = measures[i];
+            batchDiffers += one.diameter.length == many.diameter.length && one.diameter.a == many.diameter.a
+                && one.width.width == many.width.width && one.width.edge == many.width.edge
+                && one.minArea.area == many.minArea.area && one.minArea.edge == many.minArea.edge
+                && one.minPerimeter.perimeter == many.minPerimeter.perimeter && one.minPerimeter.edge == many.minPerimeter.edge ? 0 : 1;
+        }
+        printf("  %-14s %zu of %zu hulls differ  %s\n", "MeasureHulls", batchDiffers, hulls.Size(), batchDiffers == 0 ? "ok" : "differs");
+        same &= batchDiffers == 0;
+
+        return same ? 0 : 1;
+    }
+
+    //every vertex of inside within tolerance of the convex polygon outside, given counter-clockwise
+    bool Contains(const vector<Point2D>& outside, const vector<Point2D>& inside, double tolerance)
+    {
+        for (const Point2D& v : inside)
+        {
+            for (size_t k = 0; k < outside.size(); k++)
+            {
+                const Point2D& a = outside[k];
+                const Point2D& b = outside[(k + 1) % outside.size()];
+                if (Cross(a, b, v) < -tolerance * Distance(a, b))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyLod
+
+        Summary:  --verify-lod: level of detail chains of pairs of
+                  circles of 200 points whose centers are 1.9 to 2.1
+                  apart, so about half of them touch. Every chain must
+                  end with the polygon itself and nest, outer levels
+                  around finer ones and inner levels inside them, and
+                  GjkIntersectLod on the outer chains must agree with
+                  GjkIntersect on the polygons.
+
+        Returns:  int
+                    exit code, 1 if a chain or a test differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyLod()
+    {
+        printf("hull level of detail\n");
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+
+        size_t chainDiffers = 0;
+        size_t lodDiffers = 0;
+        size_t touching = 0;
+        size_t levelsUsed = 0;
+        const size_t pairs = 500;
+        for (size_t trial = 0; trial < pairs; trial++)
+        {
+            vector<Point2D> hullOf[2];
+            vector<HullLevel> lod[2];
+            for (int k = 0; k < 2; k++)
+            {
+                const double angle = draw(6283) / 1000.0;
+                const double distance = k == 0 ? 0 : 1.9 + draw(2001) / 10000.0;
+                vector<Point2D> circle(200);
+                for (size_t i = 0; i < circle.size(); i++)
+                {
+                    const double t = 6.283185307179586 * i / circle.size() + k * 0.01;
+                    circle[i] = Point2D{ distance * cos(angle) + cos(t), distance * sin(angle) + sin(t) };
+                }
+                vector<uint32_t> index;
+                Hull(MakePointSpan(circle.data(), circle.size()), index, hullOf[k]);
+                BuildHullLod(hullOf[k].data(), hullOf[k].size(), HullFit::Outer, lod[k]);
+
+                vector<HullLevel> inner;
+                BuildHullLod(hullOf[k].data(), hullOf[k].size(), HullFit::Inner, inner);
+                bool nested = SameVertices(lod[k].back().vertices, hullOf[k]) && SameVertices(inner.back().vertices, hullOf[k]);
+                for (size_t i = 0; nested && i + 1 < lod[k].size(); i++)
+                {
+                    nested = Contains(lod[k][i].vertices, lod[k][i + 1].vertices, 1e-12);
+                }
+                for (size_t i = 0; nested && i + 1 < inner.size(); i++)
+                {
+                    nested = Contains(inner[i + 1].vertices, inner[i].vertices, 1e-12);
+                }
+                chainDiffers += nested ? 0 : 1;
+            }
+            size_t levels = 0;
+            const bool exact = GjkIntersect(hullOf[0].data(), hullOf[0].size(), hullOf[1].data(), hullOf[1].size());
+            lodDiffers += GjkIntersectLod(lod[0], lod[1], &levels) == exact ? 0 : 1;
+            touching += exact ? 1 : 0;
+            levelsUsed += levels;
+        }
+        printf("  %-14s %zu of %zu chains do not nest  %s\n", "BuildHullLod", chainDiffers, 2 * pairs,
+            chainDiffers == 0 ? "ok" : "differs");
+        printf("  %-14s %zu of %zu pairs differ (%zu touch, %.1f levels each)  %s\n", "GjkLod", lodDiffers, pairs, touching,
+            (double)levelsUsed / pairs, lodDiffers == 0 ? "ok" : "differs");
+        return chainDiffers == 0 && lodDiffers == 0 ? 0 : 1;
+    }
+
+    //writes points as x,y lines that read back exactly, after preamble
+    bool WriteTextPoints(const string& path, const char* preamble, const vector<Point2D>& points, const char* newline)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        fputs(preamble, file);
+        for (const Point2D& p : points)
+        {
+            fprintf(file, "%.17g,%.17g%s", p.x, p.y, newline);
+        }
+        return fclose(file) == 0;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: VerifyStream
+
+        Summary:  --verify-stream: TextFileHull against QuickHull of the
+                  same points, through a file in the working directory.
+                  Random points in a square with 4 KB chunks, 70000
+                  points on a circle (every chunk hull is its whole
+                  chunk, so the kept vertices are folded), and grid
+                  points with duplicates, collinear runs, comments, a
+                  CSV header and CRLF line ends, whose one bad line must
+                  be counted. Then OutOfCoreHull on raw files: doubles
+                  behind a 24 byte header on four threads, floats behind
+                  8 bytes with half a pair left over at the end, both in
+                  chunks of a few hundred points, and a header that is
+                  not a whole number of scalars, which must be refused.
+
+        Returns:  int
+                    exit code, 1 if a hull differs
+    -----------------------------------------------------------------F-F*/
+    int VerifyStream()
+    {
+        printf("stream hull\n");
+        const string path = "hullcli-verify-stream.tmp";
+        uint32_t state = 1;
+        const auto draw = [&state](uint32_t range)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 16) % range;
+        };
+
+        struct Case
+        {
+            const char*     name;
+            const char*     preamble;
+            const char*     newline;
+            size_t          chunkBytes;
+            uint64_t        badLines;
+            vector<Point2D> points;
+        };
+        vector<Case> cases(3);
+        cases[0] = Case{ "Square", "", "\n", 4096, 0, vector<Point2D>(20000) };
+        for (Point2D& p : cases[0].points)
+        {
+            p = Point2D{ draw(65536) / 32768.0 - 1, draw(65536) / 32768.0 - 1 };
+        }
+        cases[1] = Case{ "Circle", "", "\n", 1 << 16, 0, vector<Point2D>(70000) };
+        for (size_t i = 0; i < cases[1].points.size(); i++)
+        {
+            const double angle = 6.283185307179586 * i / cases[1].points.size();
+            cases[1].points[i] = Point2D{ cos(angle), sin(angle) };
+        }
+        cases[2] = Case{ "Grid", "x,y\r\n# grid points\r\n\r\n", "\r\n", 256, 1, vector<Point2D>(3000) };
+        for (Point2D& p : cases[2].points)
+        {
+            p = Point2D{ (double)draw(8), (double)draw(8) };
+        }
+
+        bool same = true;
+        for (const Case& c : cases)
+        {
+            TextParseOptions options;
+            options.chunkBytes = c.chunkBytes;
+            TextParseStats stats;
+            vector<Point2D> hull;
+            const bool ok = WriteTextPoints(path, c.preamble, c.points, c.newline)
+                && TextFileHull(path, hull, options, &stats)
+                && stats.points == c.points.size() && stats.badLines == c.badLines
+                && SameAsQuickHull(c.points, hull);
+            printf("  %-14s %zu points, %zu vertices  %s\n", c.name, c.points.size(), hull.size(), ok ? "ok" : "differs");
+            same &= ok;
+        }
+
+        //raw pairs: the square's points, rounded to float for the float file so both sides see the same values
+        vector<Point2D> rounded = cases[0].points;
+        for (Point2D& p : rounded)
+        {
+            p = Point2D{ (float)p.x, (float)p.y };
+        }
+        const auto writeRaw = [&path](PointFormat format, size_t headerBytes, const vector<Point2D>& points, size_t tailBytes)
+        {
+            vector<char> bytes(headerBytes, 'h');
+            for (const Point2D& p : points)
+            {
+                if (format == PointFormat::Float64)
+                {
+                    bytes.insert(bytes.end(), (const char*)&p, (const char*)&p + sizeof(p));
+                }
+                else
+                {
+                    const float xy[2] = { (float)p.x, (float)p.y };
+                    bytes.insert(bytes.end(), (const char*)xy, (const char*)xy + sizeof(xy));
+                }
+            }
+            bytes.insert(bytes.end(), tailBytes, 't');
+            FILE* file = fopen(path.c_str(), "wb");
+            const bool ok = file && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+            return (file && fclose(file) == 0) && ok;
+        };
+        struct RawCase
+        {
+            const char*            name;
+            PointFormat            format;
+            size_t                 headerBytes;
+            size_t                 tailBytes;
+            size_t                 chunkPoints;
+            unsigned               threads;
+            const vector<Point2D>* points;
+        };
+        const RawCase rawCases[] =
+        {
+            { "RawDouble", PointFormat::Float64, 24, 0, 500, 4, &cases[0].points },
+            { "RawFloat", PointFormat::Float32, 8, 4, 333, 2, &rounded }
+        };
+        for (const RawCase& c : rawCases)
+        {
+            OutOfCoreOptions options;
+            options.format = c.format;
+            options.headerBytes = c.headerBytes;
+            options.chunkPoints = c.chunkPoints;
+            options.threads = c.threads;
+            OutOfCoreResult result;
+            const bool ok = writeRaw(c.format, c.headerBytes, *c.points, c.tailBytes)
+                && OutOfCoreHull(path, options, result)
+                && result.points == c.points->size() && SameAsQuickHull(*c.points, result.hull);
+            printf("  %-14s %zu points, %zu chunks, %zu vertices  %s\n", c.name, c.points->size(), result.chunks,
+                result.hull.size(), ok ? "ok" : "differs");
+            same &= ok;
+        }
+        OutOfCoreOptions misaligned;
+        misaligned.headerBytes = 12;
+        OutOfCoreResult refused;
+        const bool rejected = writeRaw(PointFormat::Float64, 12, cases[0].points, 0) && !OutOfCoreHull(path, misaligned, refused);
+        printf("  %-14s %s\n", "RawMisaligned", rejected ? "ok" : "differs");
+        same &= rejected;
+
+        remove(path.c_str());
+        return same ? 0 : 1;
+    }
+
+    //mean, 95th percentile and worst of a set of latencies
+    void PrintLatency(const char* name, vector<double> ms, double finalMs)
+    {
+        sort(ms.begin(), ms.end());
+        double total = 0;
+        for (double m : ms)
+        {
+            total += m;
+        }
+        const double mean = ms.empty() ? 0 : total / ms.size();
+        const double p95 = ms.empty() ? 0 : ms[min(ms.size() - 1, ms.size() * 95 / 100)];
+        const double worst = ms.empty() ? 0 : ms.back();
+        printf("  %-6s latency %.3f ms mean, %.3f ms p95, %.3f ms max; last event shown after %.3f ms\n",
+            name, mean, p95, worst, finalMs);
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: DragSim
+
+        Summary:  --drag-sim: replays the same synthetic mouse stream
+                  against an inline computation and against HullWorker.
+                  Event i is due at start + i * interval; a computation
+                  still running when the next event is due delays it,
+                  as queued mouse messages do. Latency is the time from
+                  an event being due to its result being available.
+
+        Args:     const vector<string>& args
+                    the arguments after --drag-sim
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int DragSim(const vector<string>& args)
+    {
+        size_t events = 200;
+        double intervalMs = 8;
+        unsigned maxLagMs = 100;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if ((args[i] == "--events" || args[i] == "--interval" || args[i] == "--max-lag") && i + 1 < args.size())
+            {
+                const double value = atof(args[i + 1].c_str());
+                if (args[i] == "--events")
+                    events = (size_t)max(2.0, value);
+                else if (args[i] == "--interval")
+                    intervalMs = max(0.0, value);
+                else
+                    maxLagMs = (unsigned)max(0.0, value);
+                i++;
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 2)
+        {
+            fprintf(stderr, "hullcli: --drag-sim takes 2 inputs\n");
+            return 2;
+        }
+
+        vector<Point2D> sets[2];
+        for (size_t s = 0; s < 2; s++)
+        {
+            if (!LoadPoints(paths[s], sets[s]))
+            {
+                fprintf(stderr, "hullcli: cannot read %s\n", paths[s].c_str());
+                return 1;
+            }
+        }
+        const vector<Point2D>& fixed = sets[0];
+        const vector<Point2D>& moving = sets[1];
+
+        //the drag sweeps the moving set twice the fixed set's width, left to right through it
+        double minX = 0;
+        double maxX = 0;
+        for (size_t i = 0; i < fixed.size(); i++)
+        {
+            minX = i ? min(minX, fixed[i].x) : fixed[i].x;
+            maxX = i ? max(maxX, fixed[i].x) : fixed[i].x;
+        }
+        const double width = maxX - minX;
+        auto makeRequest = [&](size_t event)
+        {
+            HullRequest request;
+            request.operation = HullOperation::MinkowskiDifference;
+            request.first = fixed;
+            request.second = moving;
+            const double dx = -width + 2 * width * event / (events - 1);
+            for (Point2D& p : request.second)
+            {
+                p.x += dx;
+            }
+            return request;
+        };
+        const auto interval = chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(intervalMs));
+
+        printf("drag-sim: %zu events every %.3f ms, %zu + %zu points\n", events, intervalMs, fixed.size(), moving.size());
+
+        //inline: every event computed in full before the next is looked at
+        vector<double> inlineMs;
+        double computeMs = 0;
+        {
+            Arena scratch;
+            vector<uint32_t> index;
+            vector<Point2D> hullA, hullB, difference;
+            const auto start = Clock::now();
+            for (size_t e = 0; e < events; e++)
+            {
+                const auto due = start + e * interval;
+                this_thread::sleep_until(due);
+                const auto begin = Clock::now();
+                const HullRequest request = makeRequest(e);
+                QuickHull(request.first.data(), request.first.size(), index, scratch);
+                HullVertices(request.first.data(), index, hullA);
+                QuickHull(request.second.data(), request.second.size(), index, scratch);
+                HullVertices(request.second.data(), index, hullB);
+                MinkowskiDifference(hullA.data(), hullA.size(), hullB.data(), hullB.size(), difference, scratch);
+                PointInConvexHull(Point2D{ 0, 0 }, difference.data(), difference.size());
+                computeMs += Milliseconds(begin);
+                inlineMs.push_back(Milliseconds(due));
+            }
+        }
+        printf("  inline compute %.3f ms mean per event\n", computeMs / events);
+        PrintLatency("inline", inlineMs, inlineMs.back());
+
+        //worker: events only take a snapshot, results arrive when they arrive
+        vector<Clock::time_point> due(events);
+        vector<double> workerMs;
+        mutex resultMutex;
+        double finalMs = 0;
+        HullWorkerStats stats;
+        {
+            vector<uint64_t> sequenceEvent(events + 1);
+            HullWorker* published = nullptr;
+            HullWorker worker([&](uint64_t sequence)
+            {
+                const auto result = published->Latest();
+                lock_guard<mutex> lock(resultMutex);
+                const size_t e = sequenceEvent[sequence];
+                workerMs.push_back(chrono::duration<double, milli>(result->finished - due[e]).count());
+                if (e + 1 == events)
+                {
+                    finalMs = workerMs.back();
+                }
+            }, chrono::milliseconds(maxLagMs));
+            published = &worker;
+
+            const auto start = Clock::now();
+            for (size_t e = 0; e < events; e++)
+            {
+                due[e] = start + e * interval;
+                this_thread::sleep_until(due[e]);
+                HullRequest request = makeRequest(e);
+                lock_guard<mutex> lock(resultMutex);
+                sequenceEvent[worker.Submit(move(request))] = e;
+            }
+            worker.WaitIdle();
+            stats = worker.Stats();
+        }
+        printf("  worker published %llu of %llu, %llu dropped waiting, %llu cancelled\n",
+            (unsigned long long)stats.published, (unsigned long long)stats.submitted,
+            (unsigned long long)stats.dropped, (unsigned long long)stats.cancelled);
+        PrintLatency("worker", workerMs, finalMs);
+        return 0;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: Anytime
+
+        Summary:  --anytime: runs an AnytimeHull a frame at a time, as an
+                  interactive caller would, and reports how the hull and
+                  its error bound improve from frame to frame.
+
+        Args:     const vector<string>& args
+                    the arguments after --anytime
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int Anytime(const vector<string>& args)
+    {
+        double budgetMs = 1;
+        unsigned directions = 8;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if ((args[i] == "--budget" || args[i] == "--directions") && i + 1 < args.size())
+            {
+                const double value = atof(args[i + 1].c_str());
+                if (args[i] == "--budget")
+                    budgetMs = max(0.0, value);
+                else
+                    directions = (unsigned)max(0.0, value);
+                i++;
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 1)
+        {
+            fprintf(stderr, "hullcli: --anytime takes 1 input\n");
+            return 2;
+        }
+
+        vector<Point2D> points;
+        if (!LoadPoints(paths[0], points))
+        {
+            fprintf(stderr, "hullcli: cannot read %s\n", paths[0].c_str());
+            return 1;
+        }
+
+        AnytimeHull anytime(directions);
+        anytime.Reset(points);
+        const auto budget = chrono::duration_cast<Clock::duration>(chrono::duration<double, milli>(budgetMs));
+        const auto start = Clock::now();
+        for (size_t frame = 1; ; frame++)
+        {
+            const bool done = anytime.RefineFor(budget);
+            printf("frame %zu: %zu vertices, error bound %g, %zu points visited, %.3f ms\n",
+                frame, anytime.Hull().size(), anytime.ErrorBound(), anytime.Work(), Milliseconds(start));
+            if (done)
+            {
+                break;
+            }
+        }
+
+        vector<uint32_t> index;
+        vector<Point2D> exact;
+        QuickHull(points, index);
+        HullVertices(points.data(), index, exact);
+        const vector<Point2D>& hull = anytime.Hull();
+        const bool same = hull.size() == exact.size() && equal(hull.begin(), hull.end(), exact.begin(),
+            [](const Point2D& p, const Point2D& q) { return p.x == q.x && p.y == q.y; });
+        printf("anytime: %s QuickHull (%zu vertices)\n", same ? "matches" : "DIFFERS from", exact.size());
+        return same ? 0 : 1;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: EpsKernelRun
+
+        Summary:  --eps-kernel: builds an EpsKernel of the input in one
+                  pass and compares its cost and error with the exact
+                  hull's.
+
+        Args:     const vector<string>& args
+                    the arguments after --eps-kernel
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int EpsKernelRun(const vector<string>& args)
+    {
+        double epsilon = 0.01;
+        string output;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if (args[i] == "--epsilon" && i + 1 < args.size())
+            {
+                epsilon = atof(args[++i].c_str());
+            }
+            else if (args[i] == "--output" && i + 1 < args.size())
+            {
+                output = args[++i];
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 1)
+        {
+            fprintf(stderr, "hullcli: --eps-kernel takes 1 input\n");
+            return 2;
+        }
+
+        //kept mapped rather than copied out: the kernel streams straight from the file
+        Input input;
+        if (!OpenInput(paths[0], input))
+        {
+            fprintf(stderr, "hullcli: cannot read %s\n", paths[0].c_str());
+            return 1;
+        }
+        const PointSpan span = input.Span();
+
+        EpsKernel kernel(epsilon);
+        auto start = Clock::now();
+        kernel.Add(span);
+        const vector<Point2D>& points = kernel.Points();
+        const double kernelMs = Milliseconds(start);
+
+        vector<uint32_t> index;
+        start = Clock::now();
+        QuickHull(span, index);
+        const double hullMs = Milliseconds(start);
+
+        const double bound = kernel.ErrorBound();
+        const double diameter = kernel.Diameter();
+        printf("eps-kernel: %zu of %zu points, %zu directions, epsilon %g\n",
+            points.size(), span.count, kernel.Directions(), kernel.Epsilon());
+        printf("  error bound %g, diameter %g, ratio %g\n", bound, diameter, diameter > 0 ? bound / diameter : 0.0);
+        printf("  kernel %.3f ms, quickhull %.3f ms (%zu vertices)\n", kernelMs, hullMs, index.size());
+
+        if (!output.empty() && !WritePointFile(output, PointFileKind::PointSet, MakePointSpan(points.data(), points.size())))
+        {
+            fprintf(stderr, "hullcli: cannot write %s\n", output.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: StreamHull
+
+        Summary:  --stream-hull: hulls a text file chunk by chunk with
+                  TextFileHull, never holding more than two chunks of
+                  its points, or with --raw a file of binary pairs with
+                  OutOfCoreHull.
+
+        Args:     const vector<string>& args
+                    the arguments after --stream-hull
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int StreamHull(const vector<string>& args)
+    {
+        TextParseOptions options;
+        OutOfCoreOptions rawOptions;
+        bool raw = false;
+        string output;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if (args[i] == "--chunk" && i + 1 < args.size())
+            {
+                options.chunkBytes = rawOptions.chunkPoints = max<size_t>(1, strtoull(args[++i].c_str(), nullptr, 10));
+            }
+            else if (args[i] == "--raw" && i + 1 < args.size())
+            {
+                const string format = args[++i];
+                if (format != "f32" && format != "f64")
+                {
+                    fprintf(stderr, "hullcli: --raw takes f32 or f64\n");
+                    return 2;
+                }
+                raw = true;
+                rawOptions.format = format == "f32" ? PointFormat::Float32 : PointFormat::Float64;
+            }
+            else if (args[i] == "--skip" && i + 1 < args.size())
+            {
+                rawOptions.headerBytes = strtoull(args[++i].c_str(), nullptr, 10);
+            }
+            else if (args[i] == "--threads" && i + 1 < args.size())
+            {
+                rawOptions.threads = (unsigned)atoi(args[++i].c_str());
+            }
+            else if (args[i] == "--output" && i + 1 < args.size())
+            {
+                output = args[++i];
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 1)
+        {
+            fprintf(stderr, "hullcli: --stream-hull takes 1 input\n");
+            return 2;
+        }
+        if (!raw && IsPointFile(paths[0]))
+        {
+            fprintf(stderr, "hullcli: --stream-hull reads text or --raw pairs; %s is a point file\n", paths[0].c_str());
+            return 2;
+        }
+
+        vector<Point2D> hull;
+        if (raw)
+        {
+            OutOfCoreResult result;
+            if (!OutOfCoreHull(paths[0], rawOptions, result))
+            {
+                fprintf(stderr, "hullcli: cannot read %s (or --skip is not a whole number of scalars)\n", paths[0].c_str());
+                return 1;
+            }
+            printf("stream-hull: %zu vertices of %llu points in %zu chunks, %.3f s, %.1f M points/s\n", result.hull.size(),
+                (unsigned long long)result.points, result.chunks, result.seconds, result.pointsPerSecond / 1e6);
+            hull.swap(result.hull);
+        }
+        else
+        {
+            TextParseStats stats;
+            if (!TextFileHull(paths[0], hull, options, &stats))
+            {
+                fprintf(stderr, "hullcli: cannot read %s\n", paths[0].c_str());
+                return 1;
+            }
+            printf("stream-hull: %zu vertices of %llu points, %.3f s, %.1f MB/s\n", hull.size(),
+                (unsigned long long)stats.points, stats.seconds, stats.bytesPerSecond / 1e6);
+            if (stats.badLines > 0)
+            {
+                fprintf(stderr, "hullcli: %s: skipped %llu lines that are not x y points\n",
+                    paths[0].c_str(), (unsigned long long)stats.badLines);
+            }
+        }
+
+        if (!output.empty())
+        {
+            vector<uint32_t> order(hull.size());
+            for (uint32_t i = 0; i < order.size(); i++)
+            {
+                order[i] = i;
+            }
+            if (!WritePointFile(output, PointFileKind::Hull, MakePointSpan(hull.data(), hull.size()),
+                order.data(), order.size()))
+            {
+                fprintf(stderr, "hullcli: cannot write %s\n", output.c_str());
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: WindowHull
+
+        Summary:  --window-hull: the hull of a moving window over the
+                  input, taken after every point as a monitor would.
+
+        Args:     const vector<string>& args
+                    the arguments after --window-hull
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int WindowHull(const vector<string>& args)
+    {
+        size_t capacity = 1000;
+        double span = -1;
+        string output;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if (args[i] == "--window" && i + 1 < args.size())
+            {
+                capacity = strtoull(args[++i].c_str(), nullptr, 10);
+            }
+            else if (args[i] == "--span" && i + 1 < args.size())
+            {
+                span = atof(args[++i].c_str());
+            }
+            else if (args[i] == "--output" && i + 1 < args.size())
+            {
+                output = args[++i];
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 1)
+        {
+            fprintf(stderr, "hullcli: --window-hull takes 1 input\n");
+            return 2;
+        }
+        Input input;
+        if (!OpenInput(paths[0], input))
+        {
+            fprintf(stderr, "hullcli: cannot read %s\n", paths[0].c_str());
+            return 1;
+        }
+        const PointSpan points = input.Span();
+
+        SlidingWindowHull window(capacity);
+        size_t vertices = 0;
+        size_t largest = 0;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < points.count; i++)
+        {
+            window.PushBack(points[i], (double)i);
+            if (span >= 0)
+            {
+                window.EvictOlderThan(i - span);
+            }
+            const size_t size = window.Hull().size();
+            vertices += size;
+            largest = max(largest, size);
+        }
+        const double ms = Milliseconds(start);
+        printf("window-hull: %zu points, window %zu, %.1f ns per update\n", points.count, capacity,
+            points.count ? ms * 1e6 / points.count : 0.0);
+        printf("  hull vertices: mean %.1f, largest %zu, last %zu\n", points.count ? (double)vertices / points.count : 0.0,
+            largest, window.Hull().size());
+
+        const vector<Point2D>& hull = window.Hull();
+        if (!output.empty())
+        {
+            vector<uint32_t> order(hull.size());
+            for (uint32_t i = 0; i < order.size(); i++)
+            {
+                order[i] = i;
+            }
+            if (!WritePointFile(output, PointFileKind::Hull, MakePointSpan(hull.data(), hull.size()),
+                order.data(), order.size()))
+            {
+                fprintf(stderr, "hullcli: cannot write %s\n", output.c_str());
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: PolylineHull
+
+        Summary:  --polyline-hull: MelkmanHull of the input taken as a
+                  polyline in file order.
+
+        Args:     const vector<string>& args
+                    the arguments after --polyline-hull
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int PolylineHull(const vector<string>& args)
+    {
+        bool verify = true;
+        string output;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if (args[i] == "--trust-simple")
+            {
+                verify = false;
+            }
+            else if (args[i] == "--output" && i + 1 < args.size())
+            {
+                output = args[++i];
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 1)
+        {
+            fprintf(stderr, "hullcli: --polyline-hull takes 1 input\n");
+            return 2;
+        }
+        Input input;
+        if (!OpenInput(paths[0], input))
+        {
+            fprintf(stderr, "hullcli: cannot read %s\n", paths[0].c_str());
+            return 1;
+        }
+        const PointSpan points = input.Span();
+
+        MelkmanHull melkman(verify);
+        auto start = Clock::now();
+        for (size_t i = 0; i < points.count; i++)
+        {
+            melkman.Push(points[i]);
+        }
+        const vector<Point2D>& hull = melkman.Hull();
+        const double melkmanMs = Milliseconds(start);
+
+        vector<uint32_t> index;
+        start = Clock::now();
+        QuickHull(points, index);
+        const double hullMs = Milliseconds(start);
+
+        printf("polyline-hull: %zu vertices of %zu points, %s\n", hull.size(), points.count,
+            melkman.FellBack() ? "not simple, fell back to QuickHull" : verify ? "simple" : "taken as simple");
+        printf("  melkman %.3f ms, quickhull %.3f ms (%zu vertices)\n", melkmanMs, hullMs, index.size());
+
+        if (!output.empty())
+        {
+            vector<uint32_t> order(hull.size());
+            for (uint32_t i = 0; i < order.size(); i++)
+            {
+                order[i] = i;
+            }
+            if (!WritePointFile(output, PointFileKind::Hull, MakePointSpan(hull.data(), hull.size()),
+                order.data(), order.size()))
+            {
+                fprintf(stderr, "hullcli: cannot write %s\n", output.c_str());
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        Function: Simplify
+
+        Summary:  --simplify: simplifies the hull of the input to a
+                  vertex count or a tolerance, and lists the level of
+                  detail chain built from it.
+
+        Args:     const vector<string>& args
+                    the arguments after --simplify
+
+        Returns:  int
+                    exit code
+    -----------------------------------------------------------------F-F*/
+    int Simplify(const vector<string>& args)
+    {
+        size_t maxVertices = 16;
+        double tolerance = -1;
+        HullFit fit = HullFit::Inner;
+        string output;
+        vector<string> paths;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if (args[i] == "--max-vertices" && i + 1 < args.size())
+            {
+                maxVertices = (size_t)max(0.0, atof(args[++i].c_str()));
+            }
+            else if (args[i] == "--tolerance" && i + 1 < args.size())
+            {
+                tolerance = max(0.0, atof(args[++i].c_str()));
+            }
+            else if (args[i] == "--outer")
+            {
+                fit = HullFit::Outer;
+            }
+            else if (args[i] == "--output" && i + 1 < args.size())
+            {
+                output = args[++i];
+            }
+            else
+            {
+                paths.push_back(args[i]);
+            }
+        }
+        if (paths.size() != 1)
+        {
+            fprintf(stderr, "hullcli: --simplify takes 1 input\n");
+            return 2;
+        }
+
+        vector<Point2D> points;
+        if (!LoadPoints(paths[0], points))
+        {
+            fprintf(stderr, "hullcli: cannot read %s\n", paths[0].c_str());
+            return 1;
+        }
+        vector<uint32_t> index;
+        vector<Point2D> hull;
+        QuickHull(points, index);
+        HullVertices(points.data(), index, hull);
+
+        vector<Point2D> simplified;
+        const auto start = Clock::now();
+        const double error = tolerance >= 0
+            ? SimplifyHullWithin(hull.data(), hull.size(), tolerance, fit, simplified)
+            : SimplifyHull(hull.data(), hull.size(), maxVertices, fit, simplified);
+        const double simplifyMs = Milliseconds(start);
+        printf("simplify: %zu of %zu hull vertices, %s, error %g, %.3f ms\n", simplified.size(), hull.size(),
+            fit == HullFit::Outer ? "outer" : "inner", error, simplifyMs);
+
+        vector<HullLevel> levels;
+        BuildHullLod(hull.data(), hull.size(), fit, levels);
+        for (size_t i = 0; i < levels.size(); i++)
+        {
+            printf("  level %zu: %zu vertices, error %g\n", i, levels[i].vertices.size(), levels[i].error);
+        }
+
+        if (!output.empty())
+        {
+            vector<uint32_t> order(simplified.size());
+            for (uint32_t i = 0; i < order.size(); i++)
+            {
+                order[i] = i;
+            }
+            if (!WritePointFile(output, PointFileKind::Hull, MakePointSpan(simplified.data(), simplified.size()),
+                order.data(), order.size()))
+            {
+                fprintf(stderr, "hullcli: cannot write %s\n", output.c_str());
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    int Usage()
+    {
+        fprintf(stderr,
+            "usage: hullcli [--repeat N] [--quiet] [--output FILE] [--trace FILE] <mode> <input> [<input>]\n"
+            "       hullcli [--repeat N] [--quiet] [--trace FILE] --batch <job file | ->\n"
+            "       hullcli --verify-static\n"
+            "       hullcli --verify-kinetic\n"
+            "       hullcli --verify-snapshot\n"
+            "       hullcli --verify-stream\n"
+            "       hullcli --verify-window\n"
+            "       hullcli --verify-polyline\n"
+            "       hullcli --verify-batch\n"
+            "       hullcli --verify-layers\n"
+            "       hullcli --verify-calipers\n"
+            "       hullcli --verify-lod\n"
+            "       hullcli --drag-sim [--events N] [--interval MS] [--max-lag MS] <points> <points>\n"
+            "       hullcli --anytime [--budget MS] [--directions K] <points>\n"
+            "       hullcli --eps-kernel [--epsilon E] [--output FILE] <points>\n"
+            "       hullcli --stream-hull [--chunk BYTES] [--output FILE] <text points>\n"
+            "       hullcli --stream-hull --raw f32|f64 [--skip BYTES] [--chunk N] [--threads T] [--output FILE] <pairs>\n"
+            "       hullcli --window-hull [--window W] [--span T] [--output FILE] <points>\n"
+            "       hullcli --polyline-hull [--trust-simple] [--output FILE] <points>\n"
+            "       hullcli --simplify [--max-vertices K | --tolerance T] [--outer] [--output FILE] <points>\n"
+            "modes: quickhull, minkowski-sum, minkowski-diff, point-in-hull, gjk, measure, layers\n");
+        return 2;
+    }
+
+    //writes the trace and prints the instrumentation summary when --trace was given
+    int Finish(const string& tracePath, int status)
+    {
+        if (!tracePath.empty())
+        {
+            if (!Instrument::WriteChromeTrace(tracePath))
+            {
+                fprintf(stderr, "hullcli: cannot write %s\n", tracePath.c_str());
+                status = 1;
+            }
+            fprintf(stderr, "%s", Instrument::SummaryTable().c_str());
+        }
+        return status;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    vector<string> args(argv + 1, argv + argc);
+    if (args.size() == 1 && args[0] == "--verify-static")
+    {
+        return VerifyStatic();
+    }
+    if (args.size() == 1 && args[0] == "--verify-kinetic")
+    {
+        return VerifyKinetic();
+    }
+    if (args.size() == 1 && args[0] == "--verify-snapshot")
+    {
+        return VerifySnapshot();
+    }
+    if (args.size() == 1 && args[0] == "--verify-stream")
+    {
+        return VerifyStream();
+    }
+    if (args.size() == 1 && args[0] == "--verify-window")
+    {
+        return VerifyWindow();
+    }
+    if (args.size() == 1 && args[0] == "--verify-polyline")
+    {
+        return VerifyPolyline();
+    }
+    if (args.size() == 1 && args[0] == "--verify-batch")
+    {
+        return VerifyBatch();
+    }
+    if (args.size() == 1 && args[0] == "--verify-layers")
+    {
+        return VerifyLayers();
+    }
+    if (args.size() == 1 && args[0] == "--verify-calipers")
+    {
+        return VerifyCalipers();
+    }
+    if (args.size() == 1 && args[0] == "--verify-lod")
+    {
+        return VerifyLod();
+    }
+    if (!args.empty() && args[0] == "--drag-sim")
+    {
+        return DragSim(vector<string>(args.begin() + 1, args.end()));
+    }
+    if (!args.empty() && args[0] == "--anytime")
+    {
+        return Anytime(vector<string>(args.begin() + 1, args.end()));
+    }
+    if (!args.empty() && args[0] == "--eps-kernel")
+    {
+        return EpsKernelRun(vector<string>(args.begin() + 1, args.end()));
+    }
+    if (!args.empty() && args[0] == "--stream-hull")
+    {
+        return StreamHull(vector<string>(args.begin() + 1, args.end()));
+    }
+    if (!args.empty() && args[0] == "--window-hull")
+    {
+        return WindowHull(vector<string>(args.begin() + 1, args.end()));
+    }
+    if (!args.empty() && args[0] == "--polyline-hull")
+    {
+        return PolylineHull(vector<string>(args.begin() + 1, args.end()));
+    }
+    if (!args.empty() && args[0] == "--simplify")
+    {
+        return Simplify(vector<string>(args.begin() + 1, args.end()));
+    }
+
+    string tracePath;
+    auto trace = find(args.begin(), args.end(), "--trace");
+    if (trace != args.end())
+    {
+        if (trace + 1 == args.end())
+        {
+            return Usage();
+        }
+        tracePath = *(trace + 1);
+        args.erase(trace, trace + 2);
+    }
+
+    auto batch = find(args.begin(), args.end(), "--batch");
+    if (args.empty() || (batch != args.end() && batch + 1 == args.end()))
+    {
+        return Usage();
+    }
+
+    JobRunner runner;
+    if (batch == args.end())
+    {
+        Job job;
+        string error;
+        if (!ParseJob(args, job, error))
+        {
+            fprintf(stderr, "hullcli: %s\n", error.c_str());
+            return Usage();
+        }
+        return Finish(tracePath, runner.Run(job) ? 0 : 1);
+    }
+
+    //the remaining arguments are defaults for every job in the batch
+    const string jobPath = *(batch + 1);
+    args.erase(batch, batch + 2);
+    Job defaults;
+    for (size_t i = 0; i < args.size(); i++)
+    {
+        if (args[i] == "--quiet")
+        {
+            defaults.quiet = true;
+        }
+        else if (args[i] == "--repeat" && i + 1 < args.size())
+        {
+            defaults.repeat = (unsigned)max(1, atoi(args[++i].c_str()));
+        }
+        else
+        {
+            fprintf(stderr, "hullcli: %s does not apply to a batch\n", args[i].c_str());
+            return Usage();
+        }
+    }
+
+    ifstream jobFile;
+    if (jobPath != "-")
+    {
+        jobFile.open(jobPath);
+        if (!jobFile)
+        {
+            fprintf(stderr, "hullcli: cannot read %s\n", jobPath.c_str());
+            return 1;
+        }
+    }
+    istream& jobs = jobPath == "-" ? cin : jobFile;
+
+    const auto start = Clock::now();
+    size_t failed = 0;
+    size_t total = 0;
+    string line;
+    for (size_t lineNumber = 1; getline(jobs, line); lineNumber++)
+    {
+        const vector<string> tokens = SplitTokens(line);
+        if (tokens.empty() || tokens[0][0] == '#')
+        {
+            continue;
+        }
+        total++;
+        Job job = defaults;
+        string error;
+        if (!ParseJob(tokens, job, error))
+        {
+            printf("line %zu: %s\n", lineNumber, error.c_str());
+            failed++;
+        }
+        else if (!runner.Run(job))
+        {
+            failed++;
+        }
+        fflush(stdout);
+    }
+    printf("%zu jobs, %zu failed, %.3f ms\n", total, failed, Milliseconds(start));
+    return Finish(tracePath, failed ? 1 : 0);
+}
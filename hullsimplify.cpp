@@ -0,0 +1,336 @@
+#include "hullsimplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+namespace
+{
+    const double Infinity = numeric_limits<double>::infinity();
+
+    bool Less(const Point2D& a, const Point2D& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+
+    double SegmentDistance(const Point2D& p, const Point2D& a, const Point2D& b)
+    {
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double length2 = dx * dx + dy * dy;
+        double t = length2 > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / length2 : 0;
+        t = min(1.0, max(0.0, t));
+        return hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Simplifier
+
+      Summary:  One greedy run over a polygon. The kept vertices (for an
+                inner fit) or edges (for an outer one, edge i running
+                from vertex i to i + 1) form a circular list over the
+                input's indices, and a heap holds the cost of dropping
+                each, stale entries being told apart by a stamp. A drop
+                only changes the cost of its two neighbours.
+
+      Methods:  Remove
+                  Drops the cheapest vertex or edge if it costs no more
+                  than limit.
+                Vertices
+                  The polygon as it stands, in hull order.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+    class Simplifier
+    {
+    public:
+        Simplifier(const Point2D* hull, size_t count, HullFit fit);
+
+        bool   Remove(double limit);
+        void   Vertices(vector<Point2D>& vertices) const;
+        size_t Size() const { return kept; }
+        double Error() const { return error; }
+
+    private:
+        struct Entry
+        {
+            double   cost;
+            size_t   index;
+            unsigned stamp;
+
+            //the cheapest on top
+            bool operator<(const Entry& other) const { return cost > other.cost; }
+        };
+
+        double  Cost(size_t i) const;
+        Point2D Corner(size_t a, size_t b) const;
+        void    Push(size_t i);
+
+        const Point2D*          hull;
+        size_t                  count;
+        HullFit                 fit;
+        vector<size_t>          prev;
+        vector<size_t>          next;
+        vector<unsigned>        stamp;
+        vector<bool>            removed;
+        priority_queue<Entry>   queue;
+        size_t                  kept;
+        double                  error;
+    };
+
+    Simplifier::Simplifier(const Point2D* points, size_t n, HullFit how) : hull(points), count(n), fit(how),
+        prev(n), next(n), stamp(n, 0), removed(n, false), kept(n), error(0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            prev[i] = (i + count - 1) % count;
+            next[i] = (i + 1) % count;
+        }
+        //heapified in one go rather than pushed one by one
+        vector<Entry> entries(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            entries[i] = Entry{ Cost(i), i, 0 };
+        }
+        queue = priority_queue<Entry>(less<Entry>(), move(entries));
+    }
+
+    //where the lines of edges a and b meet; they turn by less than 180 degrees
+    Point2D Simplifier::Corner(size_t a, size_t b) const
+    {
+        if (b == (a + 1) % count)
+        {
+            return hull[b];
+        }
+        const Point2D& p = hull[a];
+        const Point2D& q = hull[b];
+        const double ax = hull[(a + 1) % count].x - p.x;
+        const double ay = hull[(a + 1) % count].y - p.y;
+        const double bx = hull[(b + 1) % count].x - q.x;
+        const double by = hull[(b + 1) % count].y - q.y;
+        const double s = ((q.x - p.x) * by - (q.y - p.y) * bx) / (ax * by - ay * bx);
+        return Point2D{ p.x + s * ax, p.y + s * ay };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Simplifier::Cost
+
+      Summary:  The Hausdorff distance from the input of the region a
+                drop would add or cut off. Inner: the input vertices
+                between the neighbours of vertex i, measured to the
+                chord joining them. Outer: the corner where the lines of
+                the neighbours of edge i meet, measured to the input
+                edges between them; infinite if the lines do not meet
+                ahead of edge i.
+
+      Args:     size_t i
+                  a kept vertex or edge
+
+      Returns:  double
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    double Simplifier::Cost(size_t i) const
+    {
+        const size_t a = prev[i];
+        const size_t b = next[i];
+        double cost = 0;
+        if (fit == HullFit::Inner)
+        {
+            for (size_t k = (a + 1) % count; k != b; k = (k + 1) % count)
+            {
+                cost = max(cost, SegmentDistance(hull[k], hull[a], hull[b]));
+            }
+            return cost;
+        }
+
+        const Point2D& p = hull[a];
+        const Point2D& q = hull[b];
+        const Point2D& pEnd = hull[(a + 1) % count];
+        const Point2D& qEnd = hull[(b + 1) % count];
+        if ((pEnd.x - p.x) * (qEnd.y - q.y) - (pEnd.y - p.y) * (qEnd.x - q.x) <= 0)
+        {
+            return Infinity;
+        }
+        const Point2D corner = Corner(a, b);
+        cost = Infinity;
+        for (size_t k = a; k != b; k = (k + 1) % count)
+        {
+            cost = min(cost, SegmentDistance(corner, hull[k], hull[(k + 1) % count]));
+        }
+        //lines this close to parallel meet far out, or in rounding noise
+        return isfinite(cost) ? cost : Infinity;
+    }
+
+    void Simplifier::Push(size_t i)
+    {
+        queue.push(Entry{ Cost(i), i, ++stamp[i] });
+    }
+
+    bool Simplifier::Remove(double limit)
+    {
+        while (!queue.empty() && (removed[queue.top().index] || queue.top().stamp != stamp[queue.top().index]))
+        {
+            queue.pop();
+        }
+        if (kept <= 3 || queue.empty() || queue.top().cost > limit || queue.top().cost == Infinity)
+        {
+            return false;
+        }
+        const Entry top = queue.top();
+        queue.pop();
+        const size_t a = prev[top.index];
+        const size_t b = next[top.index];
+        removed[top.index] = true;
+        next[a] = b;
+        prev[b] = a;
+        kept--;
+        error = max(error, top.cost);
+        Push(a);
+        Push(b);
+        return true;
+    }
+
+    void Simplifier::Vertices(vector<Point2D>& vertices) const
+    {
+        vertices.clear();
+        size_t start = 0;
+        while (removed[start])
+        {
+            start++;
+        }
+        size_t i = start;
+        do
+        {
+            vertices.push_back(fit == HullFit::Inner ? hull[i] : Corner(i, next[i]));
+            i = next[i];
+        } while (i != start);
+        rotate(vertices.begin(), min_element(vertices.begin(), vertices.end(), Less), vertices.end());
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: SimplifyHull
+
+    Summary:  Drops the cheapest vertex (Inner) or edge (Outer) until
+              maxVertices are left or none can go.
+
+    Args:     const Point2D* hull, size_t count
+                a convex polygon in hull order
+              size_t maxVertices
+                the most to keep, at least 3
+              HullFit fit
+                inside or around the polygon
+              vector<Point2D>& simplified
+                receives the result, in hull order
+
+    Returns:  double
+                its Hausdorff distance from the polygon
+-----------------------------------------------------------------F-F*/
+double SimplifyHull(const Point2D* hull, size_t count, size_t maxVertices, HullFit fit, vector<Point2D>& simplified)
+{
+    HULL_SCOPE("SimplifyHull");
+    if (count <= max<size_t>(maxVertices, 3))
+    {
+        simplified.assign(hull, hull + count);
+        return 0;
+    }
+    Simplifier simplifier(hull, count, fit);
+    while (simplifier.Size() > maxVertices && simplifier.Remove(Infinity))
+    {
+    }
+    simplifier.Vertices(simplified);
+    return simplifier.Error();
+}
+
+double SimplifyHullWithin(const Point2D* hull, size_t count, double tolerance, HullFit fit, vector<Point2D>& simplified)
+{
+    HULL_SCOPE("SimplifyHullWithin");
+    if (count <= 3)
+    {
+        simplified.assign(hull, hull + count);
+        return 0;
+    }
+    Simplifier simplifier(hull, count, fit);
+    while (simplifier.Remove(tolerance))
+    {
+    }
+    simplifier.Vertices(simplified);
+    return simplifier.Error();
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: BuildHullLod
+
+    Summary:  Runs one greedy simplification down to coarsest vertices,
+              keeping the polygon each time the count halves, so every
+              level is nested in the next.
+
+    Args:     const Point2D* hull, size_t count
+                a convex polygon in hull order
+              HullFit fit
+                Outer for chains GjkIntersectLod can use
+              vector<HullLevel>& levels
+                receives the chain, coarse to fine, ending with the
+                polygon itself
+              size_t coarsest
+                no level has fewer vertices, at least 3
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+void BuildHullLod(const Point2D* hull, size_t count, HullFit fit, vector<HullLevel>& levels, size_t coarsest)
+{
+    HULL_SCOPE("BuildHullLod");
+    coarsest = max<size_t>(coarsest, 3);
+    levels.clear();
+    levels.push_back(HullLevel{ vector<Point2D>(hull, hull + count), 0 });
+    if (count > 3)
+    {
+        Simplifier simplifier(hull, count, fit);
+        for (size_t target = count / 2; target >= coarsest; target /= 2)
+        {
+            while (simplifier.Size() > target && simplifier.Remove(Infinity))
+            {
+            }
+            //an outer fit that can drop nothing more
+            if (simplifier.Size() >= levels.back().vertices.size())
+            {
+                break;
+            }
+            HullLevel level;
+            simplifier.Vertices(level.vertices);
+            level.error = simplifier.Error();
+            levels.push_back(move(level));
+        }
+    }
+    reverse(levels.begin(), levels.end());
+}
+
+bool GjkIntersectLod(const vector<HullLevel>& a, const vector<HullLevel>& b, size_t* levels)
+{
+    HULL_SCOPE("GjkIntersectLod");
+    if (levels)
+    {
+        *levels = 0;
+    }
+    if (a.empty() || b.empty())
+    {
+        return false;
+    }
+    //the shorter chain waits at its coarsest level, so both reach their polygons together
+    const size_t depth = max(a.size(), b.size());
+    for (size_t i = 0; i < depth; i++)
+    {
+        const HullLevel& levelA = a[i + a.size() < depth ? 0 : i + a.size() - depth];
+        const HullLevel& levelB = b[i + b.size() < depth ? 0 : i + b.size() - depth];
+        if (levels)
+        {
+            (*levels)++;
+        }
+        if (!GjkIntersect(levelA.vertices.data(), levelA.vertices.size(), levelB.vertices.data(), levelB.vertices.size()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
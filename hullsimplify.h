@@ -0,0 +1,67 @@
+#ifndef _HULLSIMPLIFY_H
+#define _HULLSIMPLIFY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Fewer-vertex stand-ins for a convex polygon, for Minkowski sums
+    (n·m) and support queries on hulls far finer than the collision
+    tolerance. The input is a polygon in hull order, as HullVertices
+    gives it, and so is every result: convex, counter-clockwise from
+    the left most vertex.
+
+    An Inner fit keeps a subset of the vertices, so it lies inside the
+    polygon; an Outer fit keeps a subset of the edge lines, extending
+    the neighbours of each dropped edge to meet, so it contains the
+    polygon and is safe for conservative tests. Both are greedy: the
+    vertex (or edge) whose removal costs least goes first, the cost
+    being the Hausdorff distance from the input that results, measured
+    against the input itself rather than the last step so errors do
+    not pile up unseen. The error returned is that distance (for an
+    inner fit, an upper bound: each cut off vertex is measured to the
+    chord that replaced it).
+
+    An outer fit cannot drop an edge whose neighbours turn by 180
+    degrees or more, since their lines do not meet ahead of it, so it
+    stops above maxVertices on shapes such as a rectangle.
+--------------------------------------------------------------------*/
+
+enum class HullFit
+{
+    Inner,
+    Outer
+};
+
+//at most maxVertices (at least 3) vertices, or as few as the fit allows; returns the error
+double SimplifyHull(const Point2D* hull, size_t count, size_t maxVertices, HullFit fit,
+    std::vector<Point2D>& simplified);
+
+//as few vertices as the greedy order reaches while the error stays within tolerance; returns the error
+double SimplifyHullWithin(const Point2D* hull, size_t count, double tolerance, HullFit fit,
+    std::vector<Point2D>& simplified);
+
+/*--------------------------------------------------------------------
+    Level of detail chain: the simplifications one greedy run passes
+    through at half, a quarter, ... of the vertices, down to coarsest,
+    ordered coarse to fine and ending with the polygon itself (error
+    0). Each level is nested in the next: an outer level contains every
+    finer one, an inner level is contained by it.
+--------------------------------------------------------------------*/
+
+struct HullLevel
+{
+    std::vector<Point2D>    vertices;
+    double                  error;
+};
+
+void BuildHullLod(const Point2D* hull, size_t count, HullFit fit, std::vector<HullLevel>& levels,
+    size_t coarsest = 8);
+
+//GjkIntersect on outer chains, coarse to fine: separated at any level means separated, so most
+//disjoint pairs are settled on a few vertices and only touching ones reach the exact hulls
+bool GjkIntersectLod(const std::vector<HullLevel>& a, const std::vector<HullLevel>& b, size_t* levels = nullptr);
+
+#endif
@@ -0,0 +1,213 @@
+#include "hullworker.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+    bool SamePoints(const vector<Point2D>& a, const vector<Point2D>& b)
+    {
+        return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(),
+            [](const Point2D& p, const Point2D& q) { return p.x == q.x && p.y == q.y; });
+    }
+
+    void Translate(vector<Point2D>& points, double dx, double dy)
+    {
+        for (Point2D& p : points)
+        {
+            p.x += dx;
+            p.y += dy;
+        }
+    }
+}
+
+HullWorker::HullWorker(Notify notify, chrono::milliseconds maxLag)
+    : notify(move(notify)), maxLag(maxLag), cancel(false), runner(&HullWorker::Run, this)
+{
+}
+
+HullWorker::~HullWorker()
+{
+    {
+        lock_guard<mutex> lock(guard);
+        stopping = true;
+        cancel.store(true, memory_order_relaxed);
+    }
+    wake.notify_all();
+    runner.join();
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   HullWorker::Submit
+
+  Summary:  Queues a request, dropping the one still waiting if there
+            is one, and cancels the request being computed unless the
+            newest published result is already maxLag old.
+
+  Args:     HullRequest request
+              snapshot of the inputs, moved into the queue
+
+  Modifies: [pending, stats, cancel].
+
+  Returns:  uint64_t
+              sequence number of the request, as its result will carry
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+uint64_t HullWorker::Submit(HullRequest request)
+{
+    lock_guard<mutex> lock(guard);
+    const Clock::time_point now = Clock::now();
+    if (pending)
+    {
+        stats.dropped++;
+    }
+    pending.reset(new HullRequest(move(request)));
+    pendingSequence = ++stats.submitted;
+    pendingSubmitted = now;
+    if (busy && latest && now - latest->submitted < maxLag)
+    {
+        cancel.store(true, memory_order_relaxed);
+    }
+    wake.notify_one();
+    return pendingSequence;
+}
+
+shared_ptr<const HullResult> HullWorker::Latest() const
+{
+    lock_guard<mutex> lock(guard);
+    return latest;
+}
+
+void HullWorker::WaitIdle()
+{
+    unique_lock<mutex> lock(guard);
+    idle.wait(lock, [&] { return !busy && !pending; });
+}
+
+HullWorkerStats HullWorker::Stats() const
+{
+    lock_guard<mutex> lock(guard);
+    return stats;
+}
+
+void HullWorker::Run()
+{
+    unique_lock<mutex> lock(guard);
+    for (;;)
+    {
+        wake.wait(lock, [&] { return stopping || pending; });
+        if (stopping)
+        {
+            return;
+        }
+        const unique_ptr<HullRequest> request = move(pending);
+        const shared_ptr<HullResult> result = make_shared<HullResult>();
+        result->sequence = pendingSequence;
+        result->operation = request->operation;
+        result->submitted = pendingSubmitted;
+        busy = true;
+        cancel.store(false, memory_order_relaxed);
+
+        lock.unlock();
+        const bool done = Compute(*request, *result);
+        result->finished = Clock::now();
+        lock.lock();
+
+        if (done)
+        {
+            latest = result;
+            stats.published++;
+            if (notify)
+            {
+                lock.unlock();
+                notify(result->sequence);
+                lock.lock();
+            }
+        }
+        else
+        {
+            stats.cancelled++;
+        }
+        busy = false;
+        if (!pending)
+        {
+            idle.notify_all();
+        }
+    }
+}
+
+//the hull of points, from the cache when the points are those of the last call
+bool HullWorker::HullOf(const vector<Point2D>& points, CachedHull& cache, vector<Point2D>& hull)
+{
+    if (cache.valid && SamePoints(cache.points, points))
+    {
+        hull = cache.hull;
+        return true;
+    }
+    cache.valid = false;
+    if (!QuickHull(points.data(), points.size(), index, scratch, cancel))
+    {
+        return false;
+    }
+    HullVertices(points.data(), index, hull);
+    cache.points = points;
+    cache.hull = hull;
+    cache.valid = true;
+    return true;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   HullWorker::Compute
+
+  Summary:  Runs one request on the worker thread. The hulls check the
+            cancel flag as they go, and the flag is checked again
+            between stages.
+
+  Args:     const HullRequest& request
+              the inputs
+            HullResult& result
+              receives the hulls and the query answer
+
+  Modifies: [cacheFirst, cacheSecond, index, scratch, result].
+
+  Returns:  bool
+              false if cancelled part way
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool HullWorker::Compute(const HullRequest& request, HullResult& result)
+{
+    HULL_SCOPE("HullWorker::Compute");
+    switch (request.operation)
+    {
+    case HullOperation::Hull:
+        return HullOf(request.first, cacheFirst, result.hull);
+
+    case HullOperation::PointInHull:
+        if (!HullOf(request.second, cacheSecond, result.hull2))
+        {
+            return false;
+        }
+        result.inside = !request.first.empty() && PointInConvexHull(request.first[0], result.hull2.data(), result.hull2.size());
+        return true;
+
+    case HullOperation::MinkowskiSum:
+    case HullOperation::MinkowskiDifference:
+        if (!HullOf(request.first, cacheFirst, result.hull) || !HullOf(request.second, cacheSecond, result.hull2)
+            || cancel.load(memory_order_relaxed))
+        {
+            return false;
+        }
+        if (request.operation == HullOperation::MinkowskiSum)
+        {
+            MinkowskiSum(result.hull.data(), result.hull.size(), result.hull2.data(), result.hull2.size(), result.combined, scratch);
+            Translate(result.combined, -request.origin.x, -request.origin.y);
+        }
+        else
+        {
+            MinkowskiDifference(result.hull.data(), result.hull.size(), result.hull2.data(), result.hull2.size(), result.combined, scratch);
+            Translate(result.combined, request.origin.x, request.origin.y);
+            result.inside = PointInConvexHull(request.origin, result.combined.data(), result.combined.size());
+        }
+        return true;
+    }
+    return false;
+}
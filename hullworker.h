@@ -0,0 +1,144 @@
+#ifndef _HULLWORKER_H
+#define _HULLWORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Background hull computation for interactive use, such as a drag
+    that sends a new point set with every mouse move.
+
+    Submit hands the worker a snapshot of the inputs and returns at
+    once. Requests are latest-wins: a request still waiting when a
+    newer one arrives is dropped unseen, and the one being computed is
+    cancelled through a flag that QuickHull checks between subproblems.
+    Cancelling is held back while the last published result is more
+    than maxLag behind, so a drag faster than the computation still
+    shows a result every so often instead of none at all.
+
+    Finished results are published in submission order: Latest()
+    returns the newest one, and the notify callback (called on the
+    worker thread, so it should only post a message or set a flag)
+    tells the owner there is one. The worker remembers the last hull of
+    each input and skips recomputing it when the next snapshot holds
+    the same points, so dragging one set only rehulls that set.
+--------------------------------------------------------------------*/
+
+enum class HullOperation
+{
+    Hull,                   // hull of first
+    MinkowskiSum,           // hulls of both and their sum
+    MinkowskiDifference,    // hulls of both, their difference, and whether it holds origin
+    PointInHull             // hull of second, and whether first[0] lies in it
+};
+
+struct HullRequest
+{
+    HullOperation        operation = HullOperation::Hull;
+    std::vector<Point2D> first;
+    std::vector<Point2D> second;
+    Point2D              origin = {};   // sums are moved by -origin and differences by +origin
+};
+
+struct HullResult
+{
+    typedef std::chrono::steady_clock Clock;
+
+    uint64_t             sequence = 0;
+    HullOperation        operation = HullOperation::Hull;
+    std::vector<Point2D> hull;          // of first
+    std::vector<Point2D> hull2;         // of second
+    std::vector<Point2D> combined;      // the Minkowski sum or difference
+    bool                 inside = false;
+    Clock::time_point    submitted;
+    Clock::time_point    finished;
+};
+
+struct HullWorkerStats
+{
+    uint64_t submitted = 0;
+    uint64_t published = 0;
+    uint64_t dropped = 0;       // replaced while waiting
+    uint64_t cancelled = 0;     // replaced while being computed
+};
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    HullWorker
+
+  Summary:  One background thread computing HullRequests, latest-wins.
+
+  Methods:  Submit
+              queues a request, replacing any that has not started
+            Latest
+              the newest published result, or null
+            WaitIdle
+              blocks until every submitted request is published or
+              dropped
+            Stats
+              counts of submitted, published, dropped and cancelled
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class HullWorker
+{
+public:
+    typedef HullResult::Clock                    Clock;
+    typedef std::function<void(uint64_t)>        Notify;
+
+    explicit HullWorker(Notify notify = Notify(), std::chrono::milliseconds maxLag = std::chrono::milliseconds(100));
+    ~HullWorker();
+
+    HullWorker(const HullWorker&) = delete;
+    HullWorker& operator=(const HullWorker&) = delete;
+
+    uint64_t                          Submit(HullRequest request);
+    std::shared_ptr<const HullResult> Latest() const;
+    void                              WaitIdle();
+    HullWorkerStats                   Stats() const;
+
+private:
+    //a remembered input and its hull vertices
+    struct CachedHull
+    {
+        std::vector<Point2D> points;
+        std::vector<Point2D> hull;
+        bool                 valid = false;
+    };
+
+    void Run();
+    bool Compute(const HullRequest& request, HullResult& result);
+    bool HullOf(const std::vector<Point2D>& points, CachedHull& cache, std::vector<Point2D>& hull);
+
+    const Notify                      notify;
+    const Clock::duration             maxLag;
+
+    mutable std::mutex                guard;
+    std::condition_variable           wake;
+    std::condition_variable           idle;
+    std::unique_ptr<HullRequest>      pending;
+    uint64_t                          pendingSequence = 0;
+    Clock::time_point                 pendingSubmitted;
+    bool                              busy = false;
+    bool                              stopping = false;
+    std::shared_ptr<const HullResult> latest;
+    HullWorkerStats                   stats;
+    std::atomic<bool>                 cancel;
+
+    //used by the worker thread only
+    CachedHull                        cacheFirst;
+    CachedHull                        cacheSecond;
+    std::vector<uint32_t>             index;
+    Arena                             scratch;
+
+    std::thread                       runner;      // last, so it starts after everything it uses
+};
+
+#endif
@@ -0,0 +1,298 @@
+#include "instrument.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    const char* const CounterNames[] =
+    {
+        "OrientationTests",
+        "QuickHullTasks",
+        "QuickHullMaxStack",
+        "IsRightTests",
+        "FindHullCalls",
+        "FindHullMaxDepth",
+        "MinkowskiPoints",
+        "PointInHullQueries",
+        "ArenaAllocations",
+        "ArenaBytes",
+        "ArenaBlocks",
+        "PipelineStagesRun",
+        "PipelineStagesSkipped"
+    };
+
+    static_assert(sizeof(CounterNames) / sizeof(CounterNames[0]) == (size_t)HullCounter::Count, "one name per HullCounter");
+}
+
+#ifdef HULL_INSTRUMENT
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        uint64_t    start;
+        uint64_t    end;
+    };
+
+    struct ThreadData
+    {
+        Instrument::CounterBlock counters;
+        mutex                    eventLock;
+        vector<TraceEvent>       events;
+        uint64_t                 dropped = 0;
+        unsigned                 id = 0;
+    };
+
+    //thread blocks are never freed, so counts from finished threads stay in the totals
+    mutex                          registryLock;
+    vector<unique_ptr<ThreadData>> registry;
+    thread_local ThreadData*       threadData = nullptr;
+
+    const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+    //counters merged across threads by maximum instead of sum
+    bool IsMaxCounter(unsigned counter)
+    {
+        return counter == (unsigned)HullCounter::QuickHullMaxStack || counter == (unsigned)HullCounter::FindHullMaxDepth;
+    }
+
+    ThreadData& LocalData()
+    {
+        if (!threadData)
+        {
+            Instrument::RegisterThread();
+        }
+        return *threadData;
+    }
+
+    string Escape(const char* text)
+    {
+        string escaped;
+        for (const char* c = text; *c; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                escaped += '\\';
+            }
+            escaped += *c;
+        }
+        return escaped;
+    }
+
+    void Totals(uint64_t (&totals)[(unsigned)HullCounter::Count])
+    {
+        fill(begin(totals), end(totals), 0);
+        for (auto const& data : registry)
+        {
+            for (unsigned c = 0; c < (unsigned)HullCounter::Count; c++)
+            {
+                const uint64_t v = data->counters.values[c].load(memory_order_relaxed);
+                totals[c] = IsMaxCounter(c) ? max(totals[c], v) : totals[c] + v;
+            }
+        }
+    }
+}
+
+thread_local Instrument::CounterBlock* Instrument::threadCounters = nullptr;
+
+Instrument::CounterBlock* Instrument::RegisterThread()
+{
+    unique_ptr<ThreadData> data(new ThreadData());
+    for (auto& v : data->counters.values)
+    {
+        v.store(0, memory_order_relaxed);
+    }
+    lock_guard<mutex> lock(registryLock);
+    data->id = (unsigned)registry.size() + 1;
+    threadData = data.get();
+    threadCounters = &data->counters;
+    registry.push_back(move(data));
+    return threadCounters;
+}
+
+uint64_t Instrument::Now()
+{
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+void Instrument::Record(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadData& data = LocalData();
+    lock_guard<mutex> lock(data.eventLock);
+    if (data.events.size() < TraceEventLimit)
+    {
+        data.events.push_back(TraceEvent{ name, start, end });
+    }
+    else
+    {
+        data.dropped++;
+    }
+}
+
+bool Instrument::Enabled()
+{
+    return true;
+}
+
+void Instrument::Reset()
+{
+    lock_guard<mutex> lock(registryLock);
+    for (auto const& data : registry)
+    {
+        for (auto& v : data->counters.values)
+        {
+            v.store(0, memory_order_relaxed);
+        }
+        lock_guard<mutex> eventLock(data->eventLock);
+        data->events.clear();
+        data->dropped = 0;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Instrument::WriteChromeTrace
+
+    Summary:  Writes every recorded scope as a complete ("X") event on
+              its thread's track, followed by one counter ("C") event
+              with the counter totals, in the trace event JSON format
+              read by chrome://tracing and Perfetto.
+
+    Args:     const string& path
+                file to write
+
+    Returns:  bool
+                false if the file cannot be written
+-----------------------------------------------------------------F-F*/
+bool Instrument::WriteChromeTrace(const string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    lock_guard<mutex> lock(registryLock);
+    fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    uint64_t last = 0;
+    for (auto const& data : registry)
+    {
+        lock_guard<mutex> eventLock(data->eventLock);
+        fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"thread %u\"}},\n", data->id, data->id);
+        for (const TraceEvent& e : data->events)
+        {
+            fprintf(file, "{\"name\": \"%s\", \"cat\": \"hull\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f},\n",
+                Escape(e.name).c_str(), data->id, e.start / 1000.0, (e.end - e.start) / 1000.0);
+            last = max(last, e.end);
+        }
+    }
+
+    uint64_t totals[(unsigned)HullCounter::Count];
+    Totals(totals);
+    fprintf(file, "{\"name\": \"counters\", \"ph\": \"C\", \"pid\": 1, \"tid\": 0, \"ts\": %.3f, \"args\": {", last / 1000.0);
+    for (unsigned c = 0; c < (unsigned)HullCounter::Count; c++)
+    {
+        fprintf(file, "%s\"%s\": %llu", c ? ", " : "", CounterNames[c], (unsigned long long)totals[c]);
+    }
+    fprintf(file, "}}\n]}\n");
+    return fclose(file) == 0;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Instrument::SummaryTable
+
+    Summary:  Counter totals (maximum for the depth counters) and, per
+              scope name, call count, total, mean and max time.
+
+    Returns:  string
+                the table, one line per row
+-----------------------------------------------------------------F-F*/
+string Instrument::SummaryTable()
+{
+    struct ScopeStats
+    {
+        uint64_t calls = 0;
+        uint64_t total = 0;
+        uint64_t longest = 0;
+    };
+
+    lock_guard<mutex> lock(registryLock);
+    map<string, ScopeStats> scopes;
+    uint64_t dropped = 0;
+    for (auto const& data : registry)
+    {
+        lock_guard<mutex> eventLock(data->eventLock);
+        for (const TraceEvent& e : data->events)
+        {
+            ScopeStats& s = scopes[e.name];
+            s.calls++;
+            s.total += e.end - e.start;
+            s.longest = max(s.longest, e.end - e.start);
+        }
+        dropped += data->dropped;
+    }
+
+    uint64_t totals[(unsigned)HullCounter::Count];
+    Totals(totals);
+
+    ostringstream out;
+    char line[256];
+    snprintf(line, sizeof(line), "%-32s %16s\n", "counter", "value");
+    out << line;
+    for (unsigned c = 0; c < (unsigned)HullCounter::Count; c++)
+    {
+        snprintf(line, sizeof(line), "%-32s %16llu\n", CounterNames[c], (unsigned long long)totals[c]);
+        out << line;
+    }
+    snprintf(line, sizeof(line), "\n%-32s %10s %12s %12s %12s\n", "scope", "calls", "total ms", "mean us", "max us");
+    out << line;
+    for (auto const& s : scopes)
+    {
+        snprintf(line, sizeof(line), "%-32s %10llu %12.3f %12.3f %12.3f\n", s.first.c_str(), (unsigned long long)s.second.calls,
+            s.second.total / 1e6, s.second.total / 1e3 / s.second.calls, s.second.longest / 1e3);
+        out << line;
+    }
+    if (dropped)
+    {
+        out << dropped << " scope events dropped past the per thread limit\n";
+    }
+    return out.str();
+}
+
+#else
+
+bool Instrument::Enabled()
+{
+    return false;
+}
+
+void Instrument::Reset()
+{
+}
+
+bool Instrument::WriteChromeTrace(const string& path)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+    fprintf(file, "{\"traceEvents\": []}\n");
+    return fclose(file) == 0;
+}
+
+string Instrument::SummaryTable()
+{
+    return "instrumentation is compiled out, build with HULL_INSTRUMENT defined\n";
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef _INSTRUMENT_H
+#define _INSTRUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef HULL_INSTRUMENT
+#include <atomic>
+#endif
+
+/*--------------------------------------------------------------------
+    Hot path instrumentation, compiled in only when HULL_INSTRUMENT is
+    defined. Without it every macro below expands to nothing and the
+    instrumented code is exactly the uninstrumented code.
+
+    HULL_COUNT(counter, n)  adds n to a counter
+    HULL_MAX(counter, v)    raises a counter to at least v
+    HULL_SCOPE("name")      times the enclosing scope as a trace event
+    HULL_RECURSION(c, d)    counts a recursive call in c, its depth in d
+
+    Counters live in a per thread block and are bumped inline with
+    relaxed loads and stores (plain moves on x86), so they are cheap
+    enough for per call use such as every orientation test. Scopes
+    read the clock twice and append one event, so they belong on
+    stages, not inner loops. Each thread keeps at most TraceEventLimit
+    events and counts the rest as dropped; the counters stay complete.
+    Reset() is meant for idle points between runs.
+
+    WriteChromeTrace() writes chrome://tracing / Perfetto JSON and
+    SummaryTable() a plain text table. Both work (and report nothing)
+    when instrumentation is compiled out.
+--------------------------------------------------------------------*/
+
+enum class HullCounter : unsigned
+{
+    OrientationTests,       // Orientation() calls in the headless kernel
+    QuickHullTasks,         // subproblems the headless QuickHull processed
+    QuickHullMaxStack,      // deepest task stack of the headless QuickHull
+    IsRightTests,           // MainWindow::IsRight calls
+    FindHullCalls,          // MainWindow FindHull recursions
+    FindHullMaxDepth,       // deepest FindHull recursion
+    MinkowskiPoints,        // points produced by Minkowski sums and differences
+    PointInHullQueries,     // point in convex hull tests
+    ArenaAllocations,       // allocations served by an Arena
+    ArenaBytes,             // bytes served by an Arena
+    ArenaBlocks,            // blocks an Arena had to take from the heap
+    PipelineStagesRun,      // DirtyGraph stages found stale and recomputed
+    PipelineStagesSkipped,  // DirtyGraph stages found clean and reused
+    Count
+};
+
+namespace Instrument
+{
+    const size_t TraceEventLimit = 1 << 20;
+
+    bool        Enabled();
+    void        Reset();
+    bool        WriteChromeTrace(const std::string& path);
+    std::string SummaryTable();
+
+#ifdef HULL_INSTRUMENT
+    struct CounterBlock
+    {
+        std::atomic<uint64_t> values[(unsigned)HullCounter::Count];
+    };
+
+    //this thread's counters, null until the thread first counts something
+    extern thread_local CounterBlock* threadCounters;
+    CounterBlock* RegisterThread();
+
+    inline std::atomic<uint64_t>& Slot(HullCounter counter)
+    {
+        CounterBlock* block = threadCounters ? threadCounters : RegisterThread();
+        return block->values[(unsigned)counter];
+    }
+
+    //only the owning thread writes its block, so no read-modify-write is needed
+    inline void Add(HullCounter counter, uint64_t n)
+    {
+        std::atomic<uint64_t>& slot = Slot(counter);
+        slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    inline void Max(HullCounter counter, uint64_t value)
+    {
+        std::atomic<uint64_t>& slot = Slot(counter);
+        if (value > slot.load(std::memory_order_relaxed))
+        {
+            slot.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t Now();
+    void     Record(const char* name, uint64_t start, uint64_t end);
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const char* name) : name(name), start(Now()) { }
+        ~ScopedTimer() { Record(name, start, Now()); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        const char* name;
+        uint64_t    start;
+    };
+
+    //counts a call of a recursive function and tracks how deep it went
+    class RecursionScope
+    {
+    public:
+        RecursionScope(uint64_t& depth, HullCounter calls, HullCounter maxDepth) : depth(depth)
+        {
+            Add(calls, 1);
+            Max(maxDepth, ++depth);
+        }
+        ~RecursionScope() { --depth; }
+
+        RecursionScope(const RecursionScope&) = delete;
+        RecursionScope& operator=(const RecursionScope&) = delete;
+
+    private:
+        uint64_t& depth;
+    };
+#endif
+}
+
+#ifdef HULL_INSTRUMENT
+#define HULL_CONCAT_(a, b) a##b
+#define HULL_CONCAT(a, b) HULL_CONCAT_(a, b)
+#define HULL_COUNT(counter, n) Instrument::Add(HullCounter::counter, (uint64_t)(n))
+#define HULL_MAX(counter, value) Instrument::Max(HullCounter::counter, (uint64_t)(value))
+#define HULL_SCOPE(name) Instrument::ScopedTimer HULL_CONCAT(hullScope, __LINE__)(name)
+#define HULL_RECURSION(calls, maxDepth) \
+    static thread_local uint64_t HULL_CONCAT(hullDepth, __LINE__) = 0; \
+    Instrument::RecursionScope HULL_CONCAT(hullRecursion, __LINE__)(HULL_CONCAT(hullDepth, __LINE__), HullCounter::calls, HullCounter::maxDepth)
+#else
+#define HULL_COUNT(counter, n) ((void)0)
+#define HULL_MAX(counter, value) ((void)0)
+#define HULL_SCOPE(name) ((void)0)
+#define HULL_RECURSION(calls, maxDepth) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,915 @@
+#include "kinetichull.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+    const double Never = numeric_limits<double>::infinity();
+
+    //how far a rounded failure time may be off; a certificate this close to
+    //failing is checked exactly rather than trusted to its root
+    double Slack(double time)
+    {
+        return 1e-9 * (1 + fabs(time));
+    }
+}
+
+KineticHull::KineticHull() : origin(0), now(0), anchor(None), hullSize(0), degenerate(true),
+    eventCount(0), recertifyCount(0), repairs(0), needRecertify(false)
+{
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Reset
+
+  Summary:  Loads a new point set and builds the initial certificates.
+
+  Args:     const vector<Point2D>& positions
+              positions at startTime
+            const vector<Point2D>& velocities
+              per point velocity, same size as positions
+            double startTime
+              time the positions are given at
+
+  Modifies: [every member].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::Reset(const vector<Point2D>& positions, const vector<Point2D>& velocities, double startTime)
+{
+    const size_t n = positions.size();
+    base = positions;
+    vel = velocities;
+    vel.resize(n, Point2D{ 0, 0 });
+    origin = now = startTime;
+
+    next.assign(n, None);
+    prev.assign(n, None);
+    onHull.assign(n, 0);
+    members.assign(n, vector<uint32_t>());
+    wedge.assign(n, None);
+    slot.assign(n, 0);
+    gen.assign(n, 0);
+    queue.clear();
+    eventCount = 0;
+    recertifyCount = 0;
+
+    Recertify();
+}
+
+Point2D KineticHull::PositionAt(uint32_t i, double tau) const
+{
+    return Point2D{ base[i].x + vel[i].x * tau, base[i].y + vel[i].y * tau };
+}
+
+Point2D KineticHull::Position(uint32_t i) const
+{
+    return PositionAt(i, now - origin);
+}
+
+//the three points of p's certificate of the given kind, in Cross order
+void KineticHull::Certificate(uint32_t p, CertKind kind, uint32_t& a, uint32_t& b, uint32_t& c) const
+{
+    switch (kind)
+    {
+    case Convexity:
+        a = prev[p], b = p, c = next[p];
+        break;
+    case WedgeLeft:
+        a = anchor, b = wedge[p], c = p;
+        break;
+    case WedgeEdge:
+        a = wedge[p], b = next[wedge[p]], c = p;
+        break;
+    case WedgeRight:
+        a = next[wedge[p]], b = anchor, c = p;
+        break;
+    }
+}
+
+//Cross(a, b, c) along the trajectories as c0 + c1 * tau + c2 * tau^2
+void KineticHull::Quadratic(uint32_t a, uint32_t b, uint32_t c, double& c0, double& c1, double& c2) const
+{
+    const double u0x = base[b].x - base[a].x, u0y = base[b].y - base[a].y;
+    const double u1x = vel[b].x - vel[a].x, u1y = vel[b].y - vel[a].y;
+    const double w0x = base[c].x - base[a].x, w0y = base[c].y - base[a].y;
+    const double w1x = vel[c].x - vel[a].x, w1y = vel[c].y - vel[a].y;
+
+    c0 = u0x * w0y - u0y * w0x;
+    c1 = u0x * w1y - u0y * w1x + u1x * w0y - u1y * w0x;
+    c2 = u1x * w1y - u1y * w1x;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Turn
+
+  Summary:  Orientation of a, b, c at the given time, exact on the
+            positions at that time, which is what every decision here
+            goes by. The positions are real points, so the answers
+            always fit together and a repair cannot undo itself.
+
+  Returns:  int
+              +1 if c is left of a->b, -1 if right, 0 if collinear
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+int KineticHull::Turn(uint32_t a, uint32_t b, uint32_t c, double time) const
+{
+    const double tau = time - origin;
+    return Orientation(PositionAt(a, tau), PositionAt(b, tau), PositionAt(c, tau));
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Broken
+
+  Summary:  Whether a certificate fails at the given time, by Turn. A
+            hull vertex must turn strictly left, so a collinear one
+            fails; an interior point may lie on its triangle's sides,
+            so only a point strictly outside fails.
+
+  Returns:  bool
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool KineticHull::Broken(uint32_t p, CertKind kind, double time) const
+{
+    uint32_t a, b, c;
+    Certificate(p, kind, a, b, c);
+    const int turn = Turn(a, b, c, time);
+    return kind == Convexity ? turn <= 0 : turn < 0;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::FailureTime
+
+  Summary:  Cross(a, b, c) along the trajectories is the quadratic
+            c0 + c1 * tau + c2 * tau^2. Finds the first time after from
+            at which it goes negative, or, for a strict certificate,
+            is zero. The sign at from is decided by Turn; the rounded
+            roots are only where to look next, and a root that
+            rounding puts just before from sends the certificate back
+            to Advance, which checks it exactly before acting on it.
+
+  Args:     uint32_t a, b, c
+              the points of the certificate
+            bool strict
+              zero fails too (convexity)
+            double from
+              time to look from, at least the current time
+
+  Returns:  double
+              failure time, from if the certificate is already broken
+              or about to be, infinity if it never fails
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+double KineticHull::FailureTime(uint32_t a, uint32_t b, uint32_t c, bool strict, double from) const
+{
+    double c0, c1, c2;
+    Quadratic(a, b, c, c0, c1, c2);
+
+    const double tau = from - origin;
+    const int turn = Turn(a, b, c, from);
+    if (turn < 0 || (turn == 0 && strict))
+    {
+        return from;
+    }
+    // Where the quadratic is negative follows from its roots, which
+    // are computed stably; evaluating it near a root would cancel. A
+    // time inside a negative stretch means rounding has the positions
+    // lag behind, so from is returned for Advance to check again.
+    if (c2 == 0)
+    {
+        if (c1 == 0)
+        {
+            return c0 < 0 ? from : Never;
+        }
+        const double root = -c0 / c1;
+        if (c1 < 0)
+        {
+            return origin + max(root, tau);
+        }
+        return tau < root || (strict && root > tau - Slack(tau)) ? from : Never;
+    }
+
+    const double disc = c1 * c1 - 4 * c2 * c0;
+    if (disc < 0)
+    {
+        return c2 < 0 ? from : Never;
+    }
+    if (disc == 0)
+    {
+        //touches zero at one instant: a collinear moment for a strict
+        //certificate, and if it opens downwards negative on either side
+        const double touch = -c1 / (2 * c2);
+        if (c2 < 0)
+        {
+            return origin + max(touch, tau);
+        }
+        return strict && touch >= tau ? origin + touch : Never;
+    }
+
+    const double q = -0.5 * (c1 + copysign(sqrt(disc), c1));
+    double r1 = q / c2;
+    double r2 = c0 / q;
+    if (r2 < r1)
+    {
+        swap(r1, r2);
+    }
+    if (c2 < 0)
+    {
+        //negative before r1 and after r2
+        return tau <= r1 ? from : origin + max(r2, tau);
+    }
+    //negative between r1 and r2; a strict certificate also fails at r2 itself
+    if (tau <= r1)
+    {
+        return origin + r1;
+    }
+    return tau < r2 || (strict && r2 > tau - Slack(tau)) ? from : Never;
+}
+
+double KineticHull::FailureTime(uint32_t p, CertKind kind, double from) const
+{
+    uint32_t a, b, c;
+    Certificate(p, kind, a, b, c);
+    return FailureTime(a, b, c, kind == Convexity, from);
+}
+
+void KineticHull::Push(double time, uint32_t p, CertKind kind)
+{
+    if (time == Never)
+    {
+        return;
+    }
+    queue.push_back(Event{ time, p, gen[p], kind });
+    push_heap(queue.begin(), queue.end());
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Schedule
+
+  Summary:  Invalidates every queued event of p and queues the failure
+            times of its current certificates.
+
+  Args:     uint32_t p
+              point whose certificates changed
+
+  Modifies: [gen, queue].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::Schedule(uint32_t p)
+{
+    if (degenerate)
+    {
+        return;
+    }
+    ++gen[p];
+    if (onHull[p])
+    {
+        Schedule(p, Convexity);
+    }
+    else if (wedge[p] != None)
+    {
+        Schedule(p, WedgeLeft);
+        Schedule(p, WedgeEdge);
+        Schedule(p, WedgeRight);
+    }
+}
+
+void KineticHull::Schedule(uint32_t p, CertKind kind)
+{
+    const double time = FailureTime(p, kind, now);
+    Push(time, p, kind);
+
+    // Three points that move along one line are collinear at every
+    // time, but their rounded positions may turn either way, so such
+    // a certificate has no failure time. It is looked at again
+    // wherever Advance stops.
+    uint32_t a, b, c;
+    double c0, c1, c2;
+    Certificate(p, kind, a, b, c);
+    Quadratic(a, b, c, c0, c1, c2);
+    if (time == Never && c0 == 0 && c1 == 0 && c2 == 0)
+    {
+        watch.push_back(Event{ now, p, gen[p], kind });
+    }
+}
+
+void KineticHull::ScheduleWedge(uint32_t w)
+{
+    const vector<uint32_t> wedgeMembers = members[w];
+    for (uint32_t q : wedgeMembers)
+    {
+        Schedule(q);
+    }
+}
+
+void KineticHull::CompactQueue()
+{
+    if (queue.size() + watch.size() <= 4 * base.size() + 64)
+    {
+        return;
+    }
+    const auto stale = [&](const Event& e) { return e.gen != gen[e.point]; };
+    queue.erase(remove_if(queue.begin(), queue.end(), stale), queue.end());
+    make_heap(queue.begin(), queue.end());
+    watch.erase(remove_if(watch.begin(), watch.end(), stale), watch.end());
+}
+
+void KineticHull::AddMember(uint32_t w, uint32_t p)
+{
+    wedge[p] = w;
+    slot[p] = (uint32_t)members[w].size();
+    members[w].push_back(p);
+}
+
+void KineticHull::RemoveMember(uint32_t p)
+{
+    const uint32_t w = wedge[p];
+    if (w == None)
+    {
+        return;
+    }
+    const uint32_t last = members[w].back();
+    members[w][slot[p]] = last;
+    slot[last] = slot[p];
+    members[w].pop_back();
+    wedge[p] = None;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Assign
+
+  Summary:  Places an interior point into the fan triangle containing
+            it, walking from a nearby wedge. If the point turns out to
+            be outside the hull it is inserted as a vertex instead.
+
+  Args:     uint32_t p
+              point without a wedge
+            uint32_t hint
+              wedge owner to start walking from
+
+  Modifies: [members, wedge, hull links].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::Assign(uint32_t p, uint32_t hint)
+{
+    if (needRecertify)
+    {
+        return;
+    }
+
+    uint32_t w = hint;
+    if (w == None || !onHull[w] || w == anchor || next[w] == anchor)
+    {
+        w = next[anchor];
+    }
+
+    for (size_t steps = 0; steps <= hullSize; steps++)
+    {
+        const uint32_t x = next[w];
+        if (Turn(anchor, w, p, now) < 0)
+        {
+            if (prev[w] == anchor)
+            {
+                InsertVertex(p, anchor);
+                return;
+            }
+            w = prev[w];
+            continue;
+        }
+        if (Turn(x, anchor, p, now) < 0)
+        {
+            if (next[x] == anchor)
+            {
+                InsertVertex(p, x);
+                return;
+            }
+            w = x;
+            continue;
+        }
+        if (Turn(w, x, p, now) < 0)
+        {
+            InsertVertex(p, w);
+            return;
+        }
+        AddMember(w, p);
+        Schedule(p);
+        return;
+    }
+    needRecertify = true;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::InsertVertex
+
+  Summary:  Links p into the hull right after the vertex after and
+            splits the fan triangle of after between after and p.
+
+  Modifies: [hull links, members].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::InsertVertex(uint32_t p, uint32_t after)
+{
+    //the hull can be off by a rounding step between events; a repair that
+    //keeps growing is cut short and rebuilt
+    if (++repairs > base.size())
+    {
+        needRecertify = true;
+        return;
+    }
+    RemoveMember(p);
+
+    const uint32_t b = next[after];
+    next[after] = p;
+    prev[p] = after;
+    next[p] = b;
+    prev[b] = p;
+    onHull[p] = 1;
+    hullSize++;
+
+    vector<uint32_t> displaced;
+    displaced.swap(members[after]);
+    for (uint32_t q : displaced)
+    {
+        wedge[q] = None;
+    }
+    Settle(after, b, displaced);
+    if (!needRecertify)
+    {
+        Schedule(p);
+    }
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::RemoveVertex
+
+  Summary:  Drops a hull vertex whose convexity certificate failed and
+            hands it and the points of the two fan triangles around it
+            to the merged triangle.
+
+  Modifies: [hull links, members].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::RemoveVertex(uint32_t h)
+{
+    if (h == anchor || hullSize <= 3)
+    {
+        needRecertify = true;
+        return;
+    }
+
+    const uint32_t a = prev[h];
+    const uint32_t c = next[h];
+    vector<uint32_t> displaced;
+    Unlink(h, displaced);
+    Settle(a, c, displaced);
+}
+
+//takes h off the hull; it and the points of the two triangles it bounded go to displaced
+void KineticHull::Unlink(uint32_t h, vector<uint32_t>& displaced)
+{
+    const uint32_t a = prev[h];
+    const uint32_t c = next[h];
+
+    const size_t first = displaced.size();
+    displaced.insert(displaced.end(), members[a].begin(), members[a].end());
+    displaced.insert(displaced.end(), members[h].begin(), members[h].end());
+    members[a].clear();
+    members[h].clear();
+    for (size_t i = first; i < displaced.size(); i++)
+    {
+        wedge[displaced[i]] = None;
+    }
+    displaced.push_back(h);
+
+    next[a] = c;
+    prev[c] = a;
+    next[h] = prev[h] = None;
+    onHull[h] = 0;
+    hullSize--;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Settle
+
+  Summary:  Finishes a repair between the hull vertices a and c. At a
+            degenerate instant the neighbours can stop turning left
+            along with the vertex that failed (points collinear with
+            it, or on top of it), so those are taken off too before any
+            displaced point is walked across the fan, which needs the
+            hull convex. Then the new certificates are scheduled and
+            the displaced points assigned.
+
+  Args:     uint32_t a, c
+              the vertices on either side of the change
+            vector<uint32_t>& displaced
+              points left without a wedge
+
+  Modifies: [hull links, members, queue].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::Settle(uint32_t a, uint32_t c, vector<uint32_t>& displaced)
+{
+    for (;;)
+    {
+        uint32_t h = None;
+        if (Broken(a, Convexity, now))
+        {
+            h = a;
+            a = prev[a];
+        }
+        else if (Broken(c, Convexity, now))
+        {
+            h = c;
+            c = next[c];
+        }
+        else
+        {
+            break;
+        }
+        if (h == anchor || hullSize <= 3)
+        {
+            needRecertify = true;
+            return;
+        }
+        Unlink(h, displaced);
+    }
+
+    Schedule(a);
+    Schedule(c);
+
+    for (uint32_t q : displaced)
+    {
+        if (needRecertify)
+        {
+            return;
+        }
+        if (wedge[q] == None && !onHull[q])
+        {
+            Assign(q, a);
+        }
+    }
+}
+
+void KineticHull::HandleEvent(const Event& e)
+{
+    const uint32_t p = e.point;
+    if (e.kind == Convexity)
+    {
+        RemoveVertex(p);
+        return;
+    }
+    // A point passing through a corner leaves its triangle across two
+    // sides at once, so it is walked to where it is now instead of
+    // across the side whose certificate failed; a single step costs
+    // the same either way.
+    const uint32_t w = wedge[p];
+    RemoveMember(p);
+    Assign(p, w);
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Recertify
+
+  Summary:  Fallback path. Recomputes the hull of the current
+            positions with QuickHull, puts every interior point in its
+            fan triangle by binary search and reschedules every
+            certificate. O(n log n).
+
+  Modifies: [every member but the trajectories].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::Recertify()
+{
+    recertifyCount++;
+    needRecertify = false;
+
+    // The trajectories are left as given: rebasing them here would
+    // round the positions at an arbitrary time, and points that move
+    // together on one line would drift off it.
+    const size_t n = base.size();
+    const double tau = now - origin;
+    vector<Point2D> positions(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        positions[i] = PositionAt(i, tau);
+    }
+
+    queue.clear();
+    watch.clear();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ++gen[i];
+        members[i].clear();
+        wedge[i] = None;
+        onHull[i] = 0;
+        next[i] = prev[i] = None;
+    }
+
+    QuickHull(positions, hullCache);
+    hullSize = hullCache.size();
+
+    // Anchor on the sharpest corner so the vertex every fan triangle
+    // depends on is the one least likely to leave the hull soon.
+    size_t sharpest = 0;
+    double sharpestTurn = -1;
+    for (size_t i = 0; i < hullSize && hullSize >= 3; i++)
+    {
+        const Point2D& a = positions[hullCache[(i + hullSize - 1) % hullSize]];
+        const Point2D& h = positions[hullCache[i]];
+        const Point2D& c = positions[hullCache[(i + 1) % hullSize]];
+        const double lengths = hypot(h.x - a.x, h.y - a.y) * hypot(c.x - h.x, c.y - h.y);
+        const double turn = lengths > 0 ? Cross(a, h, c) / lengths : 0;
+        if (turn > sharpestTurn)
+        {
+            sharpestTurn = turn;
+            sharpest = i;
+        }
+    }
+    rotate(hullCache.begin(), hullCache.begin() + sharpest, hullCache.end());
+    anchor = hullCache.empty() ? None : hullCache[0];
+    for (size_t i = 0; i < hullSize; i++)
+    {
+        const uint32_t h = hullCache[i];
+        onHull[h] = 1;
+        next[h] = hullCache[(i + 1) % hullSize];
+        prev[h] = hullCache[(i + hullSize - 1) % hullSize];
+    }
+
+    // Two or fewer hull vertices cannot be certified with fan
+    // triangles; Advance recomputes the hull until the set opens up.
+    degenerate = hullSize < 3;
+    if (degenerate)
+    {
+        return;
+    }
+
+    const Point2D& o = positions[anchor];
+    for (uint32_t p = 0; p < n; p++)
+    {
+        if (onHull[p])
+        {
+            continue;
+        }
+        // Largest fan index whose ray is clockwise of p.
+        size_t lo = 1;
+        size_t hi = hullSize - 2;
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi + 1) / 2;
+            if (Orientation(o, positions[hullCache[mid]], positions[p]) >= 0)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+        AddMember(hullCache[lo], p);
+    }
+
+    for (uint32_t p = 0; p < n; p++)
+    {
+        Schedule(p);
+    }
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Advance
+
+  Summary:  Moves the structure forward to time t, repairing the hull
+            at every certificate failure on the way. The cost is
+            proportional to the number of events, not to n, unless a
+            repair falls back to Recertify.
+
+  Args:     double t
+              target time, clamped so time never goes backwards
+
+  Modifies: [hull, certificates, now].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::Advance(double t)
+{
+    if (t < now)
+    {
+        t = now;
+    }
+
+    // Degenerate inputs can keep breaking and re-making the same
+    // certificates around one instant, a rounding step apart. Past
+    // about what a rebuild costs, stop repairing and rebuild at t.
+    const size_t eventLimit = 8 * base.size() + 64;
+    size_t events = 0;
+    vector<Event> deferred;
+
+    for (;;)
+    {
+        while (!degenerate && !queue.empty() && queue.front().time <= t + Slack(t))
+        {
+            pop_heap(queue.begin(), queue.end());
+            const Event e = queue.back();
+            queue.pop_back();
+            if (e.gen != gen[e.point])
+            {
+                continue;
+            }
+            if (++events > eventLimit)
+            {
+                degenerate = true;
+                break;
+            }
+            if (e.time < now)
+            {
+                //left over from before the last repair; take its turn among the events at now
+                Push(now, e.point, e.kind);
+                continue;
+            }
+
+            // The queued time is a rounded root. Repair only a certificate
+            // that the exact test shows broken at it; one that is broken
+            // just past it is queued again for then, behind anything due
+            // before, and one that holds at both is looked for again from
+            // there, or, once that is t, from t in a later call.
+            const double at = min(e.time, t);
+            if (!Broken(e.point, e.kind, at))
+            {
+                const double past = min(at + Slack(at), t);
+                if (past > at && Broken(e.point, e.kind, past))
+                {
+                    Push(past, e.point, e.kind);
+                }
+                else if (past > at && e.kind == Convexity)
+                {
+                    // A vertex that only touches the line of its
+                    // neighbours, where rounding hides the moment, may
+                    // come out folded back over one of them with every
+                    // turn still left, which no certificate catches, so
+                    // the hull is rebuilt just past it.
+                    now = past;
+                    Recertify();
+                }
+                else if (past < t)
+                {
+                    Push(FailureTime(e.point, e.kind, past), e.point, e.kind);
+                }
+                else
+                {
+                    deferred.push_back(e);
+                }
+                continue;
+            }
+
+            now = at;
+            eventCount++;
+            repairs = 0;
+            HandleEvent(e);
+
+            if (needRecertify)
+            {
+                Recertify();
+            }
+            CompactQueue();
+        }
+
+        // The watched certificates count only where the hull is asked
+        // for; one that fails at t is queued for t and the loop runs
+        // again.
+        bool more = false;
+        size_t kept = 0;
+        for (const Event& e : watch)
+        {
+            if (e.gen != gen[e.point] || degenerate)
+            {
+                continue;
+            }
+            if (Broken(e.point, e.kind, t))
+            {
+                Push(t, e.point, e.kind);
+                more = true;
+            }
+            else
+            {
+                watch[kept++] = e;
+            }
+        }
+        watch.resize(kept);
+        if (!more)
+        {
+            break;
+        }
+    }
+
+    now = t;
+    if (degenerate && !base.empty())
+    {
+        Recertify();
+        return;
+    }
+    for (const Event& e : deferred)
+    {
+        if (e.gen == gen[e.point])
+        {
+            Push(FailureTime(e.point, e.kind, t), e.point, e.kind);
+        }
+    }
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::SetVelocity
+
+  Summary:  Changes the trajectory of one point from the current time
+            on. Only the certificates that involve the point are
+            rescheduled; a change on the anchor vertex, which every fan
+            triangle depends on, recertifies everything.
+
+  Args:     uint32_t i
+              point index
+            const Point2D& velocity
+              new velocity
+
+  Modifies: [trajectory of i, certificates].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void KineticHull::SetVelocity(uint32_t i, const Point2D& velocity)
+{
+    const double tau = now - origin;
+    const Point2D p = PositionAt(i, tau);
+    vel[i] = velocity;
+    base[i] = Point2D{ p.x - velocity.x * tau, p.y - velocity.y * tau };
+
+    if (degenerate)
+    {
+        return;
+    }
+    if (!onHull[i])
+    {
+        Schedule(i);
+        return;
+    }
+    if (i == anchor)
+    {
+        Recertify();
+        return;
+    }
+    Schedule(prev[i]);
+    Schedule(i);
+    Schedule(next[i]);
+    ScheduleWedge(prev[i]);
+    ScheduleWedge(i);
+}
+
+//points past the end of velocities keep theirs; every trajectory is rebased at now
+void KineticHull::SetVelocities(const vector<Point2D>& velocities)
+{
+    const double tau = now - origin;
+    for (uint32_t i = 0; i < base.size(); i++)
+    {
+        base[i] = PositionAt(i, tau);
+        if (i < velocities.size())
+        {
+            vel[i] = velocities[i];
+        }
+    }
+    origin = now;
+    Recertify();
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   KineticHull::Hull
+
+  Summary:  Current hull as point indices, counter-clockwise from the
+            left most vertex. Flushes certificates that are already
+            broken at the current time (e.g. after SetVelocity) first.
+
+  Returns:  const vector<uint32_t>&
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+const vector<uint32_t>& KineticHull::Hull()
+{
+    Advance(now);
+
+    //the left most vertex changes as the points move, so the order is rebuilt every time
+    hullCache.clear();
+    size_t first = 0;
+    Point2D leftMost = Point2D{ 0, 0 };
+    for (uint32_t h = anchor; h != None && hullCache.size() < hullSize; h = next[h])
+    {
+        const Point2D p = Position(h);
+        if (hullCache.empty() || p.x < leftMost.x || (p.x == leftMost.x && p.y < leftMost.y))
+        {
+            first = hullCache.size();
+            leftMost = p;
+        }
+        hullCache.push_back(h);
+    }
+    rotate(hullCache.begin(), hullCache.begin() + first, hullCache.end());
+    return hullCache;
+}
@@ -0,0 +1,151 @@
+#ifndef _KINETICHULL_H
+#define _KINETICHULL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    KineticHull
+
+  Summary:  Kinetic data structure that keeps the convex hull of points
+            moving along linear trajectories p(t) = p0 + v * t.
+
+            The hull is proved by a set of orientation certificates:
+              - every hull vertex h: Cross(prev(h), h, next(h)) > 0
+              - every interior point p sits in one fan triangle
+                (anchor, w, next(w)) of the hull and holds the three
+                certificates of that triangle.
+            Each certificate is a quadratic in t, so its failure time
+            is known in advance and kept in an event queue. The root
+            is only an estimate; whether a certificate holds at a given
+            time is decided with the exact Orientation test on the
+            positions at that time, so a point on an edge or on top of
+            another one never becomes a hull vertex. Advance(t)
+            only does work for the certificates that fail before t:
+            a point moves to a neighbouring fan triangle, joins the
+            hull, or drops off it, and only the certificates touching
+            that change are rescheduled.
+
+            Recertify() throws all certificates away and rebuilds them
+            from a fresh QuickHull. It is the fallback for anything the
+            local repairs do not cover: the anchor vertex leaving the
+            hull, a degenerate (collinear) hull, a velocity change on
+            the anchor, a vertex touching the line of its neighbours
+            at a moment rounding hides, or more events in one Advance
+            than a rebuild would cost.
+
+  Methods:  Reset
+              Loads positions (at startTime) and velocities.
+            Advance
+              Processes every certificate failure up to time t.
+            SetVelocity
+              Changes one trajectory at the current time.
+            SetVelocities
+              Changes the velocities (points past the end of the
+              list keep theirs) and recertifies.
+            Recertify
+              Rebuilds the hull and every certificate at the current time.
+            Hull
+              Hull vertices, counter-clockwise from the left most one,
+              as point indices.
+            Position
+              Position of a point at the current time.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class KineticHull
+{
+public:
+    KineticHull();
+
+    void Reset(const std::vector<Point2D>& positions, const std::vector<Point2D>& velocities, double startTime = 0);
+    void Advance(double t);
+    void SetVelocity(uint32_t i, const Point2D& velocity);
+    void SetVelocities(const std::vector<Point2D>& velocities);
+    void Recertify();
+
+    const std::vector<uint32_t>& Hull();
+    Point2D Position(uint32_t i) const;
+
+    double Time() const { return now; }
+    size_t Size() const { return base.size(); }
+    size_t EventCount() const { return eventCount; }
+    size_t RecertifyCount() const { return recertifyCount; }
+
+private:
+    enum CertKind : uint8_t
+    {
+        Convexity,  // hull vertex: Cross(prev, h, next) > 0
+        WedgeLeft,  // interior:    Cross(anchor, w, p) >= 0
+        WedgeEdge,  // interior:    Cross(w, next(w), p) >= 0
+        WedgeRight  // interior:    Cross(next(w), anchor, p) >= 0
+    };
+
+    struct Event
+    {
+        double   time;
+        uint32_t point;
+        uint32_t gen;
+        CertKind kind;
+
+        //earliest first, and at one time convexity first, so the hull is convex again
+        //before any interior point is walked across it
+        bool operator<(const Event& other) const { return time != other.time ? time > other.time : kind > other.kind; }
+    };
+
+    enum : uint32_t { None = 0xFFFFFFFFu };
+
+    Point2D PositionAt(uint32_t i, double tau) const;
+    void    Quadratic(uint32_t a, uint32_t b, uint32_t c, double& c0, double& c1, double& c2) const;
+    int     Turn(uint32_t a, uint32_t b, uint32_t c, double time) const;
+    void    Certificate(uint32_t p, CertKind kind, uint32_t& a, uint32_t& b, uint32_t& c) const;
+    bool    Broken(uint32_t p, CertKind kind, double time) const;
+    double  FailureTime(uint32_t a, uint32_t b, uint32_t c, bool strict, double from) const;
+    double  FailureTime(uint32_t p, CertKind kind, double from) const;
+    void    Schedule(uint32_t p);
+    void    Schedule(uint32_t p, CertKind kind);
+    void    ScheduleWedge(uint32_t w);
+    void    Push(double time, uint32_t p, CertKind kind);
+    void    CompactQueue();
+
+    void    AddMember(uint32_t w, uint32_t p);
+    void    RemoveMember(uint32_t p);
+    void    Assign(uint32_t p, uint32_t hint);
+    void    InsertVertex(uint32_t p, uint32_t after);
+    void    RemoveVertex(uint32_t h);
+    void    Unlink(uint32_t h, std::vector<uint32_t>& displaced);
+    void    Settle(uint32_t a, uint32_t c, std::vector<uint32_t>& displaced);
+    void    HandleEvent(const Event& e);
+
+    // trajectories: p(t) = base + vel * (t - origin)
+    std::vector<Point2D>                base;
+    std::vector<Point2D>                vel;
+    double                              origin;
+    double                              now;
+
+    // hull as a circular doubly linked list over point indices
+    std::vector<uint32_t>               next;
+    std::vector<uint32_t>               prev;
+    std::vector<uint8_t>                onHull;
+    uint32_t                            anchor;
+    size_t                              hullSize;
+    bool                                degenerate;
+
+    // fan triangle membership of interior points, keyed by wedge owner
+    std::vector<std::vector<uint32_t>>  members;
+    std::vector<uint32_t>               wedge;
+    std::vector<uint32_t>               slot;
+
+    std::vector<uint32_t>               gen;
+    std::vector<Event>                  queue;
+    std::vector<Event>                  watch;      // certificates that are collinear at every time
+
+    std::vector<uint32_t>               hullCache;
+    size_t                              eventCount;
+    size_t                              recertifyCount;
+    size_t                              repairs;    // vertices inserted by the current event
+    bool                                needRecertify;
+};
+
+#endif
@@ -9,8 +9,15 @@ using namespace std;
 
 #pragma comment(lib, "d2d1")
 
+#include "arena.h"
 #include "basewin.h"
+#include "dataflow.h"
+#include "hullworker.h"
+#include "instrument.h"
+#include "pointgen.h"
+#include "predicates.h"
 #include "resource.h"
+#include "snapshot.h"
 #include <functional>
 
 //button format macros
@@ -28,6 +35,9 @@ using namespace std;
 #define GJK 104
 #define EXIT 105
 
+//posted by the hull worker when it has published a result
+#define WM_HULL_RESULT (WM_APP + 1)
+
 //drawing format macros
 #define VERTEX_RADIUS 10.0
 #define MIN_VERTEX_X 300
@@ -118,6 +128,16 @@ struct MyEllipse
 
 D2D1::ColorF::Enum colors[] = { D2D1::ColorF::Yellow, D2D1::ColorF::Salmon, D2D1::ColorF::LimeGreen };
 
+//the hulls as last published by MainWindow, for threads that read them without the UI thread
+struct HullSnapshot
+{
+    uint64_t                version = 0;
+    vector<D2D1_POINT_2F>   convexHull;
+    vector<D2D1_POINT_2F>   convexHull2;
+    vector<D2D1_POINT_2F>   convexHull3;
+    BOOL                    originInside = FALSE;
+};
+
 
 class MainWindow : public BaseWindow<MainWindow>
 {
@@ -148,14 +168,39 @@ class MainWindow : public BaseWindow<MainWindow>
     AlgoMode                algoMode;
     size_t                  nextColor;
 
+    //declared ahead of the containers that point into them, so they are destroyed last
+    Arena                                   hullArenas[3];  //vertices of convexHull, convexHull2 and convexHull3, each reset when its hull is rebuilt
+    Arena                                   scratchArena;   //temporaries of a single computation
+
     list<shared_ptr<MyEllipse>>             ellipses;
     list<shared_ptr<MyEllipse>>             ellipses2;
-    list<shared_ptr<MyEllipse>>             ellipses3;
     vector<D2D1_POINT_2F>                   prevPoints;
     vector<shared_ptr<D2D1_POINT_2F>>       convexHull;
     vector<shared_ptr<D2D1_POINT_2F>>       convexHull2;
     vector<shared_ptr<D2D1_POINT_2F>>       convexHull3;//used for MinkowskiSum, MinkowskiDiff, and GJK
     shared_ptr<MyEllipse>                   graphOrigin; //used for MinkowskiSum, MinkowskiDiff, and GJK
+    BOOL                                    originInside = FALSE; //graphOrigin in convexHull3, for GJK
+
+    //copies of the hulls above, replaced whenever they change; read by other threads through a Reader
+    SnapshotPublisher<HullSnapshot>         hullSnapshots;
+    uint64_t                                hullVersion = 0;
+    BOOL                                    hullsChanged = TRUE;  //since the last PublishHulls, or none yet
+
+    //what AlgoTest computes from what; the hulls above are the memoized stage values
+    DirtyGraph              pipeline;
+    const DirtyGraph::Node  pointsNode = pipeline.AddSource();     //ellipses
+    const DirtyGraph::Node  points2Node = pipeline.AddSource();    //ellipses2
+    const DirtyGraph::Node  originNode = pipeline.AddSource();     //graphOrigin
+    const DirtyGraph::Node  hullNode = pipeline.AddStage({ pointsNode });
+    const DirtyGraph::Node  hull2Node = pipeline.AddStage({ points2Node });
+    //the Minkowski points are shifted by graphOrigin, so the stage hangs off it too
+    const DirtyGraph::Node  hull3Node = pipeline.AddStage({ hullNode, hull2Node, originNode });
+    const DirtyGraph::Node  pointQueryNode = pipeline.AddStage({ pointsNode, hull2Node });
+    const DirtyGraph::Node  originQueryNode = pipeline.AddStage({ originNode, hull3Node });
+
+    //drags hand snapshots to the worker instead of running AlgoTest on every mouse move
+    uint64_t                submittedSequence = 0;  //last request given to worker
+    uint64_t                shownSequence = 0;      //results up to this one are older than what is shown
 
     list<shared_ptr<MyEllipse>>::iterator   selection;
     list<shared_ptr<MyEllipse>>::iterator   selection2;
@@ -168,6 +213,12 @@ class MainWindow : public BaseWindow<MainWindow>
     FLOAT minZoomScale = 0.6f;
     FLOAT maxZoomScale = 8;
 
+    CounterRandom   random = CounterRandom(1); //fixed seed, so every run generates the same sets
+    uint64_t        randomDraws = 0;
+
+    //declared last, so its thread stops before anything it could post about is destroyed
+    HullWorker      worker{ [this](uint64_t) { PostMessage(m_hwnd, WM_HULL_RESULT, 0, 0); } };
+
     shared_ptr<MyEllipse> Selection()
     {
 
@@ -206,11 +257,17 @@ class MainWindow : public BaseWindow<MainWindow>
 
     void ClearLists();
     void AlgoTest();
-    BOOL IsRight(shared_ptr<D2D_POINT_2F> a, shared_ptr<D2D_POINT_2F> b, shared_ptr<D2D_POINT_2F> c);
-    void QuickHull(const list<shared_ptr<MyEllipse>>& points, vector<shared_ptr<D2D_POINT_2F>>& convexHull);
-    BOOL PointInConvexHull(shared_ptr<D2D_POINT_2F> point, const vector<shared_ptr<D2D_POINT_2F>>& convexHull);
-    void MinkowskiSum(const vector<shared_ptr<D2D_POINT_2F>>& convexHull,const  vector<shared_ptr<D2D_POINT_2F>>& convexHull2, list<shared_ptr<MyEllipse>>& points);
-    void MinkowskiDiff(const vector<shared_ptr<D2D_POINT_2F>>& convexHull,const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, list<shared_ptr<MyEllipse>>& points);
+    void RebuildHull(DirtyGraph::Node stage, const list<shared_ptr<MyEllipse>>& points, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena);
+    void RebuildHull(DirtyGraph::Node stage, const D2D_POINT_2F* points, size_t count, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena);
+    void SubmitHulls();
+    void OnHullResult();
+    void ShowHull(const vector<Point2D>& vertices, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena);
+    void PublishHulls();
+    BOOL IsRight(const D2D_POINT_2F& a, const D2D_POINT_2F& b, const D2D_POINT_2F& c);
+    void QuickHull(const D2D_POINT_2F* points, size_t count, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena);
+    BOOL PointInConvexHull(const D2D_POINT_2F& point, const vector<shared_ptr<D2D_POINT_2F>>& convexHull);
+    void MinkowskiSum(const vector<shared_ptr<D2D_POINT_2F>>& convexHull, const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, ArenaVector<D2D_POINT_2F>& points);
+    void MinkowskiDiff(const vector<shared_ptr<D2D_POINT_2F>>& convexHull, const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, ArenaVector<D2D_POINT_2F>& points);
 
 public:
 
@@ -219,6 +276,9 @@ public:
     {
     }
 
+    //readers must be destroyed before the window
+    SnapshotPublisher<HullSnapshot>& Hulls() { return hullSnapshots; }
+
     PCWSTR  ClassName() const { return L"Circle Window Class"; }
     LRESULT HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam);
 };
@@ -359,7 +419,7 @@ void MainWindow::OnPaint()
         // If the hulls are colliding in gjk, make convexHull3 green
         if (algoMode == AlgoMode::gjk)
         {
-            if (PointInConvexHull(graphOrigin->GetVertexPointer(), convexHull3))
+            if (originInside)
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::LawnGreen));
         }
         for (auto i = convexHull3.begin(), prev = convexHull3.end();
@@ -440,10 +500,8 @@ void MainWindow::ScalePoints(float scale)
         (*i)->ellipse.point.x = graphOrigin->ellipse.point.x + (((*i)->ellipse.point.x - graphOrigin->ellipse.point.x) * scale);
         (*i)->ellipse.point.y = graphOrigin->ellipse.point.y + (((*i)->ellipse.point.y - graphOrigin->ellipse.point.y) * scale);
     }
-    convexHull.clear();
-    convexHull2.clear();
-    convexHull3.clear();
-    ellipses3.clear();
+    pipeline.Touch(pointsNode);
+    pipeline.Touch(points2Node);
     AlgoTest();
 }
 
@@ -461,21 +519,18 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
     {
         SetCapture(m_hwnd);
 
-        convexHull.clear();
-        convexHull2.clear();
-        convexHull3.clear();
+        //selecting moves nothing, so the hulls stay as they are
         ptMouse = Selection()->ellipse.point;
         ptMouse.x -= dipX;
         ptMouse.y -= dipY;
         /*Selection()->vertex->x -= dipX;
         Selection()->vertex->x -= dipY;*/
-        AlgoTest();
         /*   OnPaint();*/
         convexHullDrag = FALSE;
         SetMode(DragMode);
     }
     else
-        if (convexHull.size() > 3 && PointInConvexHull(make_shared<D2D1_POINT_2F>(mousePoint), convexHull))
+        if (convexHull.size() > 3 && PointInConvexHull(mousePoint, convexHull))
         {
             OutputDebugStringW(L"convexhull 1 drag\n");
             prevPoints.clear();
@@ -489,7 +544,7 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
             SetMode(DragMode);
         }
         else
-            if (convexHull2.size() > 3 && PointInConvexHull(make_shared<D2D1_POINT_2F>(mousePoint), convexHull2))
+            if (convexHull2.size() > 3 && PointInConvexHull(mousePoint, convexHull2))
             {
                 OutputDebugStringW(L"convexhull 2 drag\n");
                 prevPoints.clear();
@@ -505,7 +560,7 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
             else
                 if (algoMode == AlgoMode::MinkowskiSum || algoMode == AlgoMode::MinkowskiDifference || algoMode == AlgoMode::gjk)
                 {
-                    if (!PointInConvexHull(make_shared<D2D1_POINT_2F>(mousePoint), convexHull) && !PointInConvexHull(make_shared<D2D1_POINT_2F>(mousePoint), convexHull2))
+                    if (!PointInConvexHull(mousePoint, convexHull) && !PointInConvexHull(mousePoint, convexHull2))
                     {
                         prevPoints.clear();
                         for (auto const& point : ellipses2)
@@ -548,11 +603,6 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
     {
         if (mode == DragMode)
         {
-            convexHull.clear();
-            convexHull2.clear();
-            convexHull3.clear();
-            ellipses3.clear();
-
             if (convexHullDrag)
             {
                 size_t count = 0;
@@ -565,6 +615,7 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
                         (*i)->ellipse.point.y = dipY + prevPoints[count].y;
                         count++;
                     }
+                    pipeline.Touch(pointsNode);
                 }
                 else
                 {
@@ -574,6 +625,7 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
                         (*i)->ellipse.point.y = dipY + prevPoints[count].y;
                         count++;
                     }
+                    pipeline.Touch(points2Node);
                 }
                 if (noSelection)
                 {
@@ -592,6 +644,9 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
                     }
                     graphOrigin->ellipse.point.x = dipX + prevPoints[prevPoints.size() - 1].x;
                     graphOrigin->ellipse.point.y = dipY + prevPoints[prevPoints.size() - 1].y;
+                    pipeline.Touch(pointsNode);
+                    pipeline.Touch(points2Node);
+                    pipeline.Touch(originNode);
                 }
             }
             else
@@ -600,8 +655,9 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
                 // Move the ellipse.
                 Selection()->ellipse.point.x = dipX + ptMouse.x;
                 Selection()->ellipse.point.y = dipY + ptMouse.y;
+                pipeline.Touch(selection1 ? pointsNode : points2Node);
             }
-            AlgoTest();
+            SubmitHulls();
         }
         InvalidateRect(m_hwnd, NULL, FALSE);
     }
@@ -617,6 +673,7 @@ void MainWindow::OnKeyDown(UINT vkey)
         if ((mode == SelectMode) && Selection())
         {
             ellipses.erase(selection);
+            pipeline.Touch(pointsNode);
             ClearSelection();
             SetMode(SelectMode);
             InvalidateRect(m_hwnd, NULL, FALSE);
@@ -664,22 +721,25 @@ HRESULT MainWindow::InsertEllipse(float x, float y)
 /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
   Method:   MainWindow::GenerateRandomEllipse
 
-  Summary:  randomly generates a point in the window
+  Summary:  randomly generates a point in the window, uniform over
+            [minX, maxX) x [minY, maxY) without the modulo bias and
+            integer rounding of rand() % range
 
   Args:     D2D1::ColorF color
                 color of point
 
-  Modifies: [].
+  Modifies: [randomDraws].
 
   Returns:  shared_ptr<MyEllipse>
               smart pointer to a new point
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 std::shared_ptr<MyEllipse> MainWindow::GenerateRandomEllipse(D2D1::ColorF color, int maxX, int maxY, int minX, int minY)
 {
-    maxX = maxX - minX;
-    maxY = maxY - minY;
+    const uint64_t draw = 2 * randomDraws++;
+    const float x = (float)(minX + random.Unit(draw) * (maxX - minX));
+    const float y = (float)(minY + random.Unit(draw + 1) * (maxY - minY));
     std::shared_ptr<MyEllipse> newEllipse = std::make_shared<MyEllipse>();
-    newEllipse->ellipse = D2D1::Ellipse(D2D1::Point2F((float)(rand() % maxX + minX), (float)(rand() % maxY + minY)), VERTEX_RADIUS, VERTEX_RADIUS);
+    newEllipse->ellipse = D2D1::Ellipse(D2D1::Point2F(x, y), VERTEX_RADIUS, VERTEX_RADIUS);
     newEllipse->color = (color);
     /* newEllipse->vertex = std::make_shared<D2D_POINT_2F>();
      newEllipse->vertex->vertex = newEllipse->ellipse.point;*/
@@ -783,11 +843,12 @@ void MainWindow::GenerateOrigin()
 /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
   Method:    MainWindow::ClearLists()
 
-  Summary:  Clears the list of points and vertices
+  Summary:  Clears the list of points and vertices, and marks every
+            stage of the pipeline stale for the sets that replace them
 
   Args:     NONE
 
-  Modifies: [ellipses, ellipses2, ellipses3, convexHull, convexHull2, convexHull3].
+  Modifies: [ellipses, ellipses2, convexHull, convexHull2, convexHull3, pipeline, hullsChanged, hullSnapshots].
 
   Returns:  VOID
               No return type
@@ -796,66 +857,349 @@ void MainWindow::ClearLists()
 {
     ellipses.clear();
     ellipses2.clear();
-    ellipses3.clear();
     convexHull.clear();
     convexHull2.clear();
     convexHull3.clear();
+    pipeline.TouchAll();
+    hullsChanged = TRUE;
+    PublishHulls();
 }
 
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MainWindow::AlgoTest
+
+  Summary:  Brings the current mode's results up to date. The stages
+            run in pipeline order and each one only when something it
+            depends on has changed, so dragging the second set rebuilds
+            convexHull2 and what follows from it but not convexHull, and
+            a drag that leaves a hull as it was stops there, without
+            publishing a snapshot.
+
+  Args:     NONE
+
+  Modifies: [convexHull, convexHull2, convexHull3, originInside, pipeline, hullsChanged, hullSnapshots].
+
+  Returns:  VOID
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 void MainWindow::AlgoTest()
 {
+    HULL_SCOPE("MainWindow::AlgoTest");
+    //whatever the worker still has in hand is older than this
+    shownSequence = submittedSequence;
+    const BOOL twoHulls = algoMode == AlgoMode::MinkowskiSum || algoMode == AlgoMode::MinkowskiDifference || algoMode == AlgoMode::gjk;
+    if (algoMode != AlgoMode::PointConvexHullIntersection)
+    {
+        RebuildHull(hullNode, ellipses, convexHull, hullArenas[0]);
+    }
+    if (algoMode != AlgoMode::QuickHull)
+    {
+        RebuildHull(hull2Node, ellipses2, convexHull2, hullArenas[1]);
+    }
+
+    if (twoHulls && pipeline.Stale(hull3Node))
+    {
+        //the Minkowski points only live until convexHull3 is built from them
+        ArenaScope scope(scratchArena);
+        ArenaVector<D2D_POINT_2F> minkowskiPoints{ ArenaAllocator<D2D_POINT_2F>(scratchArena) };
+        if (algoMode == AlgoMode::MinkowskiSum)
+            MinkowskiSum(convexHull, convexHull2, minkowskiPoints);
+        else
+            MinkowskiDiff(convexHull, convexHull2, minkowskiPoints);
+        RebuildHull(hull3Node, minkowskiPoints.data(), minkowskiPoints.size(), convexHull3, hullArenas[2]);
+    }
+
+    if (algoMode == AlgoMode::PointConvexHullIntersection && pipeline.Stale(pointQueryNode))
+    {
+        if (PointInConvexHull(ellipses.front()->ellipse.point, convexHull2))
+            ellipses.front()->color = D2D1::ColorF(D2D1::ColorF::Red);
+        else
+            ellipses.front()->color = D2D1::ColorF(D2D1::ColorF::Green);
+        pipeline.Computed(pointQueryNode, true);
+    }
+    if (algoMode == AlgoMode::gjk && pipeline.Stale(originQueryNode))
+    {
+        const BOOL inside = PointInConvexHull(graphOrigin->ellipse.point, convexHull3);
+        hullsChanged = hullsChanged || (inside != FALSE) != (originInside != FALSE);
+        originInside = inside;
+        pipeline.Computed(originQueryNode, true);
+    }
+    PublishHulls();
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:    MainWindow::RebuildHull
+
+  Summary:  Rebuilds a hull stage of the pipeline if it is stale, from
+            the centers of a list of points, copied into scratchArena.
+
+  Args:     DirtyGraph::Node stage
+              pipeline stage of the hull
+            const list<shared_ptr<MyEllipse>>& points
+              List of points that the convex hull will form around
+            vector<shared_ptr<D2D_POINT_2F>>& convexHull
+              the hull, kept if the stage is clean
+            Arena& vertexArena
+              the arena that holds only this hull's vertices
+
+  Modifies: [convexHull, vertexArena, pipeline].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MainWindow::RebuildHull(DirtyGraph::Node stage, const list<shared_ptr<MyEllipse>>& points, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena)
+{
+    if (!pipeline.Stale(stage))
+    {
+        return;
+    }
+    ArenaScope scope(scratchArena);
+    D2D_POINT_2F* centers = scratchArena.Allocate<D2D_POINT_2F>(points.size());
+    size_t count = 0;
+    for (auto const& point : points)
+    {
+        centers[count++] = point->ellipse.point;
+    }
+    RebuildHull(stage, centers, count, convexHull, vertexArena);
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:    MainWindow::RebuildHull
+
+  Summary:  Recomputes a hull stage and records it in the pipeline.
+            The old vertices are copied aside first, and the stage only
+            counts as changed when the new hull differs from them, so
+            moving a point around inside a hull leaves the stages that
+            use the hull clean.
+
+  Args:     DirtyGraph::Node stage
+              pipeline stage of the hull
+            const D2D_POINT_2F* points, size_t count
+              points that the convex hull will form around
+            vector<shared_ptr<D2D_POINT_2F>>& convexHull
+              receives the hull
+            Arena& vertexArena
+              the arena that holds only this hull's vertices, reset here
+
+  Modifies: [convexHull, vertexArena, pipeline, hullsChanged].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MainWindow::RebuildHull(DirtyGraph::Node stage, const D2D_POINT_2F* points, size_t count, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena)
+{
+    ArenaScope scope(scratchArena);
+    const size_t previousCount = convexHull.size();
+    D2D_POINT_2F* previous = scratchArena.Allocate<D2D_POINT_2F>(previousCount);
+    for (size_t i = 0; i < previousCount; i++)
+    {
+        previous[i] = *convexHull[i];
+    }
+
+    //the hull holds vertices in vertexArena, so it goes before the arena is reset
+    convexHull.clear();
+    vertexArena.Reset();
+    QuickHull(points, count, convexHull, vertexArena);
+
+    BOOL changed = convexHull.size() != previousCount;
+    for (size_t i = 0; !changed && i < previousCount; i++)
+    {
+        changed = convexHull[i]->x != previous[i].x || convexHull[i]->y != previous[i].y;
+    }
+    pipeline.Computed(stage, changed != FALSE);
+    hullsChanged = hullsChanged || changed;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MainWindow::SubmitHulls
+
+  Summary:  Hands the worker a snapshot of what the current mode
+            computes, in place of running AlgoTest inside the mouse
+            move. The drag goes on at once; the result is shown when
+            WM_HULL_RESULT arrives, and a snapshot overtaken by the
+            next mouse move is dropped or cancelled by the worker.
+
+  Args:     NONE
+
+  Modifies: [submittedSequence].
+
+  Returns:  VOID
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MainWindow::SubmitHulls()
+{
+    HULL_SCOPE("MainWindow::SubmitHulls");
+    auto snapshot = [](const list<shared_ptr<MyEllipse>>& points, vector<Point2D>& copy)
+    {
+        copy.reserve(points.size());
+        for (auto const& point : points)
+        {
+            copy.push_back(Point2D{ point->ellipse.point.x, point->ellipse.point.y });
+        }
+    };
+
+    HullRequest request;
     switch (algoMode)
     {
-    case AlgoMode::MinkowskiSum:
-        QuickHull(ellipses, convexHull);
-        QuickHull(ellipses2, convexHull2);
-        MinkowskiSum(convexHull, convexHull2, ellipses3);
-        QuickHull(ellipses3, convexHull3);
-        break;
-    case AlgoMode::MinkowskiDifference:
-        QuickHull(ellipses, convexHull);
-        QuickHull(ellipses2, convexHull2);
-        MinkowskiDiff(convexHull, convexHull2, ellipses3);
-        QuickHull(ellipses3, convexHull3);
-        break;
     case AlgoMode::QuickHull:
-        QuickHull(ellipses, convexHull);
+        request.operation = HullOperation::Hull;
+        snapshot(ellipses, request.first);
         break;
     case AlgoMode::PointConvexHullIntersection:
-        QuickHull(ellipses2, convexHull2);
-        if (PointInConvexHull(ellipses.front()->GetVertexPointer(), convexHull2))
-            ellipses.front()->color = D2D1::ColorF(D2D1::ColorF::Red);
-        else
-            ellipses.front()->color = D2D1::ColorF(D2D1::ColorF::Green);
+        request.operation = HullOperation::PointInHull;
+        request.first.push_back(Point2D{ ellipses.front()->ellipse.point.x, ellipses.front()->ellipse.point.y });
+        snapshot(ellipses2, request.second);
+        break;
+    default:
+        request.operation = algoMode == AlgoMode::MinkowskiSum ? HullOperation::MinkowskiSum : HullOperation::MinkowskiDifference;
+        snapshot(ellipses, request.first);
+        snapshot(ellipses2, request.second);
+        request.origin = Point2D{ graphOrigin->ellipse.point.x, graphOrigin->ellipse.point.y };
         break;
-    case AlgoMode::gjk:
-        QuickHull(ellipses, convexHull);
-        QuickHull(ellipses2, convexHull2);
-        MinkowskiDiff(convexHull, convexHull2, ellipses3);
-        QuickHull(ellipses3, convexHull3);
     }
+    submittedSequence = worker.Submit(move(request));
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MainWindow::OnHullResult
+
+  Summary:  Shows the worker's newest result, unless AlgoTest or an
+            earlier message has already shown something newer.
+
+  Args:     NONE
+
+  Modifies: [convexHull, convexHull2, convexHull3, originInside, shownSequence, hullsChanged, hullSnapshots].
+
+  Returns:  VOID
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MainWindow::OnHullResult()
+{
+    const shared_ptr<const HullResult> result = worker.Latest();
+    if (!result || result->sequence <= shownSequence)
+    {
+        return;
+    }
+    shownSequence = result->sequence;
+
+    switch (result->operation)
+    {
+    case HullOperation::Hull:
+        ShowHull(result->hull, convexHull, hullArenas[0]);
+        break;
+    case HullOperation::PointInHull:
+        ShowHull(result->hull2, convexHull2, hullArenas[1]);
+        ellipses.front()->color = D2D1::ColorF(result->inside ? D2D1::ColorF::Red : D2D1::ColorF::Green);
+        break;
+    case HullOperation::MinkowskiSum:
+    case HullOperation::MinkowskiDifference:
+        ShowHull(result->hull, convexHull, hullArenas[0]);
+        ShowHull(result->hull2, convexHull2, hullArenas[1]);
+        ShowHull(result->combined, convexHull3, hullArenas[2]);
+        hullsChanged = hullsChanged || result->inside != (originInside != FALSE);
+        originInside = result->inside;
+        break;
+    }
+    PublishHulls();
+    InvalidateRect(m_hwnd, NULL, FALSE);
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MainWindow::ShowHull
+
+  Summary:  Replaces a displayed hull with vertices from the headless
+            kernel. Those run counter-clockwise in a y-up frame, the
+            other way round from MainWindow::QuickHull's, so they are
+            reversed (keeping the first) for PointInConvexHull.
+
+  Args:     const vector<Point2D>& vertices
+              hull from the worker
+            vector<shared_ptr<D2D_POINT_2F>>& convexHull
+              the displayed hull
+            Arena& vertexArena
+              the arena that holds only this hull's vertices, reset here
+
+  Modifies: [convexHull, vertexArena, hullsChanged].
+
+  Returns:  VOID
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MainWindow::ShowHull(const vector<Point2D>& vertices, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena)
+{
+    convexHull.clear();
+    vertexArena.Reset();
+    const ArenaAllocator<D2D_POINT_2F> vertexAllocator(vertexArena);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const Point2D& p = vertices[(vertices.size() - i) % vertices.size()];
+        convexHull.push_back(allocate_shared<D2D_POINT_2F>(vertexAllocator, D2D1::Point2F((FLOAT)p.x, (FLOAT)p.y)));
+    }
+    hullsChanged = TRUE;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MainWindow::PublishHulls
+
+  Summary:  Publishes copies of the current hulls as a new snapshot
+            for reader threads, if a hull or originInside has changed
+            since the last one. The UI thread is the only writer. It
+            fills in a replaced version that no reader still holds,
+            whose vectors keep their capacity, so once a few versions
+            have grown a publish makes no heap allocations, in keeping
+            with MainWindow::QuickHull.
+
+  Args:     NONE
+
+  Modifies: [hullSnapshots, hullVersion, hullsChanged].
+
+  Returns:  VOID
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MainWindow::PublishHulls()
+{
+    if (!hullsChanged)
+    {
+        return;
+    }
+    hullsChanged = FALSE;
+
+    unique_ptr<HullSnapshot> snapshot = hullSnapshots.Recycle();
+    if (!snapshot)
+    {
+        snapshot.reset(new HullSnapshot);
+    }
+    snapshot->version = ++hullVersion;
+    const auto copy = [](const vector<shared_ptr<D2D_POINT_2F>>& from, vector<D2D1_POINT_2F>& to)
+    {
+        to.clear();
+        to.reserve(from.size());
+        for (const shared_ptr<D2D_POINT_2F>& p : from)
+        {
+            to.push_back(*p);
+        }
+    };
+    copy(convexHull, snapshot->convexHull);
+    copy(convexHull2, snapshot->convexHull2);
+    copy(convexHull3, snapshot->convexHull3);
+    snapshot->originInside = originInside;
+    hullSnapshots.Publish(move(snapshot));
 }
 
 /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
        Function: IsRight
 
-       Summary:  Takes cross product of points a,b,c to determine
-                 if c is to the right of the line formed by a and b.
+       Summary:  Takes the exact sign of the cross product of points
+                 a,b,c to determine if c is to the right of the line
+                 formed by a and b.
 
-       Args:     shared_ptr<D2D_POINT_2F> a
+       Args:     const D2D_POINT_2F& a
                        left most point
-                 shared_ptr<D2D_POINT_2F> b
+                 const D2D_POINT_2F& b
                        right most point
-                 shared_ptr<D2D_POINT_2F> c
+                 const D2D_POINT_2F& c
                        point being checked
 
        Returns:  BOOL
                        true if c is to the right of the line formed by
                        a and b
     -----------------------------------------------------------------F-F*/
-BOOL MainWindow::IsRight(shared_ptr<D2D_POINT_2F> a, shared_ptr<D2D_POINT_2F> b, shared_ptr<D2D_POINT_2F> c)
+BOOL MainWindow::IsRight(const D2D_POINT_2F& a, const D2D_POINT_2F& b, const D2D_POINT_2F& c)
 {
-    return ((b->x - a->x) * (c->y - a->y) - (b->y - a->y) * (c->x - a->x)) > 0;
+    HULL_COUNT(IsRightTests, 1);
+    return Orient2D(a.x, a.y, b.x, b.y, c.x, c.y) > 0;
 }
 
 /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -872,71 +1216,92 @@ BOOL MainWindow::IsRight(shared_ptr<D2D_POINT_2F> a, shared_ptr<D2D_POINT_2F> b,
             and with the farthest and right points and the set of points to the
             left of their line.
 
-  Args:     const list<shared_ptr<MyEllipse>>& points
-              List of points that the convex hull will form around
+            The point sets are index arrays in scratchArena, each one
+            released as soon as the recursion on it returns, and the
+            vertices handed out in convexHull live in vertexArena until
+            the hull is rebuilt, so once the arenas have grown a frame
+            makes no heap allocations.
+
+  Args:     const D2D_POINT_2F* points
+              points that the convex hull will form around
+            size_t count
+              number of points
             list<shared_ptr<D2D_POINT_2F>>& convexHull
               List of vertices that make up the convex hull
+            Arena& vertexArena
+              holds the vertices
 
-  Modifies: [convexHull1,convexHull2].
+  Modifies: [convexHull1,convexHull2,convexHull3].
 
   Returns:  void
-                doesn't return a type, modifies one of the two lists of vertices representing a convex hull
+                doesn't return a type, modifies one of the lists of vertices representing a convex hull
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-void MainWindow::QuickHull(const list<shared_ptr<MyEllipse>>& points, vector<shared_ptr<D2D_POINT_2F>>& convexHull)
+void MainWindow::QuickHull(const D2D_POINT_2F* points, size_t count, vector<shared_ptr<D2D_POINT_2F>>& convexHull, Arena& vertexArena)
 {
-    shared_ptr<D2D_POINT_2F>        left;
-    shared_ptr<D2D_POINT_2F>        right;
+    HULL_SCOPE("MainWindow::QuickHull");
+    if (count == 0)
+    {
+        return;
+    }
+    ArenaScope scope(scratchArena);
+    const ArenaAllocator<D2D_POINT_2F> vertexAllocator(vertexArena);
 
     /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        Function: LineDistance
+        Function: IsFarther
 
-        Summary:  Takes cross product of points a,b,c to determine
-                  verticle distance of c is to the left of the line formed by
-                  a and b.
+        Summary:  Compares the distances of two points right of the line
+                  formed by a and b, exactly, so points only a fraction
+                  of a pixel apart are still told apart.
 
-        Args:     shared_ptr<D2D_POINT_2F> a
+        Args:     const D2D_POINT_2F& a
                         left most point
-                  shared_ptr<D2D_POINT_2F> b
+                  const D2D_POINT_2F& b
                         right most point
-                  shared_ptr<D2D_POINT_2F> c
+                  const D2D_POINT_2F& c
                         point being checked
+                  const D2D_POINT_2F& top
+                        farthest point so far
 
-        Returns:  int
-                        absolute vaue of the verticle distanc of c
-                        from the line formed by a and b
+        Returns:  BOOL
+                        true if c is farther from the line formed by a
+                        and b than top
      -----------------------------------------------------------------F-F*/
-    function<int(shared_ptr<D2D_POINT_2F>, shared_ptr<D2D_POINT_2F>, shared_ptr<D2D_POINT_2F>)> LineDistance = [](shared_ptr<D2D_POINT_2F> a, shared_ptr<D2D_POINT_2F> b, shared_ptr<D2D_POINT_2F> c)->int
+    auto IsFarther = [](const D2D_POINT_2F& a, const D2D_POINT_2F& b, const D2D_POINT_2F& c, const D2D_POINT_2F& top)->BOOL
     {
-        return (int)abs((c->y - a->y) * (b->x - a->x) -
-            (b->y - a->y) * (c->x - a->x));
+        return CrossDifference(a.x, a.y, b.x, b.y, c.x, c.y, top.x, top.y) > 0;
     };
     /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         Function: IsRightList
 
-        Summary:  Scans a list of points to see if they are right of
+        Summary:  Scans a set of points to see if they are right of
                   the line formed by a and b
 
-        Args:     shared_ptr<D2D_POINT_2F> a
+        Args:     uint32_t left
                         left most point
-                  shared_ptr<D2D_POINT_2F> b
+                  uint32_t right
                         right most point
-                  const list<shared_ptr<MyEllipse>>& pointSet
+                  const uint32_t* pointSet, size_t setSize
                         points being checked
+                  size_t& rightSize
+                        receives the number of points right of the line
 
-        Returns:  list<shared_ptr<MyEllipse>
-                        set of  points to the right of line a and b
+        Returns:  uint32_t*
+                        set of points to the right of line a and b, in
+                        scratchArena and trimmed to rightSize
      -----------------------------------------------------------------F-F*/
-    function<list<shared_ptr<MyEllipse>>(shared_ptr<D2D_POINT_2F>, shared_ptr<D2D_POINT_2F>, const list<shared_ptr<MyEllipse>>&)> IsRightList = [&](shared_ptr<D2D_POINT_2F> left, shared_ptr<D2D_POINT_2F> right, const list<shared_ptr<MyEllipse>>& pointSet)->list<shared_ptr<MyEllipse>>
+    auto IsRightList = [&](uint32_t left, uint32_t right, const uint32_t* pointSet, size_t setSize, size_t& rightSize)->uint32_t*
     {
-        list <shared_ptr<MyEllipse>> leftPointSet;
-        for (auto const& point : pointSet)
+        uint32_t* rightPointSet = scratchArena.Allocate<uint32_t>(setSize);
+        rightSize = 0;
+        for (size_t i = 0; i < setSize; i++)
         {
-            if (IsRight(left, right, point->GetVertexPointer()))
+            if (IsRight(points[left], points[right], points[pointSet[i]]))
             {
-                leftPointSet.push_back(point);
+                rightPointSet[rightSize++] = pointSet[i];
             }
         }
-        return leftPointSet;
+        scratchArena.Shrink(rightPointSet, setSize * sizeof(uint32_t), rightSize * sizeof(uint32_t));
+        return rightPointSet;
     };
     /*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         Function: FindHull
@@ -944,144 +1309,179 @@ void MainWindow::QuickHull(const list<shared_ptr<MyEllipse>>& points, vector<sha
         Summary:  Recursive method described in main function header.
                   Finds one side of the convex hull
 
-        Args:     shared_ptr<D2D_POINT_2F> left
+        Args:     uint32_t left
                         left most point
-                  shared_ptr<D2D_POINT_2F> right
+                  uint32_t right
                         right most point
-                  const list<shared_ptr<MyEllipse>>& pointSet
+                  const uint32_t* pointSet, size_t setSize
                         points being checked
 
         Returns:  void
                         base case reached when pointSet is empty
                         right point is added to convex hull
      -----------------------------------------------------------------F-F*/
-    function<void(shared_ptr<D2D_POINT_2F>, shared_ptr<D2D_POINT_2F>, const list<shared_ptr<MyEllipse>>&)> FindHull = [&](shared_ptr<D2D_POINT_2F> left, shared_ptr<D2D_POINT_2F> right, const list<shared_ptr<MyEllipse>>& pointSet)->void
+    auto FindHull = [&](auto& self, uint32_t left, uint32_t right, const uint32_t* pointSet, size_t setSize)->void
     {
-        if (pointSet.empty())
+        HULL_RECURSION(FindHullCalls, FindHullMaxDepth);
+        if (setSize == 0)
         {
-            convexHull.push_back(left);
+            convexHull.push_back(allocate_shared<D2D_POINT_2F>(vertexAllocator, points[left]));
             return;
         }
 
-        shared_ptr<D2D_POINT_2F> top = pointSet.front()->GetVertexPointer();
-        for (auto const& point : pointSet)
+        uint32_t top = pointSet[0];
+        for (size_t i = 0; i < setSize; i++)
         {
-            if (LineDistance(left, right, point->GetVertexPointer()) > LineDistance(left, right, top))
+            if (IsFarther(points[left], points[right], points[pointSet[i]], points[top]))
             {
-                top = point->GetVertexPointer();
+                top = pointSet[i];
             }
         }
-        FindHull(left, top, IsRightList(left, top, pointSet));
-        FindHull(top, right, IsRightList(top, right, pointSet));
-
-    };
-
-
-    left = points.front()->GetVertexPointer();
-    right = points.front()->GetVertexPointer();
-
-    //testing purposes only
-    shared_ptr<MyEllipse>leftPoint = points.front();
-    shared_ptr<MyEllipse>rightPoint = points.front();
-    shared_ptr<MyEllipse>topPoint = points.front();
-    shared_ptr<MyEllipse>bottomPoint = points.front();
-
-
-    for (auto const& point : points) {
-        if (point->ellipse.point.x < left->x)
+        size_t subsetSize;
         {
-            leftPoint = point;
-            left = point->GetVertexPointer();
+            ArenaScope subset(scratchArena);
+            const uint32_t* subsetPoints = IsRightList(left, top, pointSet, setSize, subsetSize);
+            self(self, left, top, subsetPoints, subsetSize);
         }
-        if (point->ellipse.point.x > right->x)
         {
-            rightPoint = point;
-            right = point->GetVertexPointer();
+            ArenaScope subset(scratchArena);
+            const uint32_t* subsetPoints = IsRightList(top, right, pointSet, setSize, subsetSize);
+            self(self, top, right, subsetPoints, subsetSize);
         }
-        if (point->ellipse.point.y < bottomPoint->ellipse.point.y)
+    };
+
+    uint32_t* all = scratchArena.Allocate<uint32_t>(count);
+    uint32_t left = 0;
+    uint32_t right = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        all[i] = i;
+        if (points[i].x < points[left].x)
         {
-            bottomPoint = point;
+            left = i;
         }
-        if (point->ellipse.point.y > topPoint->ellipse.point.y)
+        if (points[i].x > points[right].x)
         {
-            topPoint = point;
+            right = i;
         }
     }
 
-    //leftPoint->color = D2D1::ColorF(D2D1::ColorF::Red);
-    //rightPoint->color = D2D1::ColorF(D2D1::ColorF::Blue);
-    //topPoint->color = D2D1::ColorF(D2D1::ColorF::Red);
-    //bottomPoint->color = D2D1::ColorF(D2D1::ColorF::Blue);
-
-    FindHull(left, right, IsRightList(left, right, points));
-    FindHull(right, left, IsRightList(right, left, points));
+    size_t sideSize;
+    {
+        ArenaScope side(scratchArena);
+        const uint32_t* sidePoints = IsRightList(left, right, all, count, sideSize);
+        FindHull(FindHull, left, right, sidePoints, sideSize);
+    }
+    {
+        ArenaScope side(scratchArena);
+        const uint32_t* sidePoints = IsRightList(right, left, all, count, sideSize);
+        FindHull(FindHull, right, left, sidePoints, sideSize);
+    }
 }
 
-BOOL MainWindow::PointInConvexHull(shared_ptr<D2D_POINT_2F> point, const vector<shared_ptr<D2D_POINT_2F>>& convexHull)
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:    MainWindow::PointInConvexHull
+
+  Summary:  Tests a point against a convex hull in O(log n). The hull
+            is split into a fan of triangles around its first vertex;
+            a binary search over the fan edges finds the one triangle
+            that can hold the point and a last test against its outer
+            edge decides. Points on the boundary count as inside.
+
+  Args:     const D2D_POINT_2F& point
+              point being checked
+            const vector<shared_ptr<D2D_POINT_2F>>& convexHull
+              vertices of the hull, in the order QuickHull produces
+
+  Modifies: [].
+
+  Returns:  BOOL
+              true if point is inside or on the hull
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+BOOL MainWindow::PointInConvexHull(const D2D_POINT_2F& point, const vector<shared_ptr<D2D_POINT_2F>>& convexHull)
 {
-    if (IsRight(convexHull[convexHull.size() - 1], convexHull[0], point))      
+    HULL_COUNT(PointInHullQueries, 1);
+    //> 0 when point is right of a->b, which is outside every edge of the hull
+    auto Side = [&point](const D2D_POINT_2F& a, const D2D_POINT_2F& b)->double
     {
-    /*    OutputDebugStringW(L"Nope\n");*/
-        return FALSE;
-    } 
+        return Orient2D(a.x, a.y, b.x, b.y, point.x, point.y);
+    };
 
-    int left = 0;
-    int right = convexHull.size() - 1;
-    int i = (right + left) / 2;
+    const size_t n = convexHull.size();
+    if (n == 0)
+    {
+        return FALSE;
+    }
+    const D2D_POINT_2F& origin = *convexHull[0];
+    if (n == 1)
+    {
+        return origin.x == point.x && origin.y == point.y;
+    }
+    if (n == 2)
+    {
+        const D2D_POINT_2F& end = *convexHull[1];
+        return Side(origin, end) == 0 &&
+            min(origin.x, end.x) <= point.x && point.x <= max(origin.x, end.x) &&
+            min(origin.y, end.y) <= point.y && point.y <= max(origin.y, end.y);
+    }
 
-    while ((left <= right) && i != 0)
+    //outside the wedge spanned by the two edges at the origin
+    if (Side(origin, *convexHull[1]) > 0 || Side(origin, *convexHull[n - 1]) < 0)
     {
+        return FALSE;
+    }
 
-        /*wchar_t s[256];
-        _swprintf(s, L"current index %d, left %d, right %d, \n", i, left, right);
-        OutputDebugStringW(s);*/
-        if (IsRight(convexHull[i], convexHull[0], point) && !IsRight(convexHull[i + 1], convexHull[0], point))
-            return IsRight(convexHull[i + 1], convexHull[i], point);
-        if (IsRight(convexHull[i], convexHull[0], point))
-            left = i;
+    //the last fan edge the point is not right of
+    size_t low = 1;
+    size_t high = n - 2;
+    while (low < high)
+    {
+        const size_t middle = (low + high + 1) / 2;
+        if (Side(origin, *convexHull[middle]) <= 0)
+        {
+            low = middle;
+        }
         else
-            right = i;
-        
-        i = (right + left) / 2;
-        
+        {
+            high = middle - 1;
+        }
     }
-   /* OutputDebugStringW(L"Touch Grass\n");*/
-    return FALSE;
+    return Side(*convexHull[low], *convexHull[low + 1]) <= 0;
 }
 
 /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
   Method:   MainWindow::MinkowskiSum
 
-  Summary:  Finds the Minkowski Sum of two convex hulls, and puts all of the points generated into a list of MyEllipses.
+  Summary:  Finds the Minkowski Sum of two convex hulls, and puts all of the points generated into points.
             Based on the Minkowski Sum demo from the algorithms for games website.
 
   Args:     vector<shared_ptr<D2D_POINT_2F>>& convexHull
               List of vertices that make up the first convex hull
             vector<shared_ptr<D2D_POINT_2F>>& convexHull2
               List of vertices that make up the second convex hull
-            list<shared_ptr<MyEllipse>>& points
-              List of vertices that make up the resulting convex hull
+            ArenaVector<D2D_POINT_2F>& points
+              the n * m pairwise sums, in the arena the caller gave it
 
   Modifies: [points].
 
   Returns:  void
-                doesn't return a type, modifies a convex hull to represent the Minkowski sum of two other convex hulls
+                doesn't return a type, fills points with the Minkowski sum of two other convex hulls
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-void MainWindow::MinkowskiSum(const vector<shared_ptr<D2D_POINT_2F>>& convexHull,const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, list<shared_ptr<MyEllipse>>& points)
+void MainWindow::MinkowskiSum(const vector<shared_ptr<D2D_POINT_2F>>& convexHull, const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, ArenaVector<D2D_POINT_2F>& points)
 {
+    HULL_SCOPE("MainWindow::MinkowskiSum");
+    HULL_COUNT(MinkowskiPoints, convexHull.size() * convexHull2.size());
+    points.reserve(points.size() + convexHull.size() * convexHull2.size());
     for (std::size_t i = 0; i < convexHull.size(); i++)
     {
-        shared_ptr<D2D_POINT_2F> point1 = convexHull[i];
+        const D2D_POINT_2F& point1 = *convexHull[i];
         for (std::size_t j = 0; j < convexHull2.size(); j++)
         {
 
-            shared_ptr<D2D_POINT_2F> point2 = convexHull2[j];
-            float x = point1->x + point2->x - graphOrigin->ellipse.point.x;
-            float y = point1->y + point2->y - graphOrigin->ellipse.point.y;
-            std::shared_ptr<MyEllipse> newEllipse = std::make_shared<MyEllipse>();
-            newEllipse->ellipse = D2D1::Ellipse(D2D1::Point2F(x, y), VERTEX_RADIUS, VERTEX_RADIUS);
-            newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-            points.push_back(newEllipse);
+            const D2D_POINT_2F& point2 = *convexHull2[j];
+            float x = point1.x + point2.x - graphOrigin->ellipse.point.x;
+            float y = point1.y + point2.y - graphOrigin->ellipse.point.y;
+            points.push_back(D2D1::Point2F(x, y));
         }
     }
 }
@@ -1089,35 +1489,35 @@ void MainWindow::MinkowskiSum(const vector<shared_ptr<D2D_POINT_2F>>& convexHull
 /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
   Method:   MainWindow::MinkowskiDiff
 
-  Summary:  Finds the Minkowski Difference of two convex hulls, and puts all of the points generated into a list of MyEllipses.
+  Summary:  Finds the Minkowski Difference of two convex hulls, and puts all of the points generated into points.
             Based on the Minkowski Difference demo from the algorithms for games website.
 
   Args:     vector<shared_ptr<D2D_POINT_2F>>& convexHull
               List of vertices that make up the first convex hull
             vector<shared_ptr<D2D_POINT_2F>>& convexHull2
               List of vertices that make up the second convex hull
-            list<shared_ptr<MyEllipse>>& points
-              List of vertices that make up the resulting convex hull
+            ArenaVector<D2D_POINT_2F>& points
+              the n * m pairwise differences, in the arena the caller gave it
 
   Modifies: [points].
 
   Returns:  void
-                doesn't return a type, modifies a convex hull to represent the Minkowski difference of two other convex hulls
+                doesn't return a type, fills points with the Minkowski difference of two other convex hulls
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-void MainWindow::MinkowskiDiff(const vector<shared_ptr<D2D_POINT_2F>>& convexHull,const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, list<shared_ptr<MyEllipse>>& points)
+void MainWindow::MinkowskiDiff(const vector<shared_ptr<D2D_POINT_2F>>& convexHull, const vector<shared_ptr<D2D_POINT_2F>>& convexHull2, ArenaVector<D2D_POINT_2F>& points)
 {
+    HULL_SCOPE("MainWindow::MinkowskiDiff");
+    HULL_COUNT(MinkowskiPoints, convexHull.size() * convexHull2.size());
+    points.reserve(points.size() + convexHull.size() * convexHull2.size());
     for (std::size_t i = 0; i < convexHull.size(); i++)
     {
-        shared_ptr<D2D_POINT_2F> point1 = convexHull[i];
+        const D2D_POINT_2F& point1 = *convexHull[i];
         for (std::size_t j = 0; j < convexHull2.size(); j++)
         {
-            shared_ptr<D2D_POINT_2F> point2 = convexHull2[j];
-            float x = point1->x - point2->x + graphOrigin->ellipse.point.x;
-            float y = point1->y - point2->y + graphOrigin->ellipse.point.y;
-            std::shared_ptr<MyEllipse> newEllipse = std::make_shared<MyEllipse>();
-            newEllipse->ellipse = D2D1::Ellipse(D2D1::Point2F(x, y), VERTEX_RADIUS, VERTEX_RADIUS);
-            newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-            points.push_back(newEllipse);
+            const D2D_POINT_2F& point2 = *convexHull2[j];
+            float x = point1.x - point2.x + graphOrigin->ellipse.point.x;
+            float y = point1.y - point2.y + graphOrigin->ellipse.point.y;
+            points.push_back(D2D1::Point2F(x, y));
         }
     }
 }
@@ -1158,6 +1558,8 @@ void MainWindow::MoveSelection(float x, float y)
     {
         Selection()->ellipse.point.x += x;
         Selection()->ellipse.point.y += y;
+        pipeline.Touch(selection1 ? pointsNode : points2Node);
+        AlgoTest();
         InvalidateRect(m_hwnd, NULL, FALSE);
     }
 }
@@ -1370,6 +1772,10 @@ LRESULT MainWindow::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
         return 0;
 
     case WM_DESTROY:
+#ifdef HULL_INSTRUMENT
+        Instrument::WriteChromeTrace("hulltrace.json");
+        OutputDebugStringA(Instrument::SummaryTable().c_str());
+#endif
         DiscardGraphicsResources();
         SafeRelease(&pFactory);
         PostQuitMessage(0);
@@ -1383,6 +1789,10 @@ LRESULT MainWindow::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
         Resize();
         return 0;
 
+    case WM_HULL_RESULT:
+        OnHullResult();
+        return 0;
+
     case WM_LBUTTONDOWN:
         OnLButtonDown(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), (DWORD)wParam);
         return 0;
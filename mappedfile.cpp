@@ -0,0 +1,220 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    uint64_t Granularity()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        return (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    const intptr_t NoHandle = -1;
+}
+
+MappedView::MappedView(MappedView&& other) : base(other.base), data(other.data),
+    length(other.length), mappedLength(other.mappedLength)
+{
+    other.base = nullptr;
+    other.data = nullptr;
+    other.length = other.mappedLength = 0;
+}
+
+MappedView& MappedView::operator=(MappedView&& other)
+{
+    if (this != &other)
+    {
+        Release();
+        base = other.base;
+        data = other.data;
+        length = other.length;
+        mappedLength = other.mappedLength;
+        other.base = nullptr;
+        other.data = nullptr;
+        other.length = other.mappedLength = 0;
+    }
+    return *this;
+}
+
+MappedView::~MappedView()
+{
+    Release();
+}
+
+void MappedView::Release()
+{
+    if (base)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(base, mappedLength);
+#endif
+    }
+    base = nullptr;
+    data = nullptr;
+    length = mappedLength = 0;
+}
+
+MappedFile::MappedFile() : size(0), file(NoHandle), mapping(NoHandle)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::IsOpen() const
+{
+    return file != NoHandle;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MappedFile::Open
+
+  Summary:  Opens a file for read-only mapping. Nothing is mapped yet.
+
+  Args:     const string& path
+              file to open
+
+  Modifies: [size, file, mapping].
+
+  Returns:  bool
+              false if the file cannot be opened or mapped
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool MappedFile::Open(const string& path)
+{
+    Close();
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (h == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(h, &fileSize))
+    {
+        CloseHandle(h);
+        return false;
+    }
+    size = (uint64_t)fileSize.QuadPart;
+    file = (intptr_t)h;
+    if (size != 0)
+    {
+        HANDLE m = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m == NULL)
+        {
+            Close();
+            return false;
+        }
+        mapping = (intptr_t)m;
+    }
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    size = (uint64_t)info.st_size;
+    file = fd;
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (mapping != NoHandle)
+    {
+        CloseHandle((HANDLE)mapping);
+    }
+    if (file != NoHandle)
+    {
+        CloseHandle((HANDLE)file);
+    }
+#else
+    if (file != NoHandle)
+    {
+        close((int)file);
+    }
+#endif
+    mapping = file = NoHandle;
+    size = 0;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MappedFile::Map
+
+  Summary:  Maps [offset, offset + length) of the file read-only. The
+            mapping itself starts on the OS granularity below offset;
+            Data() points at offset. The range is clipped to the file.
+
+  Args:     uint64_t offset
+              first byte wanted
+            size_t length
+              number of bytes wanted
+
+  Returns:  MappedView
+              invalid view (Valid() == false) on failure or for an
+              empty range
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+MappedView MappedFile::Map(uint64_t offset, size_t length) const
+{
+    MappedView view;
+    if (!IsOpen() || offset >= size || length == 0)
+    {
+        return view;
+    }
+    if (length > size - offset)
+    {
+        length = (size_t)(size - offset);
+    }
+
+    const uint64_t granularity = Granularity();
+    const uint64_t start = offset - offset % granularity;
+    const size_t mappedLength = (size_t)(offset - start) + length;
+
+#ifdef _WIN32
+    void* base = MapViewOfFile((HANDLE)mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)(start & 0xFFFFFFFFu), mappedLength);
+    if (base == NULL)
+    {
+        return view;
+    }
+#else
+    void* base = mmap(nullptr, mappedLength, PROT_READ, MAP_PRIVATE, (int)file, (off_t)start);
+    if (base == MAP_FAILED)
+    {
+        return view;
+    }
+    madvise(base, mappedLength, MADV_SEQUENTIAL);
+#endif
+
+    view.base = base;
+    view.data = (const uint8_t*)base + (offset - start);
+    view.length = length;
+    view.mappedLength = mappedLength;
+    return view;
+}
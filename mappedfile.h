@@ -0,0 +1,71 @@
+#ifndef _MAPPEDFILE_H
+#define _MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    MappedView
+
+  Summary:  One read-only mapped range of a MappedFile. Unmaps itself
+            when destroyed, so the pages it touched can be dropped and
+            peak memory stays at the size of the live views.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class MappedView
+{
+public:
+    MappedView() : base(nullptr), data(nullptr), length(0), mappedLength(0) { }
+    MappedView(MappedView&& other);
+    MappedView& operator=(MappedView&& other);
+    ~MappedView();
+
+    MappedView(const MappedView&) = delete;
+    MappedView& operator=(const MappedView&) = delete;
+
+    const uint8_t* Data() const { return data; }
+    size_t         Size() const { return length; }
+    bool           Valid() const { return data != nullptr; }
+
+private:
+    friend class MappedFile;
+    void Release();
+
+    void*          base;
+    const uint8_t* data;
+    size_t         length;
+    size_t         mappedLength;
+};
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    MappedFile
+
+  Summary:  Read-only memory mapping of a file, POSIX mmap or Win32
+            file mapping. Large files are mapped a range at a time
+            with Map(); MapAll() is for files that fit the address
+            space. windows.h stays inside mappedfile.cpp.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool       Open(const std::string& path);
+    void       Close();
+    bool       IsOpen() const;
+    uint64_t   Size() const { return size; }
+
+    MappedView Map(uint64_t offset, size_t length) const;
+    MappedView MapAll() const { return Map(0, (size_t)size); }
+
+private:
+    uint64_t   size;
+    intptr_t   file;
+    intptr_t   mapping;
+};
+
+#endif
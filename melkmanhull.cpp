@@ -0,0 +1,213 @@
+#include "melkmanhull.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+    bool Less(const Point2D& a, const Point2D& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    }
+}
+
+MelkmanHull::MelkmanHull(bool verify) : verify(verify), fellBack(false), started(false),
+    prefixMin(), prefixMax(), boxMin(), boxMax(), hullValid(false)
+{
+}
+
+void MelkmanHull::Clear()
+{
+    fellBack = false;
+    started = false;
+    hullDeque.clear();
+    points.clear();
+    hull.clear();
+    hullValid = false;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MelkmanHull::Start
+
+  Summary:  Seeds the deque with the first point that is not collinear
+            with the prefix read so far. The hull at that point is the
+            triangle of the two prefix extremes and p.
+
+  Args:     const Point2D& p
+              first non collinear point
+
+  Modifies: [hullDeque, started].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MelkmanHull::Start(const Point2D& p)
+{
+    hullDeque.clear();
+    hullDeque.push_back(p);
+    if (Orientation(prefixMin, prefixMax, p) > 0)
+    {
+        hullDeque.push_back(prefixMin);
+        hullDeque.push_back(prefixMax);
+    }
+    else
+    {
+        hullDeque.push_back(prefixMax);
+        hullDeque.push_back(prefixMin);
+    }
+    hullDeque.push_back(p);
+    started = true;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MelkmanHull::InsideHull
+
+  Summary:  Exact point in convex polygon test on the deque, boundary
+            included. Binary search over the fan from the first vertex.
+
+  Returns:  bool
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool MelkmanHull::InsideHull(const Point2D& p) const
+{
+    const size_t m = hullDeque.size() - 1;
+    const Point2D& o = hullDeque[0];
+    if (Orientation(o, hullDeque[1], p) < 0 || Orientation(o, hullDeque[m - 1], p) > 0)
+    {
+        return false;
+    }
+    size_t lo = 1;
+    size_t hi = m - 2;
+    while (lo < hi)
+    {
+        const size_t mid = (lo + hi + 1) / 2;
+        if (Orientation(o, hullDeque[mid], p) >= 0)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    return Orientation(hullDeque[lo], hullDeque[lo + 1], p) >= 0;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MelkmanHull::Push
+
+  Summary:  Consumes the next vertex of the polyline. If p is on or
+            inside both edges next to the last hull vertex it is
+            skipped; otherwise reflex vertices are popped from both
+            ends of the deque and p is pushed onto both.
+
+  Args:     const Point2D& p
+              next polyline vertex
+
+  Modifies: [hullDeque, points, fellBack].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void MelkmanHull::Push(const Point2D& p)
+{
+    points.push_back(p);
+    hullValid = false;
+
+    if (points.size() == 1)
+    {
+        prefixMin = prefixMax = boxMin = boxMax = p;
+        return;
+    }
+    const bool outsideBox = p.x < boxMin.x || p.y < boxMin.y || p.x > boxMax.x || p.y > boxMax.y;
+    boxMin = Point2D{ min(boxMin.x, p.x), min(boxMin.y, p.y) };
+    boxMax = Point2D{ max(boxMax.x, p.x), max(boxMax.y, p.y) };
+    if (fellBack)
+    {
+        return;
+    }
+
+    if (!started)
+    {
+        if (Orientation(prefixMin, prefixMax, p) == 0)
+        {
+            if (Less(p, prefixMin))
+            {
+                prefixMin = p;
+            }
+            if (Less(prefixMax, p))
+            {
+                prefixMax = p;
+            }
+            return;
+        }
+        Start(p);
+        return;
+    }
+
+    const size_t t = hullDeque.size() - 1;
+    if (Orientation(hullDeque[t - 1], hullDeque[t], p) >= 0 && Orientation(hullDeque[0], hullDeque[1], p) >= 0)
+    {
+        // A point outside the box cannot be inside the hull; the exact
+        // check catches the rest.
+        if (outsideBox || (verify && !InsideHull(p)))
+        {
+            fellBack = true;
+            hullDeque.clear();
+        }
+        return;
+    }
+
+    while (hullDeque.size() > 2 && Orientation(hullDeque[hullDeque.size() - 2], hullDeque.back(), p) <= 0)
+    {
+        hullDeque.pop_back();
+    }
+    hullDeque.push_back(p);
+    while (hullDeque.size() > 2 && Orientation(p, hullDeque[0], hullDeque[1]) <= 0)
+    {
+        hullDeque.pop_front();
+    }
+    hullDeque.push_front(p);
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   MelkmanHull::Hull
+
+  Summary:  Hull of every point pushed so far. Straight from the deque
+            while the input is simple, QuickHull over the retained
+            points after a fallback.
+
+  Returns:  const vector<Point2D>&
+              hull vertices, counter-clockwise from the left most
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+const vector<Point2D>& MelkmanHull::Hull()
+{
+    if (hullValid)
+    {
+        return hull;
+    }
+    hull.clear();
+    if (fellBack)
+    {
+        vector<uint32_t> index;
+        QuickHull(points, index);
+        for (uint32_t i : index)
+        {
+            hull.push_back(points[i]);
+        }
+    }
+    else if (started)
+    {
+        hull.assign(hullDeque.begin(), hullDeque.end() - 1);
+        //from the left most vertex, as QuickHull and the fallback give it
+        rotate(hull.begin(), min_element(hull.begin(), hull.end(), Less), hull.end());
+    }
+    else if (!points.empty())
+    {
+        hull.push_back(prefixMin);
+        if (Less(prefixMin, prefixMax))
+        {
+            hull.push_back(prefixMax);
+        }
+    }
+    hullValid = true;
+    return hull;
+}
@@ -0,0 +1,71 @@
+#ifndef _MELKMANHULL_H
+#define _MELKMANHULL_H
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "geometry.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    MelkmanHull
+
+  Summary:  Online hull of a simple polyline fed in vertex order
+            (Melkman's deque algorithm). Each point costs O(1)
+            amortized and the hull of the prefix read so far can be
+            read at any time.
+
+            Melkman's algorithm is only correct for simple polylines,
+            and it can only go wrong one way: a point outside the hull
+            that sees neither edge next to the last vertex gets skipped
+            as if it were inside. Every skipped point is therefore
+            checked: always against the bounding box (O(1)) and, when
+            verify is on, exactly against the hull (O(log h)). On the
+            first failed check the input is known not to be a simple
+            polyline and the hull falls back to QuickHull over every
+            point read, which is why the input points are retained.
+
+            With verify off only the box check is left, so on a
+            polyline that crosses itself a point inside the box but
+            outside the hull is dropped and the hull comes out WRONG,
+            without a fallback. Turn verify off only for input known
+            to be simple.
+
+  Methods:  Push
+              Consumes the next polyline vertex.
+            Hull
+              Hull of everything pushed so far, counter-clockwise
+              from the left most vertex.
+            FellBack
+              True once the input was found not to be simple.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class MelkmanHull
+{
+public:
+    explicit MelkmanHull(bool verify = true);
+
+    void Push(const Point2D& p);
+    void Clear();
+
+    const std::vector<Point2D>& Hull();
+    bool   FellBack() const { return fellBack; }
+    size_t Size() const { return points.size(); }
+
+private:
+    void Start(const Point2D& p);
+    bool InsideHull(const Point2D& p) const;
+
+    bool                    verify;
+    bool                    fellBack;
+    bool                    started;
+    std::deque<Point2D>     hullDeque;  // front and back are both the last hull vertex
+    std::vector<Point2D>    points;     // every input point, for the fallback
+    Point2D                 prefixMin;  // extremes of a collinear prefix
+    Point2D                 prefixMax;
+    Point2D                 boxMin;
+    Point2D                 boxMax;
+    std::vector<Point2D>    hull;
+    bool                    hullValid;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "outofcorehull.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "mappedfile.h"
+
+using namespace std;
+
+namespace
+{
+    //partial hull vertices a worker collects before folding them into a smaller set
+    const size_t PartialLimit = 1 << 16;
+
+    void FoldHull(vector<Point2D>& points, vector<uint32_t>& index)
+    {
+        QuickHull(points, index);
+        vector<Point2D> hull;
+        hull.reserve(index.size());
+        for (uint32_t i : index)
+        {
+            hull.push_back(points[i]);
+        }
+        points.swap(hull);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: OutOfCoreHull
+
+    Summary:  Convex hull of a flat binary file of x, y pairs that does
+              not have to fit in memory. Workers claim chunks of the
+              file, map just that range, hull it in place and unmap it,
+              keeping only the hull vertices. Double files are hulled
+              straight out of the mapping; float files are widened into
+              a per worker buffer of one chunk. The partial hulls are
+              merged with one last QuickHull.
+
+              Peak memory is about chunkPoints * 16 bytes * threads
+              plus the partial hulls.
+
+    Args:     const string& path
+                file to read
+              const OutOfCoreOptions& options
+                format, header size, chunk size and thread count
+              OutOfCoreResult& result
+                hull, point count, timing and throughput
+
+    Modifies: [result].
+
+    Returns:  bool
+                false if the file cannot be opened or mapped, or the
+                header is not aligned to the scalar size
+-----------------------------------------------------------------F-F*/
+bool OutOfCoreHull(const string& path, const OutOfCoreOptions& options, OutOfCoreResult& result)
+{
+    const auto start = chrono::steady_clock::now();
+    result = OutOfCoreResult();
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        return false;
+    }
+
+    const size_t scalarSize = options.format == PointFormat::Float32 ? sizeof(float) : sizeof(double);
+    const size_t pairSize = 2 * scalarSize;
+    if (options.headerBytes % scalarSize != 0 || options.headerBytes > file.Size())
+    {
+        return false;
+    }
+
+    const uint64_t pointCount = (file.Size() - options.headerBytes) / pairSize;
+    const size_t chunkPoints = max<size_t>(options.chunkPoints, 1);
+    const uint64_t chunkCount = (pointCount + chunkPoints - 1) / chunkPoints;
+    unsigned threadCount = options.threads ? options.threads : thread::hardware_concurrency();
+    threadCount = (unsigned)max<uint64_t>(1, min<uint64_t>(max(threadCount, 1u), chunkCount));
+
+    atomic<uint64_t> nextChunk(0);
+    atomic<bool> failed(false);
+    vector<vector<Point2D>> partials(threadCount);
+
+    auto worker = [&](unsigned id)
+    {
+        vector<Point2D>& partial = partials[id];
+        vector<Point2D> widened;
+        vector<uint32_t> index;
+
+        for (uint64_t chunk = nextChunk++; chunk < chunkCount && !failed; chunk = nextChunk++)
+        {
+            const uint64_t first = chunk * chunkPoints;
+            const size_t count = (size_t)min<uint64_t>(chunkPoints, pointCount - first);
+            MappedView view = file.Map(options.headerBytes + first * pairSize, count * pairSize);
+            if (!view.Valid())
+            {
+                failed = true;
+                break;
+            }
+
+            PointSpan span;
+            if (options.format == PointFormat::Float64)
+            {
+                const double* xy = reinterpret_cast<const double*>(view.Data());
+                span = PointSpan{ xy, xy + 1, count, 2 };
+            }
+            else
+            {
+                widened.resize(count);
+                const float* xy = reinterpret_cast<const float*>(view.Data());
+                for (size_t i = 0; i < count; i++)
+                {
+                    widened[i] = Point2D{ xy[2 * i], xy[2 * i + 1] };
+                }
+                span = MakePointSpan(widened.data(), count);
+            }
+
+            QuickHull(span, index);
+            for (uint32_t i : index)
+            {
+                partial.push_back(span[i]);
+            }
+            if (partial.size() > PartialLimit)
+            {
+                FoldHull(partial, index);
+            }
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        pool.emplace_back(worker, i);
+    }
+    if (chunkCount > 0)
+    {
+        worker(0);
+    }
+    for (auto& t : pool)
+    {
+        t.join();
+    }
+    if (failed)
+    {
+        return false;
+    }
+
+    vector<Point2D> merged;
+    for (auto const& partial : partials)
+    {
+        merged.insert(merged.end(), partial.begin(), partial.end());
+    }
+    vector<uint32_t> index;
+    FoldHull(merged, index);
+
+    result.hull.swap(merged);
+    result.points = pointCount;
+    result.chunks = (size_t)chunkCount;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.pointsPerSecond = result.seconds > 0 ? pointCount / result.seconds : 0;
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef _OUTOFCOREHULL_H
+#define _OUTOFCOREHULL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "geometry.h"
+
+//scalar type of a flat binary file of interleaved x, y pairs
+enum class PointFormat
+{
+    Float32,
+    Float64
+};
+
+struct OutOfCoreOptions
+{
+    PointFormat format = PointFormat::Float64;
+    uint64_t    headerBytes = 0;        // bytes to skip before the first pair
+    size_t      chunkPoints = 1 << 22;  // points mapped per chunk
+    unsigned    threads = 0;            // 0 = hardware concurrency
+};
+
+struct OutOfCoreResult
+{
+    std::vector<Point2D> hull;          // counter-clockwise from the left most point
+    uint64_t             points = 0;
+    size_t               chunks = 0;
+    double               seconds = 0;
+    double               pointsPerSecond = 0;
+};
+
+bool OutOfCoreHull(const std::string& path, const OutOfCoreOptions& options, OutOfCoreResult& result);
+
+#endif
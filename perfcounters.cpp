@@ -0,0 +1,186 @@
+#include "perfcounters.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    const char* const EventNames[] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+
+#ifdef __linux__
+    struct EventConfig
+    {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    const EventConfig Events[] =
+    {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+    };
+
+    //this thread, any cpu, user space only so perf_event_paranoid 2 still allows it
+    int OpenEvent(const EventConfig& event)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+const char* PerfEventName(PerfEvent event)
+{
+    return event < PerfEvent::Count ? EventNames[(unsigned)event] : "";
+}
+
+PerfCounters::PerfCounters()
+{
+    for (int& fd : fds)
+    {
+        fd = -1;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    Close();
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   PerfCounters::Open
+
+  Summary:  Opens every event the kernel lets this thread count and
+            records why the others failed.
+
+  Args:
+
+  Modifies: [fds, error].
+
+  Returns:  size_t
+              number of events that opened, 0 if counters are not
+              available at all
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M*/
+size_t PerfCounters::Open()
+{
+    Close();
+    size_t opened = 0;
+#ifdef __linux__
+    for (unsigned i = 0; i < (unsigned)PerfEvent::Count; i++)
+    {
+        fds[i] = OpenEvent(Events[i]);
+        if (fds[i] >= 0)
+        {
+            opened++;
+        }
+        else
+        {
+            error += string(error.empty() ? "" : ", ") + EventNames[i] + ": " + strerror(errno);
+        }
+    }
+#else
+    error = "hardware counters need Linux perf_event_open";
+#endif
+    return opened;
+}
+
+void PerfCounters::Close()
+{
+    for (int& fd : fds)
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+#endif
+        fd = -1;
+    }
+    error.clear();
+}
+
+bool PerfCounters::Available() const
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::Start()
+{
+#ifdef __linux__
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   PerfCounters::Stop
+
+  Summary:  Disables the counters and reads them. When the kernel had
+            more events than hardware counters it time slices them;
+            such counts are scaled by enabled / running time, and an
+            event that never got a counter is reported as unavailable.
+
+  Args:
+
+  Modifies: [].
+
+  Returns:  PerfSample
+              the counts since Start()
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M*/
+PerfSample PerfCounters::Stop()
+{
+    PerfSample sample;
+#ifdef __linux__
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (unsigned i = 0; i < (unsigned)PerfEvent::Count; i++)
+    {
+        //value, time enabled, time running
+        uint64_t counts[3];
+        if (fds[i] < 0 || read(fds[i], counts, sizeof(counts)) != (ssize_t)sizeof(counts) || counts[2] == 0)
+        {
+            continue;
+        }
+        sample.values[i] = counts[2] < counts[1] ? (uint64_t)((double)counts[0] * counts[1] / counts[2]) : counts[0];
+        sample.valid[i] = true;
+    }
+#endif
+    return sample;
+}
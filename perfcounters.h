@@ -0,0 +1,75 @@
+#ifndef _PERFCOUNTERS_H
+#define _PERFCOUNTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*--------------------------------------------------------------------
+    Hardware performance counters for the benchmark harness, read
+    through Linux perf_event_open for the calling thread only.
+
+    Every event is opened on its own rather than as one group, so a
+    machine or container that lacks one of them (LLC misses under
+    many hypervisors, or everything when perf_event_paranoid forbids
+    it) still reports the others. An event that cannot be opened reads
+    as unavailable, never as zero. On other platforms every event is
+    unavailable and Start() / Stop() do nothing.
+--------------------------------------------------------------------*/
+
+enum class PerfEvent : unsigned
+{
+    Cycles,
+    Instructions,
+    L1DataMisses,       // L1 data cache read misses
+    LastLevelMisses,    // last level cache misses
+    BranchMisses,
+    Count
+};
+
+const char* PerfEventName(PerfEvent event);
+
+struct PerfSample
+{
+    //counts scaled up when the kernel multiplexed an event, valid[i] false if event i was not counted
+    uint64_t values[(unsigned)PerfEvent::Count] = {};
+    bool     valid[(unsigned)PerfEvent::Count] = {};
+
+    bool     Has(PerfEvent event) const { return valid[(unsigned)event]; }
+    uint64_t operator[](PerfEvent event) const { return values[(unsigned)event]; }
+};
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    PerfCounters
+
+  Summary:  One set of user space counters for the thread that opened
+            it. Start() resets and enables them, Stop() disables them
+            and reads what was counted in between.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    //opens what it can and returns the number of events that opened
+    size_t      Open();
+    void        Close();
+    bool        Available() const;
+    bool        Available(PerfEvent event) const { return fds[(unsigned)event] >= 0; }
+
+    //why the events that are not available failed to open, empty if all opened
+    std::string Error() const { return error; }
+
+    void        Start();
+    PerfSample  Stop();
+
+private:
+    int         fds[(unsigned)PerfEvent::Count];
+    std::string error;
+};
+
+#endif
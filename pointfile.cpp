@@ -0,0 +1,245 @@
+#include "pointfile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    const char   Magic[4] = { 'C', 'H', 'P', 'F' };
+    const size_t SectionAlignment = 64;
+
+    uint64_t AlignUp(uint64_t offset)
+    {
+        return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+    }
+
+    //writes through a small buffer and keeps the running checksum
+    class SectionWriter
+    {
+    public:
+        SectionWriter(FILE* file) : file(file), offset(sizeof(PointFileHeader)), hash(Fnv1a64(nullptr, 0)), ok(true) { }
+
+        void Write(const void* data, size_t length)
+        {
+            hash = Fnv1a64(data, length, hash);
+            ok = ok && fwrite(data, 1, length, file) == length;
+            offset += length;
+        }
+
+        void PadTo(uint64_t target)
+        {
+            static const uint8_t zeros[SectionAlignment] = {};
+            while (offset < target)
+            {
+                Write(zeros, (size_t)min<uint64_t>(target - offset, SectionAlignment));
+            }
+        }
+
+        FILE*    file;
+        uint64_t offset;
+        uint64_t hash;
+        bool     ok;
+    };
+}
+
+uint64_t Fnv1a64(const void* data, size_t length, uint64_t hash)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: WritePointFile
+
+    Summary:  Writes points (and optionally their hull) as a .chp file.
+              The span may be any layout; values are gathered into the
+              x and y sections a block at a time.
+
+    Args:     const string& path
+                file to create
+              PointFileKind kind
+                what the file holds
+              const PointSpan& points
+                point data
+              const uint32_t* hull, size_t hullCount
+                hull vertices as indices into points, may be empty
+              bool checksum
+                store an FNV-1a 64 checksum of the payload
+
+    Returns:  bool
+                false on any I/O error
+-----------------------------------------------------------------F-F*/
+bool WritePointFile(const string& path, PointFileKind kind, const PointSpan& points,
+    const uint32_t* hull, size_t hullCount, bool checksum)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    PointFileHeader header = {};
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = POINTFILE_VERSION;
+    header.kind = (uint16_t)kind;
+    header.flags = checksum ? (uint32_t)PointFileHasChecksum : 0u;
+    header.pointCount = points.count;
+    header.indexCount = hull ? hullCount : 0;
+    header.xOffset = AlignUp(sizeof(PointFileHeader));
+    header.yOffset = AlignUp(header.xOffset + points.count * sizeof(double));
+    header.indexOffset = AlignUp(header.yOffset + points.count * sizeof(double));
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    SectionWriter writer(file);
+    vector<double> block;
+    block.reserve(4096);
+    for (int axis = 0; axis < 2 && ok; axis++)
+    {
+        const double* values = axis == 0 ? points.x : points.y;
+        writer.PadTo(axis == 0 ? header.xOffset : header.yOffset);
+        for (size_t i = 0; i < points.count; i += block.capacity())
+        {
+            const size_t end = min(points.count, i + block.capacity());
+            block.clear();
+            for (size_t j = i; j < end; j++)
+            {
+                block.push_back(values[j * points.stride]);
+            }
+            writer.Write(block.data(), block.size() * sizeof(double));
+        }
+    }
+    writer.PadTo(header.indexOffset);
+    if (header.indexCount)
+    {
+        writer.Write(hull, (size_t)header.indexCount * sizeof(uint32_t));
+    }
+    ok = ok && writer.ok;
+
+    if (checksum && ok)
+    {
+        header.checksum = writer.hash;
+        rewind(file);
+        ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+bool IsPointFile(const string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+    char magic[sizeof(Magic)];
+    const bool found = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, Magic, sizeof(Magic)) == 0;
+    fclose(file);
+    return found;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   PointFile::Open
+
+  Summary:  Maps a .chp file and checks its header: magic, version,
+            kind, a point count that uint32_t indices can address,
+            and that every section is aligned and inside the file.
+            The hull indices, when there are any, must all name a
+            point; that is the only check that reads the payload
+            without verifyChecksum.
+
+  Args:     const string& path
+              file to open
+            bool verifyChecksum
+              also hash the payload and compare it with the header
+
+  Modifies: [file, view, header].
+
+  Returns:  bool
+              false if the file is missing, malformed or corrupt
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool PointFile::Open(const string& path, bool verifyChecksum)
+{
+    Close();
+    if (!file.Open(path) || file.Size() < sizeof(PointFileHeader))
+    {
+        Close();
+        return false;
+    }
+    view = file.MapAll();
+    if (!view.Valid())
+    {
+        Close();
+        return false;
+    }
+    memcpy(&header, view.Data(), sizeof(header));
+
+    const uint64_t size = file.Size();
+    const uint64_t maxCount = size / sizeof(double);
+    bool ok = memcmp(header.magic, Magic, sizeof(Magic)) == 0
+        && header.version == POINTFILE_VERSION
+        && header.kind >= (uint16_t)PointFileKind::PointSet && header.kind <= (uint16_t)PointFileKind::Minkowski
+        && header.pointCount <= maxCount
+        && header.pointCount <= UINT32_MAX
+        && header.indexCount <= size / sizeof(uint32_t)
+        && header.xOffset % SectionAlignment == 0
+        && header.yOffset % SectionAlignment == 0
+        && header.indexOffset % SectionAlignment == 0
+        && header.xOffset >= sizeof(PointFileHeader)
+        && header.xOffset <= size && header.pointCount * sizeof(double) <= size - header.xOffset
+        && header.yOffset <= size && header.pointCount * sizeof(double) <= size - header.yOffset
+        && header.indexOffset <= size && header.indexCount * sizeof(uint32_t) <= size - header.indexOffset;
+
+    if (ok && header.indexCount)
+    {
+        const uint32_t* hull = reinterpret_cast<const uint32_t*>(view.Data() + header.indexOffset);
+        for (uint64_t i = 0; i < header.indexCount && ok; i++)
+        {
+            ok = hull[i] < header.pointCount;
+        }
+    }
+    if (ok && verifyChecksum && (header.flags & PointFileHasChecksum))
+    {
+        ok = Fnv1a64(view.Data() + sizeof(header), view.Size() - sizeof(header)) == header.checksum;
+    }
+    if (!ok)
+    {
+        Close();
+    }
+    return ok;
+}
+
+void PointFile::Close()
+{
+    view = MappedView();
+    file.Close();
+    header = PointFileHeader();
+}
+
+PointSpan PointFile::Points() const
+{
+    if (!view.Valid())
+    {
+        return PointSpan{ nullptr, nullptr, 0, 1 };
+    }
+    const double* x = reinterpret_cast<const double*>(view.Data() + header.xOffset);
+    const double* y = reinterpret_cast<const double*>(view.Data() + header.yOffset);
+    return MakePointSpan(x, y, (size_t)header.pointCount);
+}
+
+const uint32_t* PointFile::Hull() const
+{
+    if (!view.Valid() || header.indexCount == 0)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const uint32_t*>(view.Data() + header.indexOffset);
+}
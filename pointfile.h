@@ -0,0 +1,91 @@
+#ifndef _POINTFILE_H
+#define _POINTFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "geometry.h"
+#include "mappedfile.h"
+
+/*--------------------------------------------------------------------
+    Binary point file (.chp), little-endian.
+
+    [0, 64)         PointFileHeader
+    [xOffset, ...)  pointCount doubles, x values
+    [yOffset, ...)  pointCount doubles, y values
+    [indexOffset..) indexCount uint32_t, hull vertices into the points
+
+    Every section starts on a 64 byte boundary so a mapped file can be
+    handed to the engines as a PointSpan without parsing or copying.
+    The checksum is FNV-1a 64 over every byte after the header.
+--------------------------------------------------------------------*/
+
+#define POINTFILE_VERSION 1
+
+enum class PointFileKind : uint16_t
+{
+    PointSet = 1,   // points only
+    Hull = 2,       // points plus their hull
+    Minkowski = 3   // Minkowski sum/difference points plus their hull
+};
+
+enum PointFileFlags : uint32_t
+{
+    PointFileHasChecksum = 1
+};
+
+struct PointFileHeader
+{
+    char     magic[4];      // "CHPF"
+    uint16_t version;
+    uint16_t kind;          // PointFileKind
+    uint32_t flags;         // PointFileFlags
+    uint32_t reserved;
+    uint64_t pointCount;
+    uint64_t indexCount;
+    uint64_t xOffset;
+    uint64_t yOffset;
+    uint64_t indexOffset;
+    uint64_t checksum;
+};
+
+static_assert(sizeof(PointFileHeader) == 64, "PointFileHeader must stay 64 bytes");
+
+bool WritePointFile(const std::string& path, PointFileKind kind, const PointSpan& points,
+    const uint32_t* hull = nullptr, size_t hullCount = 0, bool checksum = true);
+
+//whether path starts with the .chp magic, whatever state the rest of it is in
+bool IsPointFile(const std::string& path);
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    PointFile
+
+  Summary:  Maps a .chp file and exposes its sections in place. Open()
+            validates the header, the section bounds and the hull
+            indices, so loading costs the same for any number of
+            points; the checksum is verified only when asked for since
+            it reads every byte.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class PointFile
+{
+public:
+    PointFile() : header() { }
+
+    bool Open(const std::string& path, bool verifyChecksum = false);
+    void Close();
+
+    PointFileKind   Kind() const { return (PointFileKind)header.kind; }
+    PointSpan       Points() const;
+    const uint32_t* Hull() const;
+    size_t          HullSize() const { return (size_t)header.indexCount; }
+
+private:
+    MappedFile      file;
+    MappedView      view;
+    PointFileHeader header;
+};
+
+uint64_t Fnv1a64(const void* data, size_t length, uint64_t hash = 14695981039346656037ull);
+
+#endif
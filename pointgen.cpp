@@ -0,0 +1,215 @@
+#include "pointgen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+
+    //draws above this belong to per seed tables (cluster centers, distinct points), not to points
+    const uint64_t TableCounter = 1ull << 63;
+
+    const struct
+    {
+        PointDistribution distribution;
+        const char*       name;
+    } Names[] =
+    {
+        { PointDistribution::Square, "square" },
+        { PointDistribution::Disk, "disk" },
+        { PointDistribution::Circle, "circle" },
+        { PointDistribution::Gaussian, "gaussian" },
+        { PointDistribution::Clustered, "clustered" },
+        { PointDistribution::Collinear, "collinear" },
+        { PointDistribution::Duplicates, "duplicates" }
+    };
+
+    //Box-Muller on draws c and c + 1
+    void Normal(const CounterRandom& random, uint64_t c, double& a, double& b)
+    {
+        const double radius = sqrt(-2.0 * log(1.0 - random.Unit(c)));
+        const double angle = 2.0 * Pi * random.Unit(c + 1);
+        a = radius * cos(angle);
+        b = radius * sin(angle);
+    }
+}
+
+const char* DistributionName(PointDistribution distribution)
+{
+    for (const auto& n : Names)
+    {
+        if (n.distribution == distribution)
+        {
+            return n.name;
+        }
+    }
+    return "";
+}
+
+bool ParseDistribution(const string& name, PointDistribution& distribution)
+{
+    for (const auto& n : Names)
+    {
+        if (name == n.name)
+        {
+            distribution = n.distribution;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: GeneratePoints
+
+    Summary:  Writes points first to first + count - 1 of the seeded
+              set into x[0..count) and y[0..count). Each point is a
+              pure function of (seed, index), so ranges can be filled
+              in any order, on any thread, or streamed a chunk at a
+              time.
+
+    Args:     PointDistribution distribution
+                distribution family
+              uint64_t seed
+                seed of the set
+              size_t first, size_t count
+                range of point indices to generate
+              double* x, double* y
+                receive count values each
+
+    Modifies: [x, y].
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+void GeneratePoints(PointDistribution distribution, uint64_t seed, size_t first, size_t count, double* x, double* y)
+{
+    const CounterRandom random(seed);
+    switch (distribution)
+    {
+    case PointDistribution::Square:
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t c = 4 * (uint64_t)(first + i);
+            x[i] = random.Signed(c);
+            y[i] = random.Signed(c + 1);
+        }
+        break;
+    case PointDistribution::Disk:
+    case PointDistribution::Circle:
+    {
+        const bool onCircle = distribution == PointDistribution::Circle;
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t c = 4 * (uint64_t)(first + i);
+            const double angle = 2.0 * Pi * random.Unit(c);
+            const double radius = onCircle ? 1.0 : sqrt(random.Unit(c + 1));
+            x[i] = radius * cos(angle);
+            y[i] = radius * sin(angle);
+        }
+        break;
+    }
+    case PointDistribution::Gaussian:
+        for (size_t i = 0; i < count; i++)
+        {
+            Normal(random, 4 * (uint64_t)(first + i), x[i], y[i]);
+        }
+        break;
+    case PointDistribution::Clustered:
+    {
+        Point2D centers[16];
+        for (uint64_t k = 0; k < 16; k++)
+        {
+            centers[k] = Point2D{ random.Signed(TableCounter + 2 * k), random.Signed(TableCounter + 2 * k + 1) };
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t c = 4 * (uint64_t)(first + i);
+            const Point2D& center = centers[random.Below(c + 2, 16)];
+            double dx, dy;
+            Normal(random, c, dx, dy);
+            x[i] = center.x + 0.02 * dx;
+            y[i] = center.y + 0.02 * dy;
+        }
+        break;
+    }
+    case PointDistribution::Collinear:
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint64_t c = 4 * (uint64_t)(first + i);
+            x[i] = random.Signed(c);
+            y[i] = 0.5 * x[i] + 1e-9 * random.Signed(c + 1);
+        }
+        break;
+    case PointDistribution::Duplicates:
+    {
+        Point2D distinct[64];
+        for (uint64_t k = 0; k < 64; k++)
+        {
+            distinct[k] = Point2D{ random.Signed(TableCounter + 2 * k), random.Signed(TableCounter + 2 * k + 1) };
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            const Point2D& p = distinct[random.Below(4 * (uint64_t)(first + i), 64)];
+            x[i] = p.x;
+            y[i] = p.y;
+        }
+        break;
+    }
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: GeneratePoints
+
+    Summary:  Fills points with count points of the seeded set, split
+              into one contiguous range per thread. The result does not
+              depend on the thread count.
+
+    Args:     PointDistribution distribution
+                distribution family
+              size_t count
+                number of points
+              uint64_t seed
+                seed of the set
+              PointBuffer& points
+                receives the points, replacing its contents
+              unsigned threads
+                worker count, 0 = hardware concurrency
+
+    Modifies: [points].
+
+    Returns:  void
+-----------------------------------------------------------------F-F*/
+void GeneratePoints(PointDistribution distribution, size_t count, uint64_t seed, PointBuffer& points, unsigned threads)
+{
+    points.x.resize(count);
+    points.y.resize(count);
+
+    //ranges smaller than this are not worth a thread
+    const size_t minRange = 1 << 16;
+    unsigned threadCount = threads ? threads : thread::hardware_concurrency();
+    threadCount = (unsigned)max<size_t>(1, min<size_t>(max(threadCount, 1u), count / minRange));
+
+    auto worker = [&](unsigned id)
+    {
+        const size_t begin = count * id / threadCount;
+        const size_t end = count * (id + 1) / threadCount;
+        GeneratePoints(distribution, seed, begin, end - begin, points.x.data() + begin, points.y.data() + begin);
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& t : pool)
+    {
+        t.join();
+    }
+}
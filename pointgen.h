@@ -0,0 +1,71 @@
+#ifndef _POINTGEN_H
+#define _POINTGEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Seedable point set generators. Random numbers are counter based:
+    draw k of a seed is SplitMix64 of the seed's key plus k times the
+    golden gamma, so any draw can be computed without the ones before
+    it. Point i only uses draws 4i to 4i + 3, which makes a generated
+    set identical however it is split across threads or chunks.
+--------------------------------------------------------------------*/
+
+enum class PointDistribution
+{
+    Square,         // uniform in [-1, 1]^2
+    Disk,           // uniform in the unit disk
+    Circle,         // on the unit circle, every point on the hull
+    Gaussian,       // standard normal in x and y
+    Clustered,      // 16 tight normal clusters
+    Collinear,      // on a line, off it by at most 1e-9
+    Duplicates      // 64 distinct points repeated
+};
+
+const char* DistributionName(PointDistribution distribution);
+bool        ParseDistribution(const std::string& name, PointDistribution& distribution);
+
+inline uint64_t SplitMix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    CounterRandom
+
+  Summary:  Stateless random numbers for one seed, addressed by a
+            counter, with no hidden state shared between threads.
+            Below maps 32 random bits to the range by multiply and
+            shift, so it is not exactly uniform: each value is off by
+            at most bound / 2^32 of its share, far less than
+            rand() % range, and no rejection loop is needed to keep
+            one counter one draw.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+struct CounterRandom
+{
+    uint64_t key;
+
+    explicit CounterRandom(uint64_t seed) : key(SplitMix64(seed)) { }
+
+    uint64_t Bits(uint64_t counter) const { return SplitMix64(key + counter * 0x9E3779B97F4A7C15ull); }
+
+    //uniform in [0, 1)
+    double Unit(uint64_t counter) const { return (Bits(counter) >> 11) * (1.0 / 9007199254740992.0); }
+
+    //uniform in [-1, 1)
+    double Signed(uint64_t counter) const { return 2.0 * Unit(counter) - 1.0; }
+
+    //uniform in [0, bound) by multiply and shift, bias below bound / 2^32
+    uint32_t Below(uint64_t counter, uint32_t bound) const { return (uint32_t)(((Bits(counter) >> 32) * bound) >> 32); }
+};
+
+void GeneratePoints(PointDistribution distribution, uint64_t seed, size_t first, size_t count, double* x, double* y);
+void GeneratePoints(PointDistribution distribution, size_t count, uint64_t seed, PointBuffer& points, unsigned threads = 0);
+
+#endif
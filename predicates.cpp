@@ -0,0 +1,214 @@
+#include "predicates.h"
+
+#include <cmath>
+
+using namespace std;
+
+/*--------------------------------------------------------------------
+    Expansion arithmetic after J. R. Shewchuk, "Adaptive Precision
+    Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+    An expansion is a sum of doubles of increasing magnitude that do
+    not overlap; its sign is the sign of its largest component. The
+    error free transforms below rely on round to nearest doubles and
+    must not be contracted into fused multiply-adds, so TwoProduct
+    uses fma itself when the target has a fast one and Dekker's split
+    otherwise.
+--------------------------------------------------------------------*/
+
+namespace
+{
+    const double Epsilon = 1.1102230246251565e-16;             // 2^-53
+    const double Splitter = 134217729.0;                        // 2^27 + 1
+    const double BoundB = (2.0 + 12.0 * Epsilon) * Epsilon;
+    const double BoundC = (9.0 + 64.0 * Epsilon) * Epsilon * Epsilon;
+    const double ResultBound = (3.0 + 8.0 * Epsilon) * Epsilon;
+
+    inline void FastTwoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        y = b - (x - a);
+    }
+
+    inline void TwoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        const double bVirtual = x - a;
+        const double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    //tail of x = a - b, the rounding error of the subtraction
+    inline double TwoDiffTail(double a, double b, double x)
+    {
+        const double bVirtual = a - x;
+        const double aVirtual = x + bVirtual;
+        return (a - aVirtual) + (bVirtual - b);
+    }
+
+    inline void TwoDiff(double a, double b, double& x, double& y)
+    {
+        x = a - b;
+        y = TwoDiffTail(a, b, x);
+    }
+
+    inline void TwoProduct(double a, double b, double& x, double& y)
+    {
+        x = a * b;
+#ifdef FP_FAST_FMA
+        y = fma(a, b, -x);
+#else
+        const double ca = Splitter * a;
+        const double aHigh = ca - (ca - a);
+        const double aLow = a - aHigh;
+        const double cb = Splitter * b;
+        const double bHigh = cb - (cb - b);
+        const double bLow = b - bHigh;
+        y = aLow * bLow - (((x - aHigh * bHigh) - aLow * bHigh) - aHigh * bLow);
+#endif
+    }
+
+    //(a1 + a0) - (b1 + b0) as the four component expansion x[0..3]
+    inline void TwoTwoDiff(double a1, double a0, double b1, double b0, double* x)
+    {
+        double i, j, k, l;
+        TwoDiff(a0, b0, i, x[0]);
+        TwoSum(a1, i, j, k);
+        TwoDiff(k, b1, l, x[1]);
+        TwoSum(j, l, x[3], x[2]);
+    }
+
+    //h = e + f, dropping zero components; h needs room for elen + flen values
+    int ExpansionSum(int elen, const double* e, int flen, const double* f, double* h)
+    {
+        int ei = 0;
+        int fi = 0;
+        int hi = 0;
+        double q;
+        double hh;
+        //merge by magnitude, the smaller of the two next components goes first
+        auto next = [&]() -> double
+        {
+            if (fi == flen || (ei < elen && (f[fi] > e[ei]) == (f[fi] > -e[ei])))
+            {
+                return e[ei++];
+            }
+            return f[fi++];
+        };
+
+        q = next();
+        if (ei < elen && fi < flen)
+        {
+            FastTwoSum(next(), q, q, hh);
+            if (hh != 0)
+            {
+                h[hi++] = hh;
+            }
+        }
+        while (ei < elen || fi < flen)
+        {
+            TwoSum(q, next(), q, hh);
+            if (hh != 0)
+            {
+                h[hi++] = hh;
+            }
+        }
+        if (q != 0 || hi == 0)
+        {
+            h[hi++] = q;
+        }
+        return hi;
+    }
+
+    double Estimate(int length, const double* e)
+    {
+        double sum = e[0];
+        for (int i = 1; i < length; i++)
+        {
+            sum += e[i];
+        }
+        return sum;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Predicates::DifferenceProductsAdapt
+
+    Summary:  Shewchuk's orient2dadapt, generalised to any four input
+              differences: (a1 - a2)(b1 - b2) - (c1 - c2)(d1 - d2). Each
+              stage adds precision and stops as soon as the sign is
+              certain; the last one is exact.
+
+    Args:     double a1, a2, b1, b2, c1, c2, d1, d2
+                the inputs
+              double magnitude
+                |(a1 - a2)(b1 - b2)| + |(c1 - c2)(d1 - d2)| as the fast
+                path computed it
+
+    Returns:  double
+                a value with the exact sign of the expression
+-----------------------------------------------------------------F-F*/
+double Predicates::DifferenceProductsAdapt(double a1, double a2, double b1, double b2,
+    double c1, double c2, double d1, double d2, double magnitude)
+{
+    const double a = a1 - a2;
+    const double b = b1 - b2;
+    const double c = c1 - c2;
+    const double d = d1 - d2;
+
+    //stage B: the products of the rounded differences, exactly
+    double left, leftTail, right, rightTail;
+    TwoProduct(a, b, left, leftTail);
+    TwoProduct(c, d, right, rightTail);
+    double stageB[4];
+    TwoTwoDiff(left, leftTail, right, rightTail, stageB);
+    double det = Estimate(4, stageB);
+    double bound = BoundB * magnitude;
+    if (det >= bound || -det >= bound)
+    {
+        return det;
+    }
+
+    //stage C: first order terms of the subtraction errors
+    const double aTail = TwoDiffTail(a1, a2, a);
+    const double bTail = TwoDiffTail(b1, b2, b);
+    const double cTail = TwoDiffTail(c1, c2, c);
+    const double dTail = TwoDiffTail(d1, d2, d);
+    if (aTail == 0 && bTail == 0 && cTail == 0 && dTail == 0)
+    {
+        return det;
+    }
+    bound = BoundC * magnitude + ResultBound * fabs(det);
+    det += (a * bTail + b * aTail) - (c * dTail + d * cTail);
+    if (det >= bound || -det >= bound)
+    {
+        return det;
+    }
+
+    //stage D: every term as an expansion
+    double s, sTail, t, tTail;
+    double u[4];
+    double stageC1[8], stageC2[12], stageD[16];
+
+    TwoProduct(aTail, b, s, sTail);
+    TwoProduct(cTail, d, t, tTail);
+    TwoTwoDiff(s, sTail, t, tTail, u);
+    const int c1Length = ExpansionSum(4, stageB, 4, u, stageC1);
+
+    TwoProduct(a, bTail, s, sTail);
+    TwoProduct(c, dTail, t, tTail);
+    TwoTwoDiff(s, sTail, t, tTail, u);
+    const int c2Length = ExpansionSum(c1Length, stageC1, 4, u, stageC2);
+
+    TwoProduct(aTail, bTail, s, sTail);
+    TwoProduct(cTail, dTail, t, tTail);
+    TwoTwoDiff(s, sTail, t, tTail, u);
+    const int dLength = ExpansionSum(c2Length, stageC2, 4, u, stageD);
+
+    return stageD[dLength - 1];
+}
+
+double Predicates::DifferenceProductsFiltered(double a1, double a2, double b1, double b2,
+    double c1, double c2, double d1, double d2)
+{
+    return DifferenceProducts(a1, a2, b1, b2, c1, c2, d1, d2);
+}
@@ -0,0 +1,136 @@
+#ifndef _PREDICATES_H
+#define _PREDICATES_H
+
+#include <cmath>
+
+/*--------------------------------------------------------------------
+    Robust geometric predicates on doubles (floats convert exactly).
+
+    Both predicates are the sign of (a1 - a2)(b1 - b2) - (c1 - c2)(d1 -
+    d2). The fast path evaluates it in plain floating point and keeps
+    the result when its magnitude clears Shewchuk's error bound for
+    that expression, which is almost always. Only the rare uncertain
+    case, nearly collinear input, falls through to the adaptive path
+    in predicates.cpp, which refines the value with expansion
+    arithmetic until the sign is certain and is exact in the end. The
+    returned value is not exact, only its sign is.
+
+    Loops over a whole point set use an OrientFilter instead: its error
+    bound is worked out once from the extent of the set, so the common
+    case costs one comparison more than the raw cross product.
+
+    Overflow and underflow are not handled: inputs whose products
+    leave the double range may still get the wrong sign.
+--------------------------------------------------------------------*/
+
+namespace Predicates
+{
+    //(3 + 16 eps) eps with eps = 2^-53, the bound of the fast path
+    const double FastBound = 3.3306690738754716e-16;
+
+    //the raw expression, with no error bound
+    inline double DifferenceProductsRaw(double a1, double a2, double b1, double b2,
+        double c1, double c2, double d1, double d2)
+    {
+        return (a1 - a2) * (b1 - b2) - (c1 - c2) * (d1 - d2);
+    }
+
+    double DifferenceProductsAdapt(double a1, double a2, double b1, double b2,
+        double c1, double c2, double d1, double d2, double magnitude);
+
+    //DifferenceProducts out of line, so filters keep it out of their callers' loops
+    double DifferenceProductsFiltered(double a1, double a2, double b1, double b2,
+        double c1, double c2, double d1, double d2);
+
+    inline double DifferenceProducts(double a1, double a2, double b1, double b2,
+        double c1, double c2, double d1, double d2)
+    {
+        const double left = (a1 - a2) * (b1 - b2);
+        const double right = (c1 - c2) * (d1 - d2);
+        const double det = left - right;
+        const double magnitude = std::fabs(left) + std::fabs(right);
+        if (std::fabs(det) >= FastBound * magnitude)
+        {
+            return det;
+        }
+        return DifferenceProductsAdapt(a1, a2, b1, b2, c1, c2, d1, d2, magnitude);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: Orient2D
+
+    Summary:  Orientation of the triangle a, b, c: twice its signed
+              area, with an exact sign.
+
+    Returns:  double
+                > 0 if c is left of a->b (counter-clockwise in a y-up
+                frame), < 0 if right, exactly 0 if collinear
+-----------------------------------------------------------------F-F*/
+inline double Orient2D(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    return Predicates::DifferenceProducts(ax, cx, by, cy, ay, cy, bx, cx);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: CrossDifference
+
+    Summary:  Compares how far p and q lie from the line a->b: the
+              exact sign of Orient2D(a, b, p) - Orient2D(a, b, q),
+              which is (b - a) x (p - q).
+
+    Returns:  double
+                > 0 if p is farther left of a->b than q, < 0 if q is,
+                exactly 0 if both are equally far
+-----------------------------------------------------------------F-F*/
+inline double CrossDifference(double ax, double ay, double bx, double by, double px, double py, double qx, double qy)
+{
+    return Predicates::DifferenceProducts(bx, ax, py, qy, by, ay, px, qx);
+}
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    OrientFilter
+
+  Summary:  Semi-static filter for Orient2D and CrossDifference over one
+            point set. Every difference the predicates take is at most
+            the extent of the set, so the fast path error is at most
+            FastBound * 2 * extent^2 whatever the points; a raw result
+            beyond that is returned as is, anything nearer zero goes on
+            to the dynamic filter and the adaptive path.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class OrientFilter
+{
+public:
+    //extent is the larger side of the bounding box of the points; the
+    //factor past 2 covers the rounding of the extent itself
+    explicit OrientFilter(double extent) : bound(Predicates::FastBound * 2.000001 * extent * extent) { }
+
+    //true if a raw cross product (or difference) of the set is sure to have the exact sign
+    bool Certain(double det) const { return std::fabs(det) > bound; }
+
+    double Orient2D(double ax, double ay, double bx, double by, double cx, double cy) const
+    {
+        //as (b - a) x (c - a), so loops over c with a fixed edge hoist b - a
+        const double det = Predicates::DifferenceProductsRaw(bx, ax, cy, ay, by, ay, cx, ax);
+        if (Certain(det))
+        {
+            return det;
+        }
+        return Predicates::DifferenceProductsFiltered(ax, cx, by, cy, ay, cy, bx, cx);
+    }
+
+    double CrossDifference(double ax, double ay, double bx, double by, double px, double py, double qx, double qy) const
+    {
+        const double det = Predicates::DifferenceProductsRaw(bx, ax, py, qy, by, ay, px, qx);
+        if (Certain(det))
+        {
+            return det;
+        }
+        return Predicates::DifferenceProductsFiltered(bx, ax, py, qy, by, ay, px, qx);
+    }
+
+private:
+    double bound;
+};
+
+#endif
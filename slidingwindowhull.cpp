@@ -0,0 +1,273 @@
+#include "slidingwindowhull.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+    Point2D Mirror(const Point2D& p)
+    {
+        return Point2D{ p.x, -p.y };
+    }
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   SlidingWindowHull::Chain::Insert
+
+  Summary:  Adds a point to the upper chain. Vertices that stop being
+            on the chain are erased and appended to removed so the
+            insertion can be undone later.
+
+  Args:     const Point2D& p
+              point being inserted
+            vector<Point2D>& removed
+              undo log the displaced vertices are appended to
+
+  Returns:  bool
+              false if p is on or under the chain and nothing changed
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+bool SlidingWindowHull::Chain::Insert(const Point2D& p, vector<Point2D>& removed)
+{
+    auto it = vertices.lower_bound(p.x);
+    if (it != vertices.end() && it->first == p.x)
+    {
+        if (it->second >= p.y)
+        {
+            return false;
+        }
+        removed.push_back(Point2D{ it->first, it->second });
+        it = vertices.erase(it);
+    }
+    else if (it != vertices.end() && it != vertices.begin())
+    {
+        auto left = prev(it);
+        const Point2D a{ left->first, left->second };
+        const Point2D b{ it->first, it->second };
+        if (Orientation(a, b, p) <= 0)
+        {
+            return false;
+        }
+    }
+
+    it = vertices.emplace_hint(it, p.x, p.y);
+
+    // The chain turns clockwise from left to right; drop every
+    // neighbour that no longer does.
+    while (it != vertices.begin() && prev(it) != vertices.begin())
+    {
+        auto b = prev(it);
+        auto a = prev(b);
+        if (Orientation(Point2D{ a->first, a->second }, Point2D{ b->first, b->second }, p) < 0)
+        {
+            break;
+        }
+        removed.push_back(Point2D{ b->first, b->second });
+        vertices.erase(b);
+    }
+    while (next(it) != vertices.end() && next(next(it)) != vertices.end())
+    {
+        auto b = next(it);
+        auto c = next(b);
+        if (Orientation(p, Point2D{ b->first, b->second }, Point2D{ c->first, c->second }) < 0)
+        {
+            break;
+        }
+        removed.push_back(Point2D{ b->first, b->second });
+        vertices.erase(b);
+    }
+    return true;
+}
+
+void SlidingWindowHull::Chain::Undo(const Point2D& p, bool inserted, vector<Point2D>& removed, size_t removedStart)
+{
+    if (inserted)
+    {
+        vertices.erase(p.x);
+    }
+    for (size_t i = removedStart; i < removed.size(); i++)
+    {
+        vertices.emplace(removed[i].x, removed[i].y);
+    }
+    removed.resize(removedStart);
+}
+
+void SlidingWindowHull::Chain::AppendTo(vector<Point2D>& out, double sign) const
+{
+    for (auto const& v : vertices)
+    {
+        out.push_back(Point2D{ v.first, sign * v.second });
+    }
+}
+
+SlidingWindowHull::SlidingWindowHull(size_t capacity) : capacity(capacity), hullValid(false)
+{
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   SlidingWindowHull::PushBack
+
+  Summary:  Appends the newest point of the stream. If the window is
+            at capacity the oldest point is evicted first.
+
+  Args:     const Point2D& point
+              new point
+            double timestamp
+              time of the point, only used by EvictOlderThan
+
+  Modifies: [back, backUpper, backLower].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void SlidingWindowHull::PushBack(const Point2D& point, double timestamp)
+{
+    if (capacity != 0 && Size() >= capacity)
+    {
+        PopFront();
+    }
+    back.push_back(Sample{ point, timestamp });
+    scratch.clear();
+    backUpper.Insert(point, scratch);
+    scratch.clear();
+    backLower.Insert(Mirror(point), scratch);
+    hullValid = false;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   SlidingWindowHull::Flip
+
+  Summary:  Moves the back stack to the front. Points are inserted
+            into the front chains newest first so the oldest point's
+            insertion is the last entry of the undo log.
+
+  Modifies: [front, back, every chain, undo logs].
+
+  Returns:  void
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void SlidingWindowHull::Flip()
+{
+    for (auto i = back.rbegin(); i != back.rend(); ++i)
+    {
+        Undo entry;
+        entry.upperRemovedStart = upperRemoved.size();
+        entry.lowerRemovedStart = lowerRemoved.size();
+        entry.upperInserted = frontUpper.Insert(i->point, upperRemoved);
+        entry.lowerInserted = frontLower.Insert(Mirror(i->point), lowerRemoved);
+        undo.push_back(entry);
+    }
+    front.swap(back);
+    back.clear();
+    backUpper.Clear();
+    backLower.Clear();
+}
+
+void SlidingWindowHull::PopFront()
+{
+    if (front.empty())
+    {
+        if (back.empty())
+        {
+            return;
+        }
+        Flip();
+    }
+
+    const Undo entry = undo.back();
+    undo.pop_back();
+    const Point2D p = front.front().point;
+    frontUpper.Undo(p, entry.upperInserted, upperRemoved, entry.upperRemovedStart);
+    frontLower.Undo(Mirror(p), entry.lowerInserted, lowerRemoved, entry.lowerRemovedStart);
+    front.pop_front();
+    hullValid = false;
+}
+
+void SlidingWindowHull::EvictOlderThan(double cutoff)
+{
+    while (!Empty())
+    {
+        const Sample& oldest = front.empty() ? back.front() : front.front();
+        if (oldest.timestamp >= cutoff)
+        {
+            break;
+        }
+        PopFront();
+    }
+}
+
+void SlidingWindowHull::Clear()
+{
+    front.clear();
+    back.clear();
+    frontUpper.Clear();
+    frontLower.Clear();
+    backUpper.Clear();
+    backLower.Clear();
+    undo.clear();
+    upperRemoved.clear();
+    lowerRemoved.clear();
+    hull.clear();
+    hullValid = true;
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   SlidingWindowHull::Hull
+
+  Summary:  Hull of the whole window: a monotone chain pass over the
+            vertices of the front and back chains. O(h log h) in the
+            number of chain vertices, independent of W. Cached until
+            the window changes.
+
+  Returns:  const vector<Point2D>&
+              hull vertices, counter-clockwise from the left most point
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+const vector<Point2D>& SlidingWindowHull::Hull()
+{
+    if (hullValid)
+    {
+        return hull;
+    }
+
+    scratch.clear();
+    frontUpper.AppendTo(scratch, 1);
+    backUpper.AppendTo(scratch, 1);
+    frontLower.AppendTo(scratch, -1);
+    backLower.AppendTo(scratch, -1);
+    sort(scratch.begin(), scratch.end(), [](const Point2D& a, const Point2D& b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    scratch.erase(unique(scratch.begin(), scratch.end(), [](const Point2D& a, const Point2D& b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }), scratch.end());
+
+    hull.clear();
+    if (scratch.size() < 3)
+    {
+        hull = scratch;
+        hullValid = true;
+        return hull;
+    }
+
+    // Lower chain left to right, then upper chain right to left.
+    for (size_t i = 0; i < scratch.size(); i++)
+    {
+        while (hull.size() >= 2 && Orientation(hull[hull.size() - 2], hull.back(), scratch[i]) <= 0)
+        {
+            hull.pop_back();
+        }
+        hull.push_back(scratch[i]);
+    }
+    const size_t lowerSize = hull.size();
+    for (size_t i = scratch.size() - 1; i-- > 0;)
+    {
+        while (hull.size() > lowerSize && Orientation(hull[hull.size() - 2], hull.back(), scratch[i]) <= 0)
+        {
+            hull.pop_back();
+        }
+        hull.push_back(scratch[i]);
+    }
+    hull.pop_back();
+    hullValid = true;
+    return hull;
+}
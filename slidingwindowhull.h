@@ -0,0 +1,105 @@
+#ifndef _SLIDINGWINDOWHULL_H
+#define _SLIDINGWINDOWHULL_H
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "geometry.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    SlidingWindowHull
+
+  Summary:  Convex hull of the last W points (and/or the points newer
+            than a cutoff time) of a time-ordered stream.
+
+            Works like a two-stack queue. New points go onto the back
+            stack and into an insert-only hull of the back stack. When
+            the front stack runs out, the back stack is flipped: its
+            points are inserted into the front hull newest first, and
+            every insertion logs the vertices it displaced. The oldest
+            point is then always the last one inserted, so popping it
+            is undoing the last insertion. Each point is inserted and
+            undone once, so push and pop are amortized O(log W).
+
+            Both hulls are stored as upper and lower chains keyed by x.
+            The undo logs only hold vertices that were removed, which is
+            at most one entry per point, so memory stays O(W).
+
+  Methods:  PushBack
+              Adds the newest point, evicting the oldest at capacity.
+            PopFront
+              Removes the oldest point.
+            EvictOlderThan
+              Pops every point with a timestamp before the cutoff.
+            Hull
+              Current hull, counter-clockwise from the left most point.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+class SlidingWindowHull
+{
+public:
+    explicit SlidingWindowHull(size_t capacity = 0);
+
+    void PushBack(const Point2D& point, double timestamp = 0);
+    void PopFront();
+    void EvictOlderThan(double cutoff);
+    void Clear();
+
+    size_t Size() const { return front.size() + back.size(); }
+    bool   Empty() const { return Size() == 0; }
+    size_t Capacity() const { return capacity; }
+
+    const std::vector<Point2D>& Hull();
+
+private:
+    struct Sample
+    {
+        Point2D point;
+        double  timestamp;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SlidingWindowHull::Chain
+
+      Summary:  Upper convex chain keyed by x. The lower chain is the
+                upper chain of the points mirrored in y.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+    class Chain
+    {
+    public:
+        bool Insert(const Point2D& p, std::vector<Point2D>& removed);
+        void Undo(const Point2D& p, bool inserted, std::vector<Point2D>& removed, size_t removedStart);
+        void Clear() { vertices.clear(); }
+        void AppendTo(std::vector<Point2D>& out, double sign) const;
+
+    private:
+        std::map<double, double> vertices;
+    };
+
+    struct Undo
+    {
+        bool   upperInserted;
+        bool   lowerInserted;
+        size_t upperRemovedStart;
+        size_t lowerRemovedStart;
+    };
+
+    void Flip();
+
+    size_t                  capacity;
+    std::deque<Sample>      front;      // oldest first
+    std::deque<Sample>      back;       // oldest first
+    Chain                   frontUpper;
+    Chain                   frontLower;
+    Chain                   backUpper;
+    Chain                   backLower;
+    std::vector<Undo>       undo;       // last entry belongs to front.front()
+    std::vector<Point2D>    upperRemoved;
+    std::vector<Point2D>    lowerRemoved;
+    std::vector<Point2D>    scratch;    // back stack never needs undo
+    std::vector<Point2D>    hull;
+    bool                    hullValid;
+};
+
+#endif
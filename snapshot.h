@@ -0,0 +1,258 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*--------------------------------------------------------------------
+    Lock-free publication of immutable snapshots from one writer to any
+    number of reader threads, with epoch based reclamation.
+
+    The writer builds a new T off to the side and Publish swaps it in
+    with one atomic exchange; a T is never changed once published, so
+    a reader always sees a whole, consistent version. Readers pin the
+    version they read by announcing the current epoch in a slot of
+    their own (one cache line each, so readers never share a line),
+    which costs two stores and two loads: a few nanoseconds, and
+    no lock or read-modify-write. The writer bumps the epoch on every
+    publish and frees a replaced version once every reader slot is
+    empty or shows a later epoch, since such a reader cannot still hold
+    it. A reader that stays pinned holds back the frees, not the writer.
+    Rather than free them, the writer can take such versions back with
+    Recycle and fill them in again, so a steady stream of publishes
+    stops allocating once the spares' buffers have grown.
+
+    There must be a single writer (or writers serialized by the
+    caller). Readers register once per thread; a publisher holds at
+    most maxReaders of them at a time.
+--------------------------------------------------------------------*/
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    SnapshotPublisher
+
+  Summary:  Current immutable version of a T, replaced by the writer
+            and read without locks.
+
+  Methods:  Publish
+              makes a new version current and frees the old ones no
+              reader can see (writer only)
+            Reclaim
+              frees what can be freed without publishing
+            Recycle
+              a replaced version no reader can hold, to fill in and
+              publish again (writer only)
+            Retired
+              versions replaced but not yet freed
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C*/
+template <class T>
+class SnapshotPublisher
+{
+public:
+    //one per reader thread; Read returns a View that pins the current version,
+    //and Views of one Reader may nest
+    class Reader;
+
+    //the version current when it was made, valid for as long as it lives
+    class View
+    {
+    public:
+        explicit View(Reader& reader) : reader(reader), snapshot(reader.Enter()) { }
+        ~View() { reader.Leave(); }
+
+        View(const View&) = delete;
+        View& operator=(const View&) = delete;
+
+        const T* get() const { return snapshot; }
+        const T& operator*() const { return *snapshot; }
+        const T* operator->() const { return snapshot; }
+        explicit operator bool() const { return snapshot != nullptr; }
+
+    private:
+        Reader&  reader;
+        const T* snapshot;
+    };
+
+    class Reader
+    {
+    public:
+        //takes a free slot; more than maxReaders at once is a programming error
+        explicit Reader(SnapshotPublisher& publisher) : publisher(publisher), slot(publisher.Acquire()), depth(0) { }
+        ~Reader() { publisher.slots[slot].used.store(false, std::memory_order_release); }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        View Read() { return View(*this); }
+
+    private:
+        friend class View;
+
+        const T* Enter()
+        {
+            //all three seq_cst: an epoch read after Publish's fetch_add follows its exchange too,
+            //so the pointer read below is at least that new; and the announcement comes before
+            //the pointer is read, so a writer that replaced the version read here is bound to
+            //see the announcement when it reclaims. A nested View keeps the outer announcement:
+            //anything it reads is retired in that epoch or later, so it is held back as well.
+            if (depth++ == 0)
+            {
+                const uint64_t entered = publisher.epoch.load(std::memory_order_seq_cst);
+                publisher.slots[slot].epoch.store(entered, std::memory_order_seq_cst);
+            }
+            return publisher.current.load(std::memory_order_seq_cst);
+        }
+
+        void Leave()
+        {
+            if (--depth == 0)
+            {
+                publisher.slots[slot].epoch.store(Quiescent, std::memory_order_release);
+            }
+        }
+
+        SnapshotPublisher& publisher;
+        const size_t       slot;
+        size_t             depth;       // live Views, only touched by the owning thread
+    };
+
+    explicit SnapshotPublisher(size_t maxReaders = 64) : current(nullptr), epoch(1), slots(maxReaders) { }
+
+    //readers must be gone by now
+    ~SnapshotPublisher()
+    {
+        delete current.load(std::memory_order_relaxed);
+        for (const RetiredVersion& r : retired)
+        {
+            delete r.snapshot;
+        }
+        for (T* s : spare)
+        {
+            delete s;
+        }
+    }
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SnapshotPublisher::Publish
+
+      Summary:  Makes snapshot the current version. The one it replaces
+                is retired with the epoch it was current in, and the
+                epoch moves on, so readers that enter from now on can
+                only see the new version.
+
+      Args:     std::unique_ptr<T> snapshot
+                  the new version, not changed again until Recycle
+                  hands it back
+
+      Modifies: [current, epoch, retired, spare].
+
+      Returns:  void
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Publish(std::unique_ptr<T> snapshot)
+    {
+        T* old = current.exchange(snapshot.release(), std::memory_order_seq_cst);
+        const uint64_t retiredIn = epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (old)
+        {
+            retired.push_back(RetiredVersion{ old, retiredIn });
+        }
+        Reclaim();
+    }
+
+    //frees the retired versions no reader can still hold, keeping up to SpareLimit
+    //of them for Recycle; returns how many left the retired list
+    size_t Reclaim()
+    {
+        uint64_t oldest = epoch.load(std::memory_order_relaxed);
+        for (const Slot& s : slots)
+        {
+            const uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+            if (e != Quiescent && e < oldest)
+            {
+                oldest = e;
+            }
+        }
+        //a reader that entered in epoch e may hold anything retired in e or later
+        size_t freed = 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++)
+        {
+            if (retired[i].epoch < oldest)
+            {
+                if (spare.size() < SpareLimit)
+                {
+                    spare.push_back(retired[i].snapshot);
+                }
+                else
+                {
+                    delete retired[i].snapshot;
+                }
+                freed++;
+            }
+            else
+            {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+        return freed;
+    }
+
+    //a version no reader can see any more, as it was published, or null if there is none
+    std::unique_ptr<T> Recycle()
+    {
+        Reclaim();
+        if (spare.empty())
+        {
+            return nullptr;
+        }
+        std::unique_ptr<T> snapshot(spare.back());
+        spare.pop_back();
+        return snapshot;
+    }
+
+    size_t Retired() const { return retired.size(); }
+
+private:
+    static constexpr uint64_t Quiescent = 0;
+    static constexpr size_t   SpareLimit = 4;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch{ Quiescent };
+        std::atomic<bool>     used{ false };
+    };
+
+    struct RetiredVersion
+    {
+        T*       snapshot;
+        uint64_t epoch;
+    };
+
+    size_t Acquire()
+    {
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            bool expected = false;
+            if (!slots[i].used.load(std::memory_order_relaxed)
+                && slots[i].used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return i;
+            }
+        }
+        std::terminate();
+    }
+
+    std::atomic<T*>             current;    // readers only ever see it const
+    std::atomic<uint64_t>       epoch;
+    std::vector<Slot>           slots;
+    std::vector<RetiredVersion> retired;    // writer only
+    std::vector<T*>             spare;      // writer only, reclaimed for Recycle
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _STATICSHAPES_H
+#define _STATICSHAPES_H
+
+#include "constexprhull.h"
+
+/*--------------------------------------------------------------------
+    Shapes fixed at build time, baked by the compiler: every hull and
+    sum below is a constant in the binary. The static_asserts pin each
+    table to the vertices the runtime kernel gives for the same input,
+    so a change to either side that breaks the agreement stops the
+    build; hullcli --verify-static repeats the comparison against the
+    runtime engines themselves.
+
+    To add a shape, list its points (order and repeats do not matter),
+    bake it and assert the result.
+--------------------------------------------------------------------*/
+
+namespace StaticShapes
+{
+    //unit crate, with a repeated corner, an edge midpoint and its centre
+    constexpr std::array<Point2D, 7> CratePoints =
+    { {
+        { 1, 1 }, { 0, 0 }, { 0.5, 0 }, { 1, 0 }, { 0, 1 }, { 0, 0 }, { 0.5, 0.5 }
+    } };
+
+    //wedge, with a point on its inner diagonal
+    constexpr std::array<Point2D, 5> WedgePoints =
+    { {
+        { -0.25, -0.5 }, { 0.75, -0.5 }, { 0.75, 0.25 }, { 0.25, -0.125 }, { 0.1, 0.1 }
+    } };
+
+    //regular hexagon of radius 0.5; the coordinates are not exact in binary
+    constexpr std::array<Point2D, 6> HexagonPoints =
+    { {
+        { 0.5, 0 }, { 0.25, 0.4330127018922193 }, { -0.25, 0.4330127018922193 },
+        { -0.5, 0 }, { -0.25, -0.4330127018922193 }, { 0.25, -0.4330127018922193 }
+    } };
+
+    //fixed point footprint, in the units of Quantize, with a reflex notch that the hull fills
+    constexpr std::array<Point2I, 6> TilePoints =
+    { {
+        { 0, 0 }, { 4096, 0 }, { 4096, 2048 }, { 2048, 4096 }, { 0, 4096 }, { 2048, 2048 }
+    } };
+
+    constexpr auto Crate = BakeHull(CratePoints);
+    constexpr auto Wedge = BakeHull(WedgePoints);
+    constexpr auto Hexagon = BakeHull(HexagonPoints);
+    constexpr auto Tile = BakeHull(TilePoints);
+
+    //configuration space of a hexagon swept around a crate, and a tile grown by itself
+    constexpr auto CrateHexagon = BakeMinkowskiSum(Crate, Hexagon);
+    constexpr auto CrateWedge = BakeMinkowskiSum(Crate, Wedge);
+    constexpr auto TileTile = BakeMinkowskiSum(Tile, Tile);
+
+    static_assert(SameVertices(Crate, std::array<Point2D, 4>{ { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } } }),
+        "Crate differs from QuickHull");
+    static_assert(SameVertices(Wedge, std::array<Point2D, 4>{ { { -0.25, -0.5 }, { 0.75, -0.5 }, { 0.75, 0.25 }, { 0.1, 0.1 } } }),
+        "Wedge differs from QuickHull");
+    static_assert(SameVertices(Hexagon, std::array<Point2D, 6>{ { { -0.5, 0 }, { -0.25, -0.4330127018922193 },
+        { 0.25, -0.4330127018922193 }, { 0.5, 0 }, { 0.25, 0.4330127018922193 }, { -0.25, 0.4330127018922193 } } }),
+        "Hexagon differs from QuickHull");
+    static_assert(SameVertices(Tile, std::array<Point2I, 5>{ { { 0, 0 }, { 4096, 0 }, { 4096, 2048 }, { 2048, 4096 }, { 0, 4096 } } }),
+        "Tile differs from QuickHull");
+
+    //parallel edges of the crate and the hexagon merge into one
+    static_assert(SameVertices(CrateHexagon, std::array<Point2D, 8>{ { { -0.5, 0 }, { -0.25, -0.4330127018922193 },
+        { 1.25, -0.4330127018922193 }, { 1.5, 0 }, { 1.5, 1 }, { 1.25, 1.4330127018922192 },
+        { -0.25, 1.4330127018922192 }, { -0.5, 1 } } }),
+        "CrateHexagon differs from MinkowskiSum");
+    static_assert(SameVertices(CrateWedge, std::array<Point2D, 6>{ { { -0.25, -0.5 }, { 1.75, -0.5 }, { 1.75, 1.25 },
+        { 0.75, 1.25 }, { 0.1, 1.1000000000000001 }, { -0.25, 0.5 } } }),
+        "CrateWedge differs from MinkowskiSum");
+    static_assert(SameVertices(TileTile, std::array<Point2I, 5>{ { { 0, 0 }, { 8192, 0 }, { 8192, 4096 }, { 4096, 8192 }, { 0, 8192 } } }),
+        "TileTile differs from MinkowskiSum");
+}
+
+#endif
@@ -0,0 +1,464 @@
+#include "textpointparser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include "mappedfile.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTPARSER_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace std;
+
+namespace
+{
+    //chunk hull vertices TextFileHull keeps before folding them into their hull
+    const size_t KeptLimit = 1 << 16;
+
+    inline bool IsBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+    }
+
+#ifdef TEXTPARSER_SSE2
+    inline unsigned LowestBit(unsigned mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return (unsigned)__builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    //first byte at or after p that is not a delimiter; never crosses a newline
+    const char* SkipBlank(const char* p, const char* end)
+    {
+        if (p == end || !IsBlank(*p))
+        {
+            return p;
+        }
+#ifdef TEXTPARSER_SSE2
+        //padded, column aligned dumps have long runs of blanks; test 16 bytes at a time
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i semicolon = _mm_set1_epi8(';');
+        const __m128i cr = _mm_set1_epi8('\r');
+        while (end - p >= 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab));
+            blank = _mm_or_si128(blank, _mm_cmpeq_epi8(v, comma));
+            blank = _mm_or_si128(blank, _mm_or_si128(_mm_cmpeq_epi8(v, semicolon), _mm_cmpeq_epi8(v, cr)));
+            const unsigned other = ~(unsigned)_mm_movemask_epi8(blank) & 0xFFFF;
+            if (other)
+            {
+                return p + LowestBit(other);
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && IsBlank(*p))
+        {
+            p++;
+        }
+        return p;
+    }
+
+    const char* NextLine(const char* p, const char* end)
+    {
+        const char* newline = (const char*)memchr(p, '\n', end - p);
+        return newline ? newline + 1 : end;
+    }
+
+    //from_chars rejects a leading '+', and accepts inf / nan which no engine can use
+    const char* ParseNumber(const char* p, const char* end, double& value)
+    {
+        if (p < end && *p == '+')
+        {
+            p++;
+        }
+        const from_chars_result r = from_chars(p, end, value);
+        return (r.ec == errc() && isfinite(value)) ? r.ptr : nullptr;
+    }
+
+    //start of the first line at or after offset, or size
+    uint64_t LineStart(const char* text, uint64_t size, uint64_t offset)
+    {
+        if (offset == 0 || offset >= size)
+        {
+            return min(offset, size);
+        }
+        return NextLine(text + offset - 1, text + size) - text;
+    }
+
+    //length of text up to and including its last newline, 0 if it has none
+    size_t WholeLines(const char* text, size_t length)
+    {
+        while (length > 0 && text[length - 1] != '\n')
+        {
+            length--;
+        }
+        return length;
+    }
+
+    void Finish(TextParseStats* stats, chrono::steady_clock::time_point start)
+    {
+        if (stats)
+        {
+            stats->seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            stats->bytesPerSecond = stats->seconds > 0 ? stats->bytes / stats->seconds : 0;
+        }
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: ParseTextPoints
+
+    Summary:  Parses text points from a buffer on the calling thread.
+              Numbers go through from_chars, delimiter runs are
+              skipped 16 bytes at a time with SSE2 when available.
+
+    Args:     const char* begin, const char* end
+                text to parse; a partial last line is parsed as is
+              PointBuffer& points
+                receives the points, appended
+
+    Modifies: [points].
+
+    Returns:  uint64_t
+                number of lines that did not hold a point
+-----------------------------------------------------------------F-F*/
+uint64_t ParseTextPoints(const char* begin, const char* end, PointBuffer& points)
+{
+    uint64_t badLines = 0;
+    const char* p = begin;
+    while (p < end)
+    {
+        p = SkipBlank(p, end);
+        if (p == end)
+        {
+            break;
+        }
+        if (*p == '\n')
+        {
+            p++;
+            continue;
+        }
+        if (*p == '#')
+        {
+            p = NextLine(p, end);
+            continue;
+        }
+
+        double x, y;
+        const char* q = ParseNumber(p, end, x);
+        if (q)
+        {
+            q = SkipBlank(q, end);
+            q = (q < end && *q != '\n') ? ParseNumber(q, end, y) : nullptr;
+        }
+        if (q)
+        {
+            points.Push(x, y);
+            p = q;
+        }
+        else
+        {
+            badLines++;
+        }
+        p = NextLine(p, end);
+    }
+    return badLines;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: ParseTextFile
+
+    Summary:  Parses a whole text file into one contiguous buffer. The
+              mapped file is cut into one partition per thread, each
+              boundary moved forward to the next line start, and the
+              partitions are parsed in parallel and then concatenated
+              in file order.
+
+    Args:     const string& path
+                file to parse
+              PointBuffer& points
+                receives the points, replacing its contents
+              const TextParseOptions& options
+                thread count
+              TextParseStats* stats
+                optional byte, point and bad line counts and throughput
+
+    Modifies: [points, stats].
+
+    Returns:  bool
+                false if the file cannot be opened or mapped
+-----------------------------------------------------------------F-F*/
+bool ParseTextFile(const string& path, PointBuffer& points, const TextParseOptions& options, TextParseStats* stats)
+{
+    const auto start = chrono::steady_clock::now();
+    if (stats)
+    {
+        *stats = TextParseStats();
+    }
+    points.Clear();
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        return false;
+    }
+    const uint64_t size = file.Size();
+    MappedView view;
+    if (size > 0)
+    {
+        view = file.MapAll();
+        if (!view.Valid())
+        {
+            return false;
+        }
+    }
+    const char* text = reinterpret_cast<const char*>(view.Data());
+
+    //partitions smaller than this are not worth a thread
+    const uint64_t minPartition = 1 << 20;
+    unsigned threadCount = options.threads ? options.threads : thread::hardware_concurrency();
+    threadCount = (unsigned)max<uint64_t>(1, min<uint64_t>(max(threadCount, 1u), size / minPartition));
+
+    vector<uint64_t> bounds(threadCount + 1);
+    for (unsigned i = 0; i <= threadCount; i++)
+    {
+        bounds[i] = LineStart(text, size, size * i / threadCount);
+    }
+
+    vector<PointBuffer> parts(threadCount);
+    vector<uint64_t> bad(threadCount, 0);
+    auto worker = [&](unsigned id)
+    {
+        PointBuffer& part = id == 0 ? points : parts[id];
+        //a short line is about 20 bytes
+        const size_t guess = (size_t)((bounds[id + 1] - bounds[id]) / 20);
+        part.x.reserve(guess);
+        part.y.reserve(guess);
+        bad[id] = ParseTextPoints(text + bounds[id], text + bounds[id + 1], part);
+    };
+
+    vector<thread> pool;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        pool.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& t : pool)
+    {
+        t.join();
+    }
+
+    size_t total = points.Size();
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        total += parts[i].Size();
+    }
+    points.x.reserve(total);
+    points.y.reserve(total);
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        points.x.insert(points.x.end(), parts[i].x.begin(), parts[i].x.end());
+        points.y.insert(points.y.end(), parts[i].y.begin(), parts[i].y.end());
+    }
+
+    if (stats)
+    {
+        stats->bytes = size;
+        stats->points = points.Size();
+        for (uint64_t b : bad)
+        {
+            stats->badLines += b;
+        }
+    }
+    Finish(stats, start);
+    return true;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: StreamTextFile
+
+    Summary:  Parses a text file a chunk at a time and hands every
+              chunk of points to consume while the next chunk is being
+              parsed on a second thread, so parsing overlaps with
+              whatever consume does (usually a hull). Only two chunks
+              of points and one mapped chunk of text are live at once.
+
+    Args:     const string& path
+                file to parse
+              const function<void(const PointSpan&)>& consume
+                called in file order with each chunk's points; the span
+                is only valid during the call
+              const TextParseOptions& options
+                chunk size
+              TextParseStats* stats
+                optional byte, point and bad line counts and throughput
+
+    Modifies: [stats].
+
+    Returns:  bool
+                false if the file cannot be opened or a chunk mapped
+-----------------------------------------------------------------F-F*/
+bool StreamTextFile(const string& path, const function<void(const PointSpan&)>& consume,
+    const TextParseOptions& options, TextParseStats* stats)
+{
+    const auto start = chrono::steady_clock::now();
+    if (stats)
+    {
+        *stats = TextParseStats();
+    }
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        return false;
+    }
+    const uint64_t size = file.Size();
+    const size_t chunkBytes = max<size_t>(options.chunkBytes, 1 << 12);
+
+    uint64_t offset = 0;
+    uint64_t points = 0;
+    uint64_t badLines = 0;
+    bool failed = false;
+
+    //parses the next run of whole lines into into; false once the file is done
+    auto parseNext = [&](PointBuffer* into) -> bool
+    {
+        into->Clear();
+        while (offset < size)
+        {
+            size_t length = (size_t)min<uint64_t>(chunkBytes, size - offset);
+            MappedView view = file.Map(offset, length);
+            if (!view.Valid())
+            {
+                failed = true;
+                return false;
+            }
+            const char* text = reinterpret_cast<const char*>(view.Data());
+
+            //stop after the last newline unless this is the tail of the file; a
+            //line longer than the chunk grows the view until it fits
+            while (offset + length < size)
+            {
+                const size_t whole = WholeLines(text, length);
+                if (whole > 0)
+                {
+                    length = whole;
+                    break;
+                }
+                length = (size_t)min<uint64_t>(size - offset, (uint64_t)length * 2);
+                view = file.Map(offset, length);
+                if (!view.Valid())
+                {
+                    failed = true;
+                    return false;
+                }
+                text = reinterpret_cast<const char*>(view.Data());
+            }
+
+            badLines += ParseTextPoints(text, text + length, *into);
+            offset += length;
+            if (into->Size() > 0)
+            {
+                return true;
+            }
+        }
+        return into->Size() > 0;
+    };
+
+    PointBuffer buffers[2];
+    int current = 0;
+    future<bool> pending = async(launch::async, parseNext, &buffers[0]);
+    while (pending.get())
+    {
+        pending = async(launch::async, parseNext, &buffers[current ^ 1]);
+        points += buffers[current].Size();
+        consume(buffers[current].Span());
+        current ^= 1;
+    }
+
+    if (stats)
+    {
+        stats->bytes = size;
+        stats->points = points;
+        stats->badLines = badLines;
+    }
+    Finish(stats, start);
+    return !failed;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    Function: TextFileHull
+
+    Summary:  Convex hull of a text file without holding all of its
+              points: each streamed chunk is hulled while the next one
+              is parsed, and only the chunk hull vertices are kept,
+              themselves hulled again whenever they pass KeptLimit, so
+              points in convex position do not pile up either.
+
+    Args:     const string& path
+                file to read
+              vector<Point2D>& hull
+                receives the hull, counter-clockwise from the left most
+                point
+              const TextParseOptions& options
+                chunk size
+              TextParseStats* stats
+                optional counts and throughput
+
+    Modifies: [hull, stats].
+
+    Returns:  bool
+                false if the file cannot be read
+-----------------------------------------------------------------F-F*/
+bool TextFileHull(const string& path, vector<Point2D>& hull, const TextParseOptions& options, TextParseStats* stats)
+{
+    vector<Point2D> kept;
+    vector<uint32_t> index;
+    const bool ok = StreamTextFile(path, [&](const PointSpan& chunk)
+    {
+        QuickHull(chunk, index);
+        for (uint32_t i : index)
+        {
+            kept.push_back(chunk[i]);
+        }
+        if (kept.size() > KeptLimit)
+        {
+            QuickHull(kept, index);
+            vector<Point2D> folded;
+            folded.reserve(index.size());
+            for (uint32_t i : index)
+            {
+                folded.push_back(kept[i]);
+            }
+            kept.swap(folded);
+        }
+    }, options, stats);
+
+    QuickHull(kept, index);
+    hull.clear();
+    for (uint32_t i : index)
+    {
+        hull.push_back(kept[i]);
+    }
+    return ok;
+}
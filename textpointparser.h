@@ -0,0 +1,47 @@
+#ifndef _TEXTPOINTPARSER_H
+#define _TEXTPOINTPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "geometry.h"
+
+/*--------------------------------------------------------------------
+    Text point input: one point per line, x then y, separated by any
+    run of spaces, tabs, commas or semicolons. Further columns are
+    ignored, lines starting with '#' and blank lines are skipped, and
+    lines that do not start with two finite numbers (a CSV header, for
+    example) are counted in badLines.
+--------------------------------------------------------------------*/
+
+struct TextParseOptions
+{
+    unsigned threads = 0;               // 0 = hardware concurrency
+    size_t   chunkBytes = 1 << 24;      // bytes mapped per streamed chunk
+};
+
+struct TextParseStats
+{
+    uint64_t bytes = 0;
+    uint64_t points = 0;
+    uint64_t badLines = 0;
+    double   seconds = 0;
+    double   bytesPerSecond = 0;
+};
+
+//parses [begin, end) on the calling thread, appending to points; returns bad line count
+uint64_t ParseTextPoints(const char* begin, const char* end, PointBuffer& points);
+
+bool ParseTextFile(const std::string& path, PointBuffer& points,
+    const TextParseOptions& options = TextParseOptions(), TextParseStats* stats = nullptr);
+
+bool StreamTextFile(const std::string& path, const std::function<void(const PointSpan&)>& consume,
+    const TextParseOptions& options = TextParseOptions(), TextParseStats* stats = nullptr);
+
+bool TextFileHull(const std::string& path, std::vector<Point2D>& hull,
+    const TextParseOptions& options = TextParseOptions(), TextParseStats* stats = nullptr);
+
+#endif